@@ -12,7 +12,6 @@
  * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
 
 #define GLEW_STATIC
-#define MAX_OBJ_BUFFER_MACRO 8192 /* if your .obj file has more than 300 triangles, this is too little to handle it!!! */
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -24,7 +23,10 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>  /* uciSend() */
 #include <string.h>  /* strcmp() */
+#include <math.h>    /* log(), LMR Table */
+#include <intrin.h>  /* _BitScanForward64(), __popcnt64() */
 #include <windows.h> /* timeGetTime() */
 
 
@@ -39,12 +41,16 @@ struct textureBuffer_s{
 
 struct objectBuffer_s {
 
-	float* mBuffer = NULL;
+	float* mBuffer = NULL; /* Unique Vertices, Position UV Normal */
 	float* vBuffer = NULL;
 	float* tBuffer = NULL;
 	float* nBuffer = NULL;
-	size_t sizeOfBuffer = MAX_OBJ_BUFFER_MACRO;
+	GLuint* iBuffer = NULL; /* Three Per Triangle Into mBuffer */
+	size_t sizeOfBuffer = 0; /* Floats In mBuffer */
+	GLuint noVertices = 0;
 	GLuint noIndices = 0; /* assume 0 if not updated */
+	GLenum indexType = GL_UNSIGNED_SHORT; /* GL_UNSIGNED_INT Only Past 65536 Vertices */
+	GLuint indexOffset = 0; /* Bytes Into VBO, Indices Follow The Vertices In The Same Buffer */
 	GLuint VBO = 0;
 	GLuint VAO = 0;
 };
@@ -95,11 +101,6 @@ struct bitmapInfoHeader_s{
 	unsigned int imageSize;
 } ;
 
-struct pngInfoHeader_s {
-
-	int width, height;
-};
-
 struct kingPiece_s {
 
 	char currentIndex;
@@ -130,8 +131,7 @@ enum chessPiece_e {
 enum errorCode_e {
 
 	COMPILE_VS, COMPILE_FS, LINK_PROGRAM,
-	FIRST_TEMP_BUFFER_ALLOCATION, SECOND_TEMP_BUFFER_ALLOCATION, THIRD_TEMP_BUFFER_ALLOCATION, MAIN_BUFFER_ALLOCATION,
-	BEFORE_REALLOCATION, DURING_REALLOCATION
+	OBJ_BUFFER_ALLOCATION, OBJ_FACE_INDEX
 };
 
 
@@ -193,202 +193,668 @@ bool bValidPromotion = false;
 bool bHandleEnPassant = false;
 int iCanEnPassant = 0;
 int iEnPassantLetter = 0;
+int iHalfmoveClock = 0; /* Only Kept For FEN Export */
+int iFullmoveNumber = 1;
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Memory Mapped Files                                                                                             *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+struct mappedFile_s { /* Read Only View Of A Whole File, Not Null Terminated */
+
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = NULL;
+	const char* data = NULL;
+	size_t size = 0;
+};
+
+
+int mapFile(const char* filepath, mappedFile_s* mf) { /* Returns 1 For Error, An Empty File Maps To data = NULL, size = 0 */
+
+	LARGE_INTEGER size;
+
+
+	mf->file = CreateFileA(filepath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (mf->file == INVALID_HANDLE_VALUE) { return 1; }
+
+	if (!GetFileSizeEx(mf->file, &size)) { CloseHandle(mf->file); mf->file = INVALID_HANDLE_VALUE; return 1; }
+	mf->size = (size_t)size.QuadPart;
+	if (mf->size == 0) { return 0; } /* CreateFileMapping Refuses Empty Files */
+
+	mf->mapping = CreateFileMappingA(mf->file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mf->mapping == NULL) { CloseHandle(mf->file); mf->file = INVALID_HANDLE_VALUE; return 1; }
+
+	mf->data = (const char*)MapViewOfFile(mf->mapping, FILE_MAP_READ, 0, 0, 0);
+	if (mf->data == NULL) { CloseHandle(mf->mapping); CloseHandle(mf->file); mf->mapping = NULL; mf->file = INVALID_HANDLE_VALUE; return 1; }
+
+	return 0;
+}
+
+void unmapFile(mappedFile_s* mf) {
+
+	if (mf->data != NULL) { UnmapViewOfFile(mf->data); }
+	if (mf->mapping != NULL) { CloseHandle(mf->mapping); }
+	if (mf->file != INVALID_HANDLE_VALUE) { CloseHandle(mf->file); }
+	mf->data = NULL; mf->mapping = NULL; mf->file = INVALID_HANDLE_VALUE; mf->size = 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Cooked Assets                                                                                                   *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+struct assetStamp_s { /* Identifies The Source A Cooked File Was Made From */
+
+	unsigned long long time;      /* Last Write, In FILETIME Ticks */
+	unsigned long long size;
+	unsigned long long hash;      /* hashBytes() Of The Whole Source, Only Read Again When time Or size Disagree */
+};
+
+struct cookedAsset_s { /* A Cooked Header And Payload, Mapped From The Cache Or Cooked Into Memory, Needs No GL So Any Thread Can Fill It */
+
+	mappedFile_s mf;
+	const void* header = NULL;
+	const unsigned char* payload = NULL;
+	void* cookedHeader = NULL;    /* malloc()ed When Nothing Was Mapped */
+	unsigned char* cookedPayload = NULL;
+};
+
+
+unsigned long long hashBytes(const void* data, size_t size, unsigned long long hash) { /* FNV-1a, Pass 14695981039346656037 To Start Or A Previous Hash To Chain */
+
+	const unsigned char* p = (const unsigned char*)data;
+
+
+	for (size_t i = 0; i < size; i++) { hash = (hash ^ p[i]) * 1099511628211ull; }
+	return hash;
+}
+
+int statAsset(const char* filepath, assetStamp_s* stamp) { /* Fills time And size Without Opening The File, Returns 1 For Error */
+
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+
+	if (!GetFileAttributesExA(filepath, GetFileExInfoStandard, &attributes)) { return 1; }
+	stamp->time = ((unsigned long long)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+	stamp->size = ((unsigned long long)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	return 0;
+}
+
+int stampAsset(const char* filepath, assetStamp_s* stamp) { /* statAsset() Plus The Content Hash, Returns 1 For Error */
+
+	mappedFile_s mf;
+
+
+	if (statAsset(filepath, stamp) || mapFile(filepath, &mf)) { return 1; }
+	stamp->hash = hashBytes(mf.data, mf.size, 14695981039346656037ull);
+	unmapFile(&mf);
+	return 0;
+}
+
+bool isCookedFresh(const char* filepath, const assetStamp_s* cooked) { /* A Touched But Unchanged Source Still Matches By Hash */
+
+	assetStamp_s stamp;
+
+
+	if (statAsset(filepath, &stamp)) { return false; }
+	if (stamp.time == cooked->time && stamp.size == cooked->size) { return true; }
+	if (stamp.size != cooked->size || stampAsset(filepath, &stamp)) { return false; }
+	return stamp.hash == cooked->hash;
+}
+
+void cookedPath(const char* filepath, const char* extension, char* out) { /* Same Directory And Name, extension Instead Of The Source's, out Needs MAX_PATH */
+
+	const char* dot = strrchr(filepath, '.');
+	const char* slash = strrchr(filepath, '/');
+	size_t length = (dot != NULL && (slash == NULL || dot > slash)) ? (size_t)(dot - filepath) : strlen(filepath);
+
+
+	if (length + strlen(extension) >= MAX_PATH) { length = MAX_PATH - 1 - strlen(extension); }
+	memcpy(out, filepath, length);
+	strcpy(out + length, extension);
+}
+
+int writeCookedFile(const char* filepath, const void* header, size_t headerSize, const void* payload, size_t payloadSize) { /* Returns 1 For Error, A Partial File Is Removed */
+
+	FILE* file;
+
+
+	if (fopen_s(&file, filepath, "wb") != 0) { return 1; }
+	bool bOk = fwrite(header, 1, headerSize, file) == headerSize && fwrite(payload, 1, payloadSize, file) == payloadSize;
+	if (fclose(file) != 0) { bOk = false; }
+	if (!bOk) { remove(filepath); }
+	return bOk ? 0 : 1;
+}
+
+void releaseCookedAsset(cookedAsset_s* asset) {
+
+	unmapFile(&asset->mf);
+	free(asset->cookedHeader); asset->cookedHeader = NULL;
+	free(asset->cookedPayload); asset->cookedPayload = NULL;
+	asset->header = NULL; asset->payload = NULL;
+}
 
 
  /* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
   *                                                                                                                            *
-  *           SLOW OBJ 0.1a                                                                                                    *
+  *           FAST OBJ 0.2a                                                                                                    *
   *	                                                                                                                           *
   * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
 
-#define LINE_BUFFER_MACRO 64 /* jono, I have no idea what the max strlen in .obj is, but this seems to be enough */
+#define OBJ_FLOATS_PER_VERTEX 8 /* Position, UV, Normal, The Layout InitObject() Hands To The Shaders */
+#define OBJ_MISSING_INDEX 0xFFFFFFFF /* No UV Or Normal In The Face, Reads As Zeros */
+#define VERTEX_CACHE_MACRO 32 /* Post Transform Cache Size Triangles Are Ordered For, Anything Past Real Hardware's Does No Harm */
 
+struct objVertexKey_s { /* One Face Corner, Equal Keys Share A Vertex */
 
-void objectLoaderError(objectBuffer_s* obo, errorCode_e errorCode) {
+	unsigned int v;
+	unsigned int t;
+	unsigned int n;
+};
+
+struct objVertexMap_s { /* Open Addressing, Slots Hold Vertex + 1 So 0 Is Empty */
+
+	GLuint* slots;
+	size_t capacity;
+	objVertexKey_s* keys; /* Per Unique Vertex, For Comparing And Rehashing */
+	size_t keyCapacity;
+};
+
+
+void objectLoaderError(objectBuffer_s* obo, errorCode_e errorCode) { /* Frees Whatever Was Allocated, The Caller Exits */
+
+	free(obo->vBuffer); obo->vBuffer = NULL; free(obo->tBuffer); obo->tBuffer = NULL;
+	free(obo->nBuffer); obo->nBuffer = NULL; free(obo->mBuffer); obo->mBuffer = NULL;
+	free(obo->iBuffer); obo->iBuffer = NULL;
 
 	switch ( errorCode ) {
-	case( FIRST_TEMP_BUFFER_ALLOCATION ):
-		fputs("Memory error", stderr);
-		break;
-	case( SECOND_TEMP_BUFFER_ALLOCATION ):
-		free(obo->vBuffer); obo->vBuffer = NULL;
-		fputs("Memory error", stderr);
-		break;
-	case( THIRD_TEMP_BUFFER_ALLOCATION ):
-		free(obo->vBuffer); obo->vBuffer = NULL; free(obo->tBuffer); obo->tBuffer = NULL;
-		fputs("Memory error", stderr);
-		break;
-	case( MAIN_BUFFER_ALLOCATION ):
-		free(obo->vBuffer); obo->vBuffer = NULL; free(obo->tBuffer); obo->tBuffer = NULL;
-		free(obo->nBuffer); obo->nBuffer = NULL;
+	case( OBJ_BUFFER_ALLOCATION ):
 		fputs("Memory error", stderr);
 		break;
-	case( BEFORE_REALLOCATION ):
-		free(obo->vBuffer); obo->vBuffer = NULL; free(obo->tBuffer); obo->tBuffer = NULL;
-		free(obo->nBuffer); obo->nBuffer = NULL; free(obo->mBuffer); obo->mBuffer = NULL;
-		fputs("Memory error, Possibly Too Many Triangles In .obj", stderr);
-		break;
-	case( DURING_REALLOCATION ):
-		free(obo->mBuffer); obo->mBuffer = NULL;
-		fputs("Memory error", stderr);
+	case( OBJ_FACE_INDEX ):
+		fputs("File error, Face Points Past The Vertices In .obj", stderr);
 		break;
 	}
 }
 
-int parseOBJ(FILE* FHDL, objectBuffer_s* obo) {
+void reserveOBJBuffer(objectBuffer_s* obo, void** buffer, size_t* capacity, size_t needed, size_t elementSize) { /* Doubles, So Any Mesh Size Costs A Handful Of Reallocations */
+
+	if (needed <= *capacity) { return; }
+
+	size_t grown = *capacity ? *capacity : 1024;
+	while (grown < needed) { grown *= 2; }
+	void* safetypointer = realloc(*buffer, grown * elementSize);
+	if (safetypointer == NULL) { objectLoaderError(obo, OBJ_BUFFER_ALLOCATION); exit(2); }
+	*buffer = safetypointer;
+	*capacity = grown;
+}
+
+const char* parseOBJFloat(const char* p, const char* end, float* value) { /* Plain Decimal With Optional Exponent, What Exporters Write, Much Faster Than strtof() */
 
-	char str[LINE_BUFFER_MACRO];
+	static const double negativePowers[] = { 1e0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9, 1e-10, 1e-11, 1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18 };
+	double result = 0.0;
+	unsigned long long mantissa = 0;
+	int digits = 0;   /* Significant Ones In mantissa, 18 Always Fit */
+	int scale = 0;    /* Power Of Ten mantissa Is Off By */
+	bool bNegative = false;
 
-	unsigned int cursorv = 0;
-	unsigned int cursort = 0;
-	unsigned int cursorn = 0;
-	unsigned int c = 0;
 
-	char id[4]; id[3] = '\0';
-	float vx, vy, vz;
-	float tx, ty;
-	float nx, ny, nz;
-	char* end;
-	unsigned int fv0, ft0, fn0, fv1, ft1, fn1, fv2, ft2, fn2;
+	while (p < end && (*p == ' ' || *p == '\t')) { p++; }
+	if (p < end && (*p == '-' || *p == '+')) { bNegative = *p == '-'; p++; }
 
+	/* Digits Past Float Precision Are Dropped, Integer Ones Still Count Toward The Magnitude */
+	while (p < end && *p >= '0' && *p <= '9') {
+		if (digits < 18) { mantissa = mantissa * 10 + (*p - '0'); if (mantissa) { digits++; } }
+		else { scale++; }
+		p++;
+	}
+	if (p < end && *p == '.') {
+		p++;
+		while (p < end && *p >= '0' && *p <= '9') {
+			if (digits < 18) { mantissa = mantissa * 10 + (*p - '0'); if (mantissa) { digits++; } scale--; }
+			p++;
+		}
+	}
 
-	/* Get Next Line Until EOF */
-	while (fgets(str, LINE_BUFFER_MACRO, FHDL) != NULL) {
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		int exponent = 0;
+		bool bNegativeExponent = false;
+		p++;
+		if (p < end && (*p == '-' || *p == '+')) { bNegativeExponent = *p == '-'; p++; }
+		while (p < end && *p >= '0' && *p <= '9') { if (exponent < 1000) { exponent = exponent * 10 + (*p - '0'); } p++; }
+		scale += bNegativeExponent ? -exponent : exponent;
+	}
+	result = (double)mantissa * (scale <= 0 && scale >= -18 ? negativePowers[-scale] : pow(10.0, scale));
 
-		/* Get Line ID */
-		sscanf_s(str, "%s", &id, 4);
+	*value = (float)(bNegative ? -result : result);
+	return p;
+}
 
-		if (!strcmp(id, "v")) {
-			str[0] = ' ';
-			vx = strtof(str, &end); obo->vBuffer[cursorv] = vx; cursorv++;
-			vy = strtof(end, &end); obo->vBuffer[cursorv] = vy; cursorv++;
-			vz = strtof(end, NULL); obo->vBuffer[cursorv] = vz; cursorv++;
+const char* parseOBJIndex(const char* p, const char* end, long* index) { /* 1 Based, Negative Counts Back From The Latest, 0 When Missing */
 
-		} else if (!strcmp(id, "vt")) {
-			str[0] = ' '; str[1] = ' ';
-			tx = strtof(str, &end); obo->tBuffer[cursort] = tx; cursort++;
-			ty = strtof(end, NULL); obo->tBuffer[cursort] = ty; cursort++;
+	bool bNegative = false;
 
-		} else if (!strcmp(id, "vn")) {
-			str[0] = ' '; str[1] = ' ';
-			nx = strtof(str, &end); obo->nBuffer[cursorn] = nx; cursorn++;
-			ny = strtof(end, &end); obo->nBuffer[cursorn] = ny; cursorn++;
-			nz = strtof(end, NULL); obo->nBuffer[cursorn] = nz; cursorn++;
 
-		} else if (!strcmp(id, "f")) {
-			str[0] = ' ';
-			sscanf_s(str, "%u/%u/%u %u/%u/%u %u/%u/%u", &fv0, &ft0, &fn0, &fv1, &ft1, &fn1, &fv2, &ft2, &fn2);
+	*index = 0;
+	if (p < end && *p == '-') { bNegative = true; p++; }
+	while (p < end && *p >= '0' && *p <= '9') { *index = *index * 10 + (*p - '0'); p++; }
+	if (bNegative) { *index = -*index; }
+	return p;
+}
 
-			/* Convert Line# to Index# */
-			fv0 -= 1; ft0 -= 1; fn0 -= 1; fv1 -= 1; ft1 -= 1; fn1 -= 1; fv2 -= 1; ft2 -= 1; fn2 -= 1;
-			fv0 *= 3; ft0 *= 2; fn0 *= 3; fv1 *= 3; ft1 *= 2; fn1 *= 3; fv2 *= 3; ft2 *= 2; fn2 *= 3;
+unsigned int resolveOBJIndex(long index, size_t count) { /* Into A 0 Based Element Number, OBJ_MISSING_INDEX If It Points Outside */
 
-			/* Format Main Buffer */
-			obo->mBuffer[c] = obo->vBuffer[fv0]; c++; fv0++;
-			obo->mBuffer[c] = obo->vBuffer[fv0]; c++; fv0++;
-			obo->mBuffer[c] = obo->vBuffer[fv0]; c++;
-			obo->mBuffer[c] = obo->tBuffer[ft0]; c++; ft0++;
-			obo->mBuffer[c] = obo->tBuffer[ft0]; c++;
-			obo->mBuffer[c] = obo->nBuffer[fn0]; c++; fn0++;
-			obo->mBuffer[c] = obo->nBuffer[fn0]; c++; fn0++;
-			obo->mBuffer[c] = obo->nBuffer[fn0]; c++;
+	if (index > 0 && (size_t)index <= count) { return (unsigned int)(index - 1); }
+	if (index < 0 && (size_t)-index <= count) { return (unsigned int)(count + index); }
+	return OBJ_MISSING_INDEX;
+}
 
-			obo->mBuffer[c] = obo->vBuffer[fv1]; c++; fv1++;
-			obo->mBuffer[c] = obo->vBuffer[fv1]; c++; fv1++;
-			obo->mBuffer[c] = obo->vBuffer[fv1]; c++;
-			obo->mBuffer[c] = obo->tBuffer[ft1]; c++; ft1++;
-			obo->mBuffer[c] = obo->tBuffer[ft1]; c++;
-			obo->mBuffer[c] = obo->nBuffer[fn1]; c++; fn1++;
-			obo->mBuffer[c] = obo->nBuffer[fn1]; c++; fn1++;
-			obo->mBuffer[c] = obo->nBuffer[fn1]; c++;
+inline size_t hashOBJVertex(const objVertexKey_s* key) {
 
-			obo->mBuffer[c] = obo->vBuffer[fv2]; c++; fv2++;
-			obo->mBuffer[c] = obo->vBuffer[fv2]; c++; fv2++;
-			obo->mBuffer[c] = obo->vBuffer[fv2]; c++;
-			obo->mBuffer[c] = obo->tBuffer[ft2]; c++; ft2++;
-			obo->mBuffer[c] = obo->tBuffer[ft2]; c++;
-			obo->mBuffer[c] = obo->nBuffer[fn2]; c++; fn2++;
-			obo->mBuffer[c] = obo->nBuffer[fn2]; c++; fn2++;
-			obo->mBuffer[c] = obo->nBuffer[fn2]; c++;
+	unsigned long long h = key->v * 0x9E3779B97F4A7C15ull ^ key->t * 0xC2B2AE3D27D4EB4Full ^ key->n * 0x165667B19E3779F9ull;
+	return (size_t)(h ^ (h >> 29));
+}
 
-			/* Keep Track of How Many Indices To Draw */
-			obo->noIndices += 3;
+GLuint findOBJVertex(objectBuffer_s* obo, objVertexMap_s* map, const objVertexKey_s* key, size_t* capacitym) { /* The Corner's Vertex, Added To mBuffer The First Time It Shows Up */
+
+	/* Rehash At Half Full, Probe Chains Stay Short */
+	if ((size_t)(obo->noVertices + 1) * 2 > map->capacity) {
+		size_t capacity = map->capacity ? map->capacity * 2 : 4096;
+		GLuint* slots = (GLuint*)calloc(capacity, sizeof(GLuint));
+		if (slots == NULL) { objectLoaderError(obo, OBJ_BUFFER_ALLOCATION); exit(2); }
+		for (GLuint i = 0; i < obo->noVertices; i++) {
+			size_t slot = hashOBJVertex(&map->keys[i]) & (capacity - 1);
+			while (slots[slot] != 0) { slot = (slot + 1) & (capacity - 1); }
+			slots[slot] = i + 1;
 		}
+		free(map->slots);
+		map->slots = slots;
+		map->capacity = capacity;
 	}
 
+	size_t slot = hashOBJVertex(key) & (map->capacity - 1);
+	while (map->slots[slot] != 0) {
+		const objVertexKey_s* other = &map->keys[map->slots[slot] - 1];
+		if (other->v == key->v && other->t == key->t && other->n == key->n) { return map->slots[slot] - 1; }
+		slot = (slot + 1) & (map->capacity - 1);
+	}
 
-	return c;
+	/* New Vertex, Format Main Buffer */
+	GLuint vertex = obo->noVertices++;
+	reserveOBJBuffer(obo, (void**)&map->keys, &map->keyCapacity, vertex + 1, sizeof(objVertexKey_s));
+	reserveOBJBuffer(obo, (void**)&obo->mBuffer, capacitym, (size_t)(vertex + 1) * OBJ_FLOATS_PER_VERTEX, sizeof(float));
+	map->keys[vertex] = *key;
+	map->slots[slot] = vertex + 1;
+
+	float* out = obo->mBuffer + (size_t)vertex * OBJ_FLOATS_PER_VERTEX;
+	out[0] = obo->vBuffer[key->v * 3]; out[1] = obo->vBuffer[key->v * 3 + 1]; out[2] = obo->vBuffer[key->v * 3 + 2];
+	if (key->t != OBJ_MISSING_INDEX) { out[3] = obo->tBuffer[key->t * 2]; out[4] = obo->tBuffer[key->t * 2 + 1]; }
+	else { out[3] = 0.0f; out[4] = 0.0f; }
+	if (key->n != OBJ_MISSING_INDEX) { out[5] = obo->nBuffer[key->n * 3]; out[6] = obo->nBuffer[key->n * 3 + 1]; out[7] = obo->nBuffer[key->n * 3 + 2]; }
+	else { out[5] = 0.0f; out[6] = 0.0f; out[7] = 0.0f; }
+	return vertex;
 }
 
-void readOBJ(const char* filepath, objectBuffer_s* obo) {
+int parseOBJ(const char* data, size_t size, objectBuffer_s* obo) { /* One Pass Over The Whole File, Returns 1 For A Face That Does Not Resolve */
+
+	const char* p = data;
+	const char* end = data + size;
+	objVertexMap_s map = { NULL, 0, NULL, 0 };
+	size_t capacityv = 0, capacityt = 0, capacityn = 0, capacitym = 0, capacityi = 0;
+	size_t cursorv = 0, cursort = 0, cursorn = 0;
+	GLuint corner[3]; /* First, Previous And Current Corner, Faces Are Fanned Into Triangles */
+
+
+	while (p < end) {
+		const char* lineEnd = (const char*)memchr(p, '\n', end - p);
+		if (lineEnd == NULL) { lineEnd = end; }
+
+		/* Line ID, Anything That Is Not Geometry (#, o, g, s, mtllib, usemtl) Is Skipped */
+		if (p + 1 < lineEnd && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+			reserveOBJBuffer(obo, (void**)&obo->vBuffer, &capacityv, cursorv + 3, sizeof(float));
+			p = parseOBJFloat(p + 1, lineEnd, &obo->vBuffer[cursorv++]);
+			p = parseOBJFloat(p, lineEnd, &obo->vBuffer[cursorv++]);
+			parseOBJFloat(p, lineEnd, &obo->vBuffer[cursorv++]);
+
+		} else if (p + 2 < lineEnd && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t')) {
+			reserveOBJBuffer(obo, (void**)&obo->tBuffer, &capacityt, cursort + 2, sizeof(float));
+			p = parseOBJFloat(p + 2, lineEnd, &obo->tBuffer[cursort++]);
+			parseOBJFloat(p, lineEnd, &obo->tBuffer[cursort++]);
+
+		} else if (p + 2 < lineEnd && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t')) {
+			reserveOBJBuffer(obo, (void**)&obo->nBuffer, &capacityn, cursorn + 3, sizeof(float));
+			p = parseOBJFloat(p + 2, lineEnd, &obo->nBuffer[cursorn++]);
+			p = parseOBJFloat(p, lineEnd, &obo->nBuffer[cursorn++]);
+			parseOBJFloat(p, lineEnd, &obo->nBuffer[cursorn++]);
+
+		} else if (p + 1 < lineEnd && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+			int corners = 0;
+			p++;
+
+			/* v, v/t, v//n Or v/t/n, Any Number Of Corners */
+			while (true) {
+				long iv, it = 0, in = 0;
+				objVertexKey_s key;
+				while (p < lineEnd && (*p == ' ' || *p == '\t' || *p == '\r')) { p++; }
+				if (p == lineEnd) { break; }
+
+				p = parseOBJIndex(p, lineEnd, &iv);
+				if (p < lineEnd && *p == '/') { p = parseOBJIndex(p + 1, lineEnd, &it); }
+				if (p < lineEnd && *p == '/') { p = parseOBJIndex(p + 1, lineEnd, &in); }
+				key.v = resolveOBJIndex(iv, cursorv / 3);
+				key.t = resolveOBJIndex(it, cursort / 2);
+				key.n = resolveOBJIndex(in, cursorn / 3);
+				if (key.v == OBJ_MISSING_INDEX) { free(map.slots); free(map.keys); objectLoaderError(obo, OBJ_FACE_INDEX); return 1; }
+
+				corner[corners < 2 ? corners : 2] = findOBJVertex(obo, &map, &key, &capacitym);
+
+				/* One Triangle Per Corner From The Third On */
+				if (++corners >= 3) {
+					reserveOBJBuffer(obo, (void**)&obo->iBuffer, &capacityi, (size_t)obo->noIndices + 3, sizeof(GLuint));
+					memcpy(obo->iBuffer + obo->noIndices, corner, sizeof(corner));
+					corner[1] = corner[2];
+
+					/* Keep Track of How Many Indices To Draw */
+					obo->noIndices += 3;
+				}
+				while (p < lineEnd && *p != ' ' && *p != '\t' && *p != '\r') { p++; } /* Past Anything Else In The Token */
+			}
+		}
 
-	FILE* FHDL;
-	
+		p = lineEnd + 1;
+	}
 
-	fopen_s(&FHDL, filepath, "r");
-	if (FHDL == NULL) { fputs("File error", stderr); exit(1); }
+	free(map.slots);
+	free(map.keys);
+	obo->sizeOfBuffer = (size_t)obo->noVertices * OBJ_FLOATS_PER_VERTEX;
+	return 0;
+}
 
-	obo->sizeOfBuffer = parseOBJ(FHDL, obo);
+float vertexCacheScore(int cachePosition, int remaining) { /* Tom Forsyth's Linear-Speed Vertex Cache Optimisation */
 
-	fclose(FHDL);
+	float score = 0.0f;
+
+
+	if (remaining == 0) { return -1.0f; } /* Nothing Left To Draw With It */
+	if (cachePosition >= 0) {
+		if (cachePosition < 3) { score = 0.75f; } /* Just Used, Same Score Whatever The Order Of The Last Triangle */
+		else { score = powf(1.0f - (float)(cachePosition - 3) / (VERTEX_CACHE_MACRO - 3), 1.5f); }
+	}
+	return score + 2.0f / sqrtf((float)remaining); /* Finish Off Vertices With Few Triangles Left So They Leave The Cache */
 }
 
-void loadOBJ(const char* filepath, objectBuffer_s* obo) {
+void optimizeVertexCache(objectBuffer_s* obo) { /* Reorders Triangles For The Post Transform Cache, Then Vertices Into First Use Order For Fetch Locality */
+
+	GLuint triangleCount = obo->noIndices / 3;
+	GLuint vertexCount = obo->noVertices;
+	int cache[VERTEX_CACHE_MACRO + 3];
+	int cacheSize = 0;
+
+
+	if (triangleCount == 0) { return; }
+
+	int* remaining = (int*)calloc(vertexCount, sizeof(int));
+	int* cachePosition = (int*)malloc(vertexCount * sizeof(int));
+	float* vertexScore = (float*)malloc(vertexCount * sizeof(float));
+	GLuint* adjacencyStart = (GLuint*)calloc((size_t)vertexCount + 1, sizeof(GLuint));
+	GLuint* adjacency = (GLuint*)malloc(obo->noIndices * sizeof(GLuint));
+	float* triangleScore = (float*)malloc(triangleCount * sizeof(float));
+	bool* bEmitted = (bool*)calloc(triangleCount, sizeof(bool));
+	GLuint* ordered = (GLuint*)malloc(obo->noIndices * sizeof(GLuint));
+	if (!remaining || !cachePosition || !vertexScore || !adjacencyStart || !adjacency || !triangleScore || !bEmitted || !ordered) { objectLoaderError(obo, OBJ_BUFFER_ALLOCATION); exit(2); }
+
+	/* Triangles Per Vertex, Packed One Vertex After The Other */
+	for (GLuint i = 0; i < obo->noIndices; i++) { remaining[obo->iBuffer[i]]++; }
+	for (GLuint v = 0; v < vertexCount; v++) { adjacencyStart[v + 1] = adjacencyStart[v] + remaining[v]; remaining[v] = 0; }
+	for (GLuint i = 0; i < obo->noIndices; i++) { GLuint v = obo->iBuffer[i]; adjacency[adjacencyStart[v] + remaining[v]++] = i / 3; }
+
+	for (GLuint v = 0; v < vertexCount; v++) { cachePosition[v] = -1; vertexScore[v] = vertexCacheScore(-1, remaining[v]); }
+	for (GLuint t = 0; t < triangleCount; t++) {
+		triangleScore[t] = vertexScore[obo->iBuffer[t * 3]] + vertexScore[obo->iBuffer[t * 3 + 1]] + vertexScore[obo->iBuffer[t * 3 + 2]];
+	}
+
+	GLuint scan = 0;
+	long best = -1;
+	for (GLuint emitted = 0; emitted < triangleCount; emitted++) {
+
+		/* Nothing In The Cache Touches A Triangle That Is Left, Start Again From The Next One In File Order */
+		if (best < 0) {
+			while (bEmitted[scan]) { scan++; }
+			best = scan;
+		}
+
+		const GLuint* tri = obo->iBuffer + best * 3;
+		memcpy(ordered + emitted * 3, tri, 3 * sizeof(GLuint));
+		bEmitted[best] = true;
+
+		/* Drop The Triangle From Its Vertices' Lists, Keeps Scoring To The Ones Still Left */
+		for (int k = 0; k < 3; k++) {
+			GLuint v = tri[k];
+			GLuint* list = adjacency + adjacencyStart[v];
+			for (int j = 0; j < remaining[v]; j++) { if (list[j] == (GLuint)best) { list[j] = list[remaining[v] - 1]; break; } }
+			remaining[v]--;
+		}
+
+		/* Its Vertices Move To The Front Of The Cache, The Rest Shift Down */
+		int next[VERTEX_CACHE_MACRO + 3];
+		int nextSize = 0;
+		for (int k = 0; k < 3; k++) { next[nextSize++] = (int)tri[k]; }
+		for (int i = 0; i < cacheSize; i++) {
+			if (cache[i] != next[0] && cache[i] != next[1] && cache[i] != next[2] && nextSize < VERTEX_CACHE_MACRO + 3) { next[nextSize++] = cache[i]; }
+		}
+		for (int i = VERTEX_CACHE_MACRO; i < nextSize; i++) { cachePosition[next[i]] = -1; vertexScore[next[i]] = vertexCacheScore(-1, remaining[next[i]]); }
+		memcpy(cache, next, sizeof(int) * nextSize);
+		cacheSize = nextSize < VERTEX_CACHE_MACRO ? nextSize : VERTEX_CACHE_MACRO;
+
+		/* Rescore What Changed And Pick The Best Triangle Touching The Cache */
+		for (int i = 0; i < cacheSize; i++) { cachePosition[cache[i]] = i; vertexScore[cache[i]] = vertexCacheScore(i, remaining[cache[i]]); }
+		float bestScore = -1.0f;
+		best = -1;
+		for (int i = 0; i < nextSize; i++) {
+			const GLuint* list = adjacency + adjacencyStart[cache[i]];
+			for (int j = 0; j < remaining[cache[i]]; j++) {
+				const GLuint* other = obo->iBuffer + list[j] * 3;
+				triangleScore[list[j]] = vertexScore[other[0]] + vertexScore[other[1]] + vertexScore[other[2]];
+				if (triangleScore[list[j]] > bestScore) { bestScore = triangleScore[list[j]]; best = list[j]; }
+			}
+		}
+	}
 
-	float* safetypointer = NULL;
+	/* Vertices In The Order The New Index Buffer First Touches Them */
+	GLuint* remap = (GLuint*)adjacencyStart; /* vertexCount + 1 Entries, No Longer Needed */
+	float* reordered = (float*)malloc(obo->sizeOfBuffer * sizeof(float));
+	if (reordered == NULL) { objectLoaderError(obo, OBJ_BUFFER_ALLOCATION); exit(2); }
+	for (GLuint v = 0; v < vertexCount; v++) { remap[v] = OBJ_MISSING_INDEX; }
+	GLuint nextVertex = 0;
+	for (GLuint i = 0; i < obo->noIndices; i++) {
+		GLuint v = ordered[i];
+		if (remap[v] == OBJ_MISSING_INDEX) {
+			remap[v] = nextVertex;
+			memcpy(reordered + (size_t)nextVertex * OBJ_FLOATS_PER_VERTEX, obo->mBuffer + (size_t)v * OBJ_FLOATS_PER_VERTEX, OBJ_FLOATS_PER_VERTEX * sizeof(float));
+			nextVertex++;
+		}
+		obo->iBuffer[i] = remap[v];
+	}
+
+	free(obo->mBuffer); obo->mBuffer = reordered;
+	free(remaining); free(cachePosition); free(vertexScore); free(adjacencyStart); free(adjacency);
+	free(triangleScore); free(bEmitted); free(ordered);
+}
 
+void readOBJ(const char* filepath, objectBuffer_s* obo) {
 
-	/* Allocate Buffers */
-	obo->vBuffer = (float*)malloc(obo->sizeOfBuffer * sizeof(float));
-	if (obo->vBuffer == NULL) { objectLoaderError(obo,  FIRST_TEMP_BUFFER_ALLOCATION);  exit(2); }
+	mappedFile_s mf;
 
-	obo->tBuffer = (float*)malloc(obo->sizeOfBuffer * sizeof(float));
-	if (obo->tBuffer == NULL) { objectLoaderError(obo,  SECOND_TEMP_BUFFER_ALLOCATION); exit(2); }
 
-	obo->nBuffer = (float*)malloc(obo->sizeOfBuffer * sizeof(float));
-	if (obo->nBuffer == NULL) { objectLoaderError(obo,  THIRD_TEMP_BUFFER_ALLOCATION);  exit(2); }
+	if (mapFile(filepath, &mf)) { fputs("File error", stderr); exit(1); }
+	int result = parseOBJ(mf.data, mf.size, obo);
+	unmapFile(&mf);
+	if (result) { exit(1); }
+}
 
-	obo->mBuffer = (float*)malloc(obo->sizeOfBuffer * sizeof(float));
-	if (obo->mBuffer == NULL) { objectLoaderError(obo,  MAIN_BUFFER_ALLOCATION);        exit(2); }
+void loadOBJ(const char* filepath, objectBuffer_s* obo) {
 
-	/* Populate Buffers */
+	/* Populate Buffers, They Grow As The File Needs */
 	readOBJ(filepath, obo);
-	if (obo->sizeOfBuffer > MAX_OBJ_BUFFER_MACRO) { objectLoaderError(obo,  BEFORE_REALLOCATION); exit(2); }
 
 	/* Free Temp Buffers */
 	free(obo->vBuffer); obo->vBuffer = NULL;
 	free(obo->tBuffer); obo->tBuffer = NULL;
 	free(obo->nBuffer); obo->nBuffer = NULL;
-	
-	/* Resize Main Buffer */
-	safetypointer = (float*)realloc(obo->mBuffer, ((obo->sizeOfBuffer) * sizeof(float)));
-	if (safetypointer == NULL) { objectLoaderError(obo,  DURING_REALLOCATION); exit(2); }
-	obo->mBuffer = safetypointer;
+
+	optimizeVertexCache(obo);
 }
 
-void InitObject(const char* filepath, objectBuffer_s* obo) {
+#define MESH_MAGIC_MACRO 0x534D434A /* "JCMS" */
+#define MESH_VERSION_MACRO 1
+#define MESH_MAX_ATTRIBUTES_MACRO 4
+
+struct meshAttribute_s {
+
+	unsigned int location;
+	unsigned int components;  /* Floats */
+	unsigned int offset;      /* Bytes Into The Vertex */
+};
+
+struct meshHeader_s { /* Followed By The Payload, Vertices Then Indices, Uploaded As One Buffer */
+
+	unsigned int magic;
+	unsigned int version;
+	assetStamp_s source;
+	unsigned int vertexCount;
+	unsigned int vertexStride;  /* Bytes */
+	unsigned int indexCount;
+	unsigned int indexType;     /* GL_UNSIGNED_SHORT Or GL_UNSIGNED_INT */
+	unsigned int indexOffset;   /* Bytes Into The Payload */
+	unsigned int attributeCount;
+	meshAttribute_s attributes[MESH_MAX_ATTRIBUTES_MACRO];
+	unsigned long long payloadSize;
+};
+
+
+void cookMesh(const char* filepath, meshHeader_s* header, unsigned char** payload) { /* Parses The .obj Into The Cooked Layout, payload Is malloc()ed */
+
+	objectBuffer_s obo = {};
+	size_t vertexBytes;
+	size_t indexSize;
+
+
+	if (stampAsset(filepath, &header->source)) { fputs("File error", stderr); exit(1); }
+	loadOBJ(filepath, &obo);
+
+	header->magic = MESH_MAGIC_MACRO;
+	header->version = MESH_VERSION_MACRO;
+	header->vertexCount = obo.noVertices;
+	header->vertexStride = OBJ_FLOATS_PER_VERTEX * sizeof(float);
+	header->indexCount = obo.noIndices;
+	header->indexType = obo.noVertices <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT; /* 16 Bit Indices Whenever They Fit, Halves The Index Data */
+	header->attributeCount = 3;
+	header->attributes[0] = { 0, 3, 0 };                 /* Position */
+	header->attributes[1] = { 1, 2, 3 * sizeof(float) }; /* UV */
+	header->attributes[2] = { 2, 3, 5 * sizeof(float) }; /* Normal */
+	header->attributes[3] = { 0, 0, 0 };
+
+	vertexBytes = (size_t)obo.noVertices * header->vertexStride;
+	indexSize = header->indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+	header->indexOffset = (unsigned int)vertexBytes;
+	header->payloadSize = vertexBytes + indexSize * obo.noIndices;
+
+	*payload = (unsigned char*)malloc((size_t)header->payloadSize + 1);
+	if (*payload == NULL) { objectLoaderError(&obo, OBJ_BUFFER_ALLOCATION); exit(2); }
+	memcpy(*payload, obo.mBuffer, vertexBytes);
+	if (header->indexType == GL_UNSIGNED_SHORT) {
+		GLushort* indices = (GLushort*)(*payload + vertexBytes);
+		for (GLuint i = 0; i < obo.noIndices; i++) { indices[i] = (GLushort)obo.iBuffer[i]; }
+	}
+	else { memcpy(*payload + vertexBytes, obo.iBuffer, sizeof(GLuint) * obo.noIndices); }
+
+	free(obo.mBuffer);
+	free(obo.iBuffer);
+}
+
+int cookMeshFile(const char* filepath, meshHeader_s* header, unsigned char** payload) { /* Cooks And Writes The .jcmesh Next To The Source, Returns 1 If It Could Not Be Written */
+
+	char path[MAX_PATH];
 
-	loadOBJ(filepath, obo);
 
-	/* Load Main Buffer To VRAM */
+	cookMesh(filepath, header, payload);
+	cookedPath(filepath, ".jcmesh", path);
+	return writeCookedFile(path, header, sizeof(meshHeader_s), *payload, (size_t)header->payloadSize);
+}
+
+const meshHeader_s* openCookedMesh(const char* filepath, mappedFile_s* mf) { /* The Mapped .jcmesh Of filepath, NULL If Missing, Stale Or From Another Version */
+
+	char path[MAX_PATH];
+
+
+	cookedPath(filepath, ".jcmesh", path);
+	if (mapFile(path, mf)) { return NULL; }
+
+	const meshHeader_s* header = (const meshHeader_s*)mf->data;
+	if (mf->size < sizeof(meshHeader_s) || header->magic != MESH_MAGIC_MACRO || header->version != MESH_VERSION_MACRO ||
+		mf->size != sizeof(meshHeader_s) + header->payloadSize || header->attributeCount > MESH_MAX_ATTRIBUTES_MACRO ||
+		!isCookedFresh(filepath, &header->source)) {
+		unmapFile(mf);
+		return NULL;
+	}
+	return header;
+}
+
+void uploadMesh(objectBuffer_s* obo, const meshHeader_s* header, const unsigned char* payload) { /* One Buffer Holds Both, Bound As Vertex And Index Buffer */
+
 	glGenVertexArrays(1, &obo->VAO);
 	glGenBuffers(1, &obo->VBO);
+	glBindVertexArray(obo->VAO);
 
 	glBindBuffer(GL_ARRAY_BUFFER, obo->VBO);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * obo->sizeOfBuffer, obo->mBuffer, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)header->payloadSize, payload, GL_STATIC_DRAW);
+
+	/* Tell Shader How The Buffer Is Formatted, The Index Buffer Binding Is Part Of The VAO */
+	for (unsigned int i = 0; i < header->attributeCount; i++) {
+		const meshAttribute_s* attribute = &header->attributes[i];
+		glVertexAttribPointer(attribute->location, attribute->components, GL_FLOAT, GL_FALSE, header->vertexStride, (void*)(size_t)attribute->offset);
+		glEnableVertexAttribArray(attribute->location);
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, obo->VBO);
+	glBindVertexArray(0);
 
-	/* Debugging */
-	/* for (int i = 0; i < obo.sizeOfBuffer; i++) { printf("%f\n", obo.mBuffer[i]);} */
+	obo->noVertices = header->vertexCount;
+	obo->noIndices = header->indexCount;
+	obo->indexType = header->indexType;
+	obo->indexOffset = header->indexOffset;
+}
 
-	/* Deallocate Main Buffer From RAM */
-	free(obo->mBuffer); obo->mBuffer = NULL;
+void readMesh(const char* filepath, cookedAsset_s* asset) { /* Everything Before The Upload, Safe Off The GL Thread */
 
-	/* Tell Shader How The Buffer Is Formatted */
-	glBindVertexArray(obo->VAO);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-	glEnableVertexAttribArray(1);
+	/* Cooked And Up To Date, Straight From The Mapping To VRAM */
+	const meshHeader_s* cooked = openCookedMesh(filepath, &asset->mf);
+	if (cooked != NULL) {
+		asset->header = cooked;
+		asset->payload = (const unsigned char*)(cooked + 1);
+		return;
+	}
+
+	/* First Run Or The .obj Changed, A Read Only Install Still Starts, Just Without The Cache */
+	asset->cookedHeader = malloc(sizeof(meshHeader_s));
+	if (asset->cookedHeader == NULL) { fputs("Memory error", stderr); exit(2); }
+	cookMeshFile(filepath, (meshHeader_s*)asset->cookedHeader, &asset->cookedPayload);
+	asset->header = asset->cookedHeader;
+	asset->payload = asset->cookedPayload;
+}
+
+void InitObject(const char* filepath, objectBuffer_s* obo) {
+
+	cookedAsset_s asset;
+
+
+	readMesh(filepath, &asset);
+	uploadMesh(obo, (const meshHeader_s*)asset.header, asset.payload);
+	releaseCookedAsset(&asset);
 }
 
 
@@ -458,7 +924,7 @@ void compileShader(shaderBuffer_s* sbo) {
 	if (iscompiled == GL_FALSE) getErrorLog(sbo,  COMPILE_FS);
 }
 
-void linkShader(shaderBuffer_s* sbo) {
+int linkShader(shaderBuffer_s* sbo) { /* Returns 1 For Error */
 	
 	GLint islinked = 0;
 	
@@ -467,10 +933,12 @@ void linkShader(shaderBuffer_s* sbo) {
 
 	glAttachShader(sbo->program, sbo->vertexShader);
 	glAttachShader(sbo->program, sbo->fragmentShader);
+	if (GLEW_ARB_get_program_binary) { glProgramParameteri(sbo->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE); } /* Lets saveProgramBinary() Read It Back */
 	glLinkProgram(sbo->program);
 
 	glGetProgramiv(sbo->program, GL_LINK_STATUS, &islinked);
-	if (islinked == GL_FALSE) { getErrorLog(sbo,  LINK_PROGRAM); glDeleteProgram(sbo->program); }
+	if (islinked == GL_FALSE) { getErrorLog(sbo,  LINK_PROGRAM); glDeleteProgram(sbo->program); return 1; }
+	return 0;
 }
 
 void readShaderFile(const char* vertexPath, const char* fragmentPath, shaderBuffer_s* sbo) {
@@ -522,23 +990,117 @@ void readShaderFile(const char* vertexPath, const char* fragmentPath, shaderBuff
 	fclose(fsFHDL);
 }
 
-void InitShader(const char* vertexPath, const char* fragmentPath, shaderBuffer_s* sbo) {
+#define PROGRAM_MAGIC_MACRO 0x5250434A /* "JCPR" */
+#define PROGRAM_VERSION_MACRO 1
 
-	readShaderFile(vertexPath, fragmentPath, sbo);
-	compileShader(sbo);
-	linkShader(sbo);
+struct programHeader_s { /* Followed By The Driver's Binary Of The Linked Program */
+
+	unsigned int magic;
+	unsigned int version;
+	unsigned long long sourceHash;    /* Both Shader Sources */
+	unsigned long long driverHash;    /* GL_VENDOR, GL_RENDERER And GL_VERSION, A Driver Update Invalidates The Binary */
+	unsigned int binaryFormat;
+	unsigned int binarySize;
+};
+
+
+void programKey(const shaderBuffer_s* sbo, programHeader_s* header) { /* Needs The Context Current */
+
+	const char* driver[3] = { (const char*)glGetString(GL_VENDOR), (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION) };
+
+
+	memset(header, 0, sizeof(programHeader_s));
+	header->magic = PROGRAM_MAGIC_MACRO;
+	header->version = PROGRAM_VERSION_MACRO;
+	header->sourceHash = hashBytes(sbo->vShaderBuffer, strlen(sbo->vShaderBuffer), 14695981039346656037ull);
+	header->sourceHash = hashBytes(sbo->fShaderBuffer, strlen(sbo->fShaderBuffer), header->sourceHash);
+	header->driverHash = 14695981039346656037ull;
+	for (int i = 0; i < 3; i++) { if (driver[i] != NULL) { header->driverHash = hashBytes(driver[i], strlen(driver[i]) + 1, header->driverHash); } }
+}
+
+int loadProgramBinary(const char* filepath, const programHeader_s* key, shaderBuffer_s* sbo) { /* Returns 1 If There Is No Binary For These Sources And This Driver, Or The Driver Rejects It */
+
+	mappedFile_s mf;
+	GLint islinked = 0;
+
+
+	if (mapFile(filepath, &mf)) { return 1; }
+
+	const programHeader_s* header = (const programHeader_s*)mf.data;
+	if (mf.size < sizeof(programHeader_s) || header->magic != key->magic || header->version != key->version || header->sourceHash != key->sourceHash ||
+		header->driverHash != key->driverHash || mf.size != sizeof(programHeader_s) + header->binarySize) {
+		unmapFile(&mf);
+		return 1;
+	}
+
+	sbo->program = glCreateProgram();
+	glProgramBinary(sbo->program, header->binaryFormat, header + 1, header->binarySize);
+	unmapFile(&mf);
+
+	/* Drivers May Refuse Their Own Binaries, After An Update Under The Same Version String Say */
+	glGetProgramiv(sbo->program, GL_LINK_STATUS, &islinked);
+	if (islinked == GL_FALSE) { glDeleteProgram(sbo->program); sbo->program = 0; return 1; }
+	return 0;
+}
+
+void saveProgramBinary(const char* filepath, programHeader_s* header, const shaderBuffer_s* sbo) { /* Best Effort, A Read Only Install Just Compiles Every Time */
+
+	GLint size = 0;
+	GLsizei length = 0;
+	GLenum format = 0;
 
-	/* Cleanup */
-	glDetachShader(sbo->program, sbo->vertexShader);
-	glDetachShader(sbo->program, sbo->fragmentShader);
 
-	glDeleteShader(sbo->vertexShader);
-	glDeleteShader(sbo->fragmentShader);
+	glGetProgramiv(sbo->program, GL_PROGRAM_BINARY_LENGTH, &size);
+	if (size <= 0) { return; }
+
+	void* binary = malloc(size);
+	if (binary == NULL) { fputs("Memory error", stderr); exit(2); }
+	glGetProgramBinary(sbo->program, size, &length, &format, binary);
+
+	if (length > 0) {
+		header->binaryFormat = format;
+		header->binarySize = (unsigned int)length;
+		writeCookedFile(filepath, header, sizeof(programHeader_s), binary, length);
+	}
+	free(binary);
+}
+
+void buildShader(const char* vertexPath, shaderBuffer_s* sbo) { /* The GL Half Of InitShader(), Sources Already Read By readShaderFile() */
+
+	programHeader_s header;
+	char path[MAX_PATH];
+	GLint formats = 0;
+
+
+	/* The Linked Program Is Cached Next To The Vertex Shader, Keyed By Both Sources And The Driver */
+	if (GLEW_ARB_get_program_binary) { glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats); }
+	if (formats > 0) {
+		programKey(sbo, &header);
+		cookedPath(vertexPath, ".jcprog", path);
+	}
+
+	if (formats == 0 || loadProgramBinary(path, &header, sbo)) {
+		compileShader(sbo);
+		if (!linkShader(sbo) && formats > 0) { saveProgramBinary(path, &header, sbo); }
+
+		/* Cleanup */
+		glDetachShader(sbo->program, sbo->vertexShader);
+		glDetachShader(sbo->program, sbo->fragmentShader);
+
+		glDeleteShader(sbo->vertexShader);
+		glDeleteShader(sbo->fragmentShader);
+	}
 
 	free(sbo->vShaderBuffer); sbo->vShaderBuffer = NULL;
 	free(sbo->fShaderBuffer); sbo->fShaderBuffer = NULL;
 }
 
+void InitShader(const char* vertexPath, const char* fragmentPath, shaderBuffer_s* sbo) {
+
+	readShaderFile(vertexPath, fragmentPath, sbo);
+	buildShader(vertexPath, sbo);
+}
+
 void shaderUse(GLint program) {
 	
 	glUseProgram(program);
@@ -588,60 +1150,211 @@ void loadBMP(const char* filepath, textureBuffer_s* tbo) {
 	fclose(FHDL);
 }
 
-void loadPNG(const char* filepath, textureBuffer_s* tbo) {
+#define TEXTURE_MAGIC_MACRO 0x5854434A /* "JCTX" */
+#define TEXTURE_VERSION_MACRO 1
+#define TEXTURE_MAX_LEVELS_MACRO 16
+
+struct textureHeader_s { /* Followed By Every Mip Level As RGBA8, Largest First, Ready For glTexImage2D */
+
+	unsigned int magic;
+	unsigned int version;
+	assetStamp_s source;
+	unsigned int width;
+	unsigned int height;
+	unsigned int levels;
+	unsigned int reserved;
+	unsigned long long levelOffsets[TEXTURE_MAX_LEVELS_MACRO]; /* Bytes Into The Payload */
+	unsigned long long payloadSize;
+};
 
-	FILE* FHDL;
-	size_t result = 0;
-	unsigned long long pngMagic; // 89 50 4e 47 0d 0a 1a 0a
-	pngInfoHeader_s infoheader;
-	int width, height, nrChannels;
 
-	fopen_s(&FHDL, filepath, "rb");
-	if (FHDL == NULL) { fputs("File error", stderr); exit(1); }
+void loadPNG(const char* filepath, textureBuffer_s* tbo) { /* One Read Through A Mapping, Always Decoded To RGBA Since That Is How It Gets Uploaded */
 
-	result = fread(&pngMagic, 1, sizeof(pngMagic), FHDL);
-	if (result != sizeof(pngMagic)) { fputs("Reading error", stderr); exit(3); }
-	pngMagic = _byteswap_uint64(pngMagic);
+	mappedFile_s mf;
+	int nrChannels;
 
-	fseek(FHDL, 16, SEEK_SET);
-	result = fread(&infoheader, 1, sizeof(pngInfoHeader_s), FHDL);
-	if (result != sizeof(pngInfoHeader_s)) { fputs("Reading error", stderr); exit(3); }
 
-	unsigned char* data = stbi_load(filepath, &width, &height, &nrChannels, 0);
-	
-	size_t sizepix = width * height * nrChannels;
-	tbo->pixArr = (GLubyte*)malloc(sizepix); 
-	if (tbo->pixArr == NULL) { fputs("Memory error", stderr); exit(2); }
+	if (mapFile(filepath, &mf)) { fputs("File error", stderr); exit(1); }
+	tbo->pixArr = stbi_load_from_memory((const unsigned char*)mf.data, (int)mf.size, &tbo->width, &tbo->height, &nrChannels, 4);
+	unmapFile(&mf);
+	if (tbo->pixArr == NULL) { fputs("Reading error", stderr); exit(3); }
+}
 
-	tbo->pixArr = data;
-	/* &tbo->pixArr; */
-	/* &data; */
-	tbo->width = width;
-	tbo->height = height;
+void downsampleRGBA(const GLubyte* src, unsigned int width, unsigned int height, GLubyte* dst) { /* 2x2 Box Filter Like glGenerateMipmap(), An Odd Last Row Or Column Is Averaged With Itself */
 
-	fclose(FHDL);
+	unsigned int dstWidth = width > 1 ? width / 2 : 1;
+	unsigned int dstHeight = height > 1 ? height / 2 : 1;
+
+
+	for (unsigned int y = 0; y < dstHeight; y++) {
+		const GLubyte* row0 = src + (size_t)(2 * y < height ? 2 * y : height - 1) * width * 4;
+		const GLubyte* row1 = src + (size_t)(2 * y + 1 < height ? 2 * y + 1 : height - 1) * width * 4;
+		for (unsigned int x = 0; x < dstWidth; x++) {
+			unsigned int x0 = (2 * x < width ? 2 * x : width - 1) * 4;
+			unsigned int x1 = (2 * x + 1 < width ? 2 * x + 1 : width - 1) * 4;
+			for (int c = 0; c < 4; c++) { *dst++ = (GLubyte)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4); }
+		}
+	}
 }
 
-void InitTexture(const char* filepath, textureBuffer_s* tbo) {
+void cookTexture(const char* filepath, textureHeader_s* header, unsigned char** payload) { /* Decodes The PNG And Builds The Whole Mip Chain, payload Is malloc()ed */
 
-	glGenTextures(1, &tbo->id);
-	glBindTexture(GL_TEXTURE_2D, tbo->id);
-	
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-	
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	
-	loadPNG(filepath, tbo);
+	textureBuffer_s tbo = {};
+	unsigned long long size = 0;
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, tbo->width, tbo->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, tbo->pixArr);
-	glGenerateMipmap(GL_TEXTURE_2D);
+	if (stampAsset(filepath, &header->source)) { fputs("File error", stderr); exit(1); }
+	loadPNG(filepath, &tbo);
+
+	header->magic = TEXTURE_MAGIC_MACRO;
+	header->version = TEXTURE_VERSION_MACRO;
+	header->width = tbo.width;
+	header->height = tbo.height;
+	header->reserved = 0;
+	memset(header->levelOffsets, 0, sizeof(header->levelOffsets));
 
-	free(tbo->pixArr);
+	/* Down To 1x1, The Same Levels glGenerateMipmap() Would Make */
+	header->levels = 0;
+	for (unsigned int w = header->width, h = header->height; header->levels < TEXTURE_MAX_LEVELS_MACRO; w = w > 1 ? w / 2 : 1, h = h > 1 ? h / 2 : 1) {
+		header->levelOffsets[header->levels++] = size;
+		size += (unsigned long long)w * h * 4;
+		if (w == 1 && h == 1) { break; }
+	}
+	header->payloadSize = size;
+
+	*payload = (unsigned char*)malloc((size_t)size);
+	if (*payload == NULL) { fputs("Memory error", stderr); exit(2); }
+	memcpy(*payload, tbo.pixArr, (size_t)header->width * header->height * 4);
+	stbi_image_free(tbo.pixArr);
+
+	for (unsigned int level = 1, w = header->width, h = header->height; level < header->levels; level++, w = w > 1 ? w / 2 : 1, h = h > 1 ? h / 2 : 1) {
+		downsampleRGBA(*payload + header->levelOffsets[level - 1], w, h, *payload + header->levelOffsets[level]);
+	}
+}
+
+int cookTextureFile(const char* filepath, textureHeader_s* header, unsigned char** payload) { /* Cooks And Writes The .jctex Next To The Source, Returns 1 If It Could Not Be Written */
+
+	char path[MAX_PATH];
+
+
+	cookTexture(filepath, header, payload);
+	cookedPath(filepath, ".jctex", path);
+	return writeCookedFile(path, header, sizeof(textureHeader_s), *payload, (size_t)header->payloadSize);
+}
+
+const textureHeader_s* openCookedTexture(const char* filepath, mappedFile_s* mf) { /* The Mapped .jctex Of filepath, NULL If Missing, Stale Or From Another Version */
+
+	char path[MAX_PATH];
+
+
+	cookedPath(filepath, ".jctex", path);
+	if (mapFile(path, mf)) { return NULL; }
+
+	const textureHeader_s* header = (const textureHeader_s*)mf->data;
+	if (mf->size < sizeof(textureHeader_s) || header->magic != TEXTURE_MAGIC_MACRO || header->version != TEXTURE_VERSION_MACRO ||
+		mf->size != sizeof(textureHeader_s) + header->payloadSize || header->levels == 0 || header->levels > TEXTURE_MAX_LEVELS_MACRO ||
+		!isCookedFresh(filepath, &header->source)) {
+		unmapFile(mf);
+		return NULL;
+	}
+	return header;
+}
+
+void uploadTexture(textureBuffer_s* tbo, const textureHeader_s* header, const unsigned char* payload) { /* Into The Bound Texture, Every Level As It Is */
+
+	GLsizei width = header->width;
+	GLsizei height = header->height;
+
+
+	for (unsigned int level = 0; level < header->levels; level++) {
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, payload + header->levelOffsets[level]);
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, header->levels - 1);
+
+	tbo->width = header->width;
+	tbo->height = header->height;
+}
+
+void readTexture(const char* filepath, cookedAsset_s* asset) { /* Everything Before The Upload, Safe Off The GL Thread */
+
+	/* Cooked And Up To Date, Decoded Pixels And Mip Levels Straight From The Mapping */
+	const textureHeader_s* cooked = openCookedTexture(filepath, &asset->mf);
+	if (cooked != NULL) {
+		asset->header = cooked;
+		asset->payload = (const unsigned char*)(cooked + 1);
+		return;
+	}
+
+	/* First Run Or The .png Changed, A Read Only Install Still Starts, Just Without The Cache */
+	asset->cookedHeader = malloc(sizeof(textureHeader_s));
+	if (asset->cookedHeader == NULL) { fputs("Memory error", stderr); exit(2); }
+	cookTextureFile(filepath, (textureHeader_s*)asset->cookedHeader, &asset->cookedPayload);
+	asset->header = asset->cookedHeader;
+	asset->payload = asset->cookedPayload;
+}
+
+void createTexture(textureBuffer_s* tbo, const cookedAsset_s* asset) { /* The GL Half Of InitTexture() */
+
+	glGenTextures(1, &tbo->id);
+	glBindTexture(GL_TEXTURE_2D, tbo->id);
+	
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	uploadTexture(tbo, (const textureHeader_s*)asset->header, asset->payload);
+}
+
+void InitTexture(const char* filepath, textureBuffer_s* tbo) {
+
+	cookedAsset_s asset;
+
+
+	readTexture(filepath, &asset);
+	createTexture(tbo, &asset);
+	releaseCookedAsset(&asset);
+}
+
+int cookMain(int argc, char** argv) { /* jonochess --cook [file.obj|file.png ...], Without Files Cooks What The Window Loads */
+
+	static const char* assets[] = { "res/obj/chessboard.obj", "res/obj/chesspiece.obj", "res/obj/chessgrid.obj", "res/texture/chesspiece.png", "res/texture/chesspieceflip.png" };
+	const char** files = argc > 2 ? (const char**)argv + 2 : assets;
+	int count = argc > 2 ? argc - 2 : (int)(sizeof(assets) / sizeof(assets[0]));
+	int errors = 0;
+
+
+	for (int i = 0; i < count; i++) {
+		const char* dot = strrchr(files[i], '.');
+		bool bTexture = dot != NULL && !_stricmp(dot, ".png");
+		unsigned char* payload;
+		char path[MAX_PATH];
+		int result;
+
+		DWORD start = timeGetTime();
+		cookedPath(files[i], bTexture ? ".jctex" : ".jcmesh", path);
+		if (bTexture) {
+			textureHeader_s header;
+			result = cookTextureFile(files[i], &header, &payload);
+			if (!result) { fprintf(stdout, "%s -> %s: %ux%u, %u mip levels, %llu bytes in %u ms\n", files[i], path, header.width, header.height, header.levels,
+				(unsigned long long)sizeof(textureHeader_s) + header.payloadSize, timeGetTime() - start); }
+		}
+		else {
+			meshHeader_s header;
+			result = cookMeshFile(files[i], &header, &payload);
+			if (!result) { fprintf(stdout, "%s -> %s: %u vertices, %u indices, %llu bytes in %u ms\n", files[i], path, header.vertexCount, header.indexCount,
+				(unsigned long long)sizeof(meshHeader_s) + header.payloadSize, timeGetTime() - start); }
+		}
+		free(payload);
+		if (result) { fprintf(stderr, "File error, Could Not Write %s\n", path); errors++; }
+	}
+	return errors ? 1 : 0;
 }
 
 
@@ -664,7 +1377,7 @@ void setGridUniform(float x, float y, uniformMat4_s* uniform) {
 void drawTris(objectBuffer_s* obo) {
 
 	glBindVertexArray(obo->VAO);
-	glDrawArrays(GL_TRIANGLES, 0, obo->noIndices);
+	glDrawElements(GL_TRIANGLES, obo->noIndices, obo->indexType, (void*)(size_t)obo->indexOffset);
 }
 
 /* jono, Might Be A Little Bit Cleaning Up Here To Do :) */
@@ -850,7 +1563,7 @@ void drawChessPieceDynamic(uniformMat4_s* uniform, GLint texUniform, objectBuffe
 	glUniformMatrix4fv(uniform->location, 1, GL_FALSE, glm::value_ptr(uniform->mat4));
 	glUniform2f(texUniform, movingPiece.xShift, movingPiece.yShift);
 	glBindVertexArray(obo->VAO);
-	glDrawArrays(GL_TRIANGLES, 0, obo->noIndices);
+	glDrawElements(GL_TRIANGLES, obo->noIndices, obo->indexType, (void*)(size_t)obo->indexOffset);
 }
 
 void freeBufferObject(objectBuffer_s* obo) {
@@ -872,6 +1585,7 @@ int validateBishopMove(char indexWish, char indexOrg);
 int validateRookMove(char indexWish, char indexOrg);
 int validateQueenMove(char indexWish, char indexOrg);
 int validateKingMove(char indexWish, char indexOrg);
+void recordGUIMove(char indexFrom, char indexTo);
 
 
 /* More Cleaning Up */
@@ -1759,6 +2473,7 @@ void endPlayerMove(void) {
 	double posx = mousePosition.x;
 	double posy = mousePosition.y;
 	chessPiece_e pieceAtDest = NONE;
+	char indexFrom = movingPiece.indexOrg; /* Promotions Overwrite indexOrg */
 
 	getTemporaryState(); /* For Reverting The State */
 	indexWish = getChessIndex(posx, posy);
@@ -1798,8 +2513,14 @@ void endPlayerMove(void) {
 	if (bHandleEnPassant == true) {
 		handleEnPassant(indexWish);
 	}
+
+	if (movingPiece.piece == WHITE_PAWN || movingPiece.piece == BLACK_PAWN || pieceAtDest != NONE || bHandleEnPassant) { iHalfmoveClock = 0; }
+	else { iHalfmoveClock++; }
+	if (bCurrentTurn) { iFullmoveNumber++; }
+
 	movingPiece.piece = NONE;
 	bCurrentTurn = !bCurrentTurn;
+	recordGUIMove(indexFrom, indexWish);
 }
 
 void promoteToQueen(void) {
@@ -1859,243 +2580,7441 @@ void promoteToBishop(void) {
 }
 
 
- /* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
-  *                                                                                                                            *
-  *            GLFW Callbacks                                                                                                  *
-  *	                                                                                                                          *
-  * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Engine -- Board Representation                                                                                  *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
 
-void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+#define MAX_PLY_MACRO 128       /* deepest line the search will ever follow */
+#define MAX_MOVES_MACRO 256     /* no legal chess position has more than 218 moves */
+#define MAX_GAME_PLY_MACRO 1024 /* longest game history kept for repetition detection */
+#define MAX_MULTIPV_MACRO 64    /* most root lines a MultiPV search reports */
+#define MAX_FEN_MACRO 128       /* longest legal FEN is under 100 chars */
 
-	
-	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
-		glfwSetWindowShouldClose(window, true);
-	}
-	if (key == GLFW_KEY_F && action == GLFW_PRESS) {
-		bScreenIsFlipped = !bScreenIsFlipped;
-	}
+typedef unsigned long long bitboard_t;
+typedef unsigned short move_t; /* From 0-5, To 6-11, moveFlag_e 12-15 */
 
-	if (bValidPromotion) {
-		if (key == GLFW_KEY_Q && action == GLFW_PRESS)
-			promoteToQueen();
-		if (key == GLFW_KEY_R && action == GLFW_PRESS)
-			promoteToRook();
-		if (key == GLFW_KEY_N && action == GLFW_PRESS)
-			promoteToKnight();
-		if (key == GLFW_KEY_B && action == GLFW_PRESS)
-			promoteToBishop();
-	}
-}
+enum pieceType_e {
 
-void mouse_button_disabled(GLFWwindow* window, int button, int action, int mods) { /* does what it says */
-	
+	PAWN = 1, KNIGHT, BISHOP, ROOK, QUEEN, KING
+};
+
+enum moveFlag_e {
+
+	QUIET_MOVE, DOUBLE_PAWN_PUSH, KING_CASTLE, QUEEN_CASTLE, CAPTURE, EN_PASSANT_CAPTURE,
+	PROMOTE_KNIGHT = 8, PROMOTE_BISHOP, PROMOTE_ROOK, PROMOTE_QUEEN,
+	PROMOTE_KNIGHT_CAPTURE, PROMOTE_BISHOP_CAPTURE, PROMOTE_ROOK_CAPTURE, PROMOTE_QUEEN_CAPTURE
+};
+
+enum castleRight_e {
+
+	CASTLE_WHITE_SHORT = 1, CASTLE_WHITE_LONG = 2, CASTLE_BLACK_SHORT = 4, CASTLE_BLACK_LONG = 8
+};
+
+enum rayDirection_e {
+
+	NORTH, SOUTH, EAST, WEST, NORTH_EAST, NORTH_WEST, SOUTH_EAST, SOUTH_WEST
+};
+
+struct position_s { /* The Engine's Own Board, Independent Of The GUI Globals So Any Number Can Exist At Once */
+
+	bitboard_t pieceBB[13];    /* Indexed By chessPiece_e */
+	bitboard_t colorBB[2];     /* 0 For White, 1 For Black */
+	bitboard_t occupiedBB;
+	unsigned char board[64];   /* Square = v * 8 + u, Same Layout As currentState[v][u] So a8 = 0 And h1 = 63 */
+	unsigned char sideToMove;  /* 0 For White, 1 For Black, Same As bCurrentTurn */
+	unsigned char castling;    /* castleRight_e Flags */
+	signed char epSquare;      /* -1 When No En Passant Capture Is Possible */
+	unsigned char halfmoveClock;
+	unsigned short fullmoveNumber;
+	unsigned long long key;    /* Zobrist Hash */
+};
+
+const char* startFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+position_s startPosition; /* startFEN, Parsed By initEngine() */
+const char* pieceChars = " PNBRQKpnbrqk";
+signed char fenPieceTable[256]; /* Char To chessPiece_e, -1 If Not A Piece, Filled By initEngine() */
+
+bitboard_t knightAttacks[64];
+bitboard_t kingAttacks[64];
+bitboard_t pawnAttacks[2][64];
+bitboard_t rayMasks[8][64];
+unsigned long long zobristPiece[13][64];
+unsigned long long zobristCastle[16];
+unsigned long long zobristEp[8];
+unsigned long long zobristSide;
+unsigned char castleMask[64];
+
+void initEvaluation(void);
+void initSearch(void);
+int parseFEN(position_s* pos, const char* fen);
+
+inline int bitScan(bitboard_t b) {
+
+	unsigned long index;
+	_BitScanForward64(&index, b);
+	return (int)index;
 }
 
-void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+inline int bitScanReverse(bitboard_t b) {
 
-	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
-		startPlayerMove();
-	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
-		endPlayerMove();
+	unsigned long index;
+	_BitScanReverse64(&index, b);
+	return (int)index;
 }
 
-void windowResize(GLFWwindow* window, int width, int height) {
+inline int popBit(bitboard_t* b) {
 
-	if (width > height) {
+	int sq = bitScan(*b);
+	*b &= *b - 1;
+	return sq;
+}
 
-		long shift = (long)(width - height);
+inline int bitCount(bitboard_t b) {
 
+	return (int)__popcnt64(b);
+}
 
-		mousePosition.offsetY = 0.0f;
-		mousePosition.offsetX = (double)(shift >> 1);
+inline int pieceColor(int piece) { return piece >= BLACK_PAWN; }
+inline int pieceType(int piece) { return piece > WHITE_KING ? piece - WHITE_KING : piece; }
+inline int makePiece(int color, int type) { return type + color * WHITE_KING; }
 
-		glViewport((GLint)(shift >> 1), 0, height, height);
+inline int moveFrom(move_t m) { return m & 63; }
+inline int moveTo(move_t m) { return (m >> 6) & 63; }
+inline int moveFlag(move_t m) { return m >> 12; }
+inline bool isCaptureMove(move_t m) { return (m >> 12) & CAPTURE; }
+inline bool isPromotionMove(move_t m) { return (m >> 12) & PROMOTE_KNIGHT; }
+inline int promotionType(move_t m) { return KNIGHT + ((m >> 12) & 3); }
+inline move_t encodeMove(int from, int to, int flag) { return (move_t)(from | (to << 6) | (flag << 12)); }
 
-		windowResolution.x = (long)height;
-		windowResolution.y = (long)height;
-	}
-	else if (width < height) {
+unsigned long long randomU64(unsigned long long* state) { /* xorshift64*, Deterministic So Hashes Match Across Runs */
 
-		long shift = (long)(height - width);
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 2685821657736338717ULL;
+}
 
+bitboard_t rayAttacks(int dir, int sq, bitboard_t occupied) {
 
-		mousePosition.offsetX = 0.0f;
-		mousePosition.offsetY = (double)(shift >> 1);
+	bitboard_t attacks = rayMasks[dir][sq];
+	bitboard_t blockers = attacks & occupied;
 
-		glViewport(0, (GLint)(shift >> 1), width, width);
 
-		windowResolution.x = (long)width;
-		windowResolution.y = (long)width;
+	if (blockers) {
+		/* Rays Going Towards h1 Hit Their Lowest Blocker First, Rays Going Towards a8 Their Highest */
+		int blocker = (dir == SOUTH || dir == EAST || dir == SOUTH_EAST || dir == SOUTH_WEST) ? bitScan(blockers) : bitScanReverse(blockers);
+		attacks ^= rayMasks[dir][blocker];
 	}
-	else {
+	return attacks;
+}
 
-		mousePosition.offsetX = 0.0f;
-		mousePosition.offsetY = 0.0f;
-		
-		glViewport(0, 0, width, height);
+bitboard_t bishopAttacks(int sq, bitboard_t occupied) {
 
-		windowResolution.x = (long)width;
-		windowResolution.y = (long)height;
-	}
+	return rayAttacks(NORTH_EAST, sq, occupied) | rayAttacks(NORTH_WEST, sq, occupied) |
+	       rayAttacks(SOUTH_EAST, sq, occupied) | rayAttacks(SOUTH_WEST, sq, occupied);
 }
 
+bitboard_t rookAttacks(int sq, bitboard_t occupied) {
 
-/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
- *                                                                                                                            *
- *            Timing                                                                                                          *
- *	                                                                                                                          *
- * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+	return rayAttacks(NORTH, sq, occupied) | rayAttacks(SOUTH, sq, occupied) |
+	       rayAttacks(EAST, sq, occupied) | rayAttacks(WEST, sq, occupied);
+}
 
-int Sys_Milliseconds(windowsTimer_s* t) {
+void initEngine(void) { /* Attack Tables And Zobrist Keys, Call Once Before Using Any position_s */
 
-	int sys_curtime;
 	static bool initialized = false;
+	const int rayRank[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+	const int rayFile[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+	const int knightRank[8] = { -2, -2, -1, -1, 1, 1, 2, 2 };
+	const int knightFile[8] = { -1, 1, -2, 2, -2, 2, -1, 1 };
+	unsigned long long seed = 0x4a6f6e6f43686573ULL;
 
 
-	if (!initialized) {
+	if (initialized) { return; }
+	initialized = true;
 
-		t->time = timeGetTime(); // winmm.lib
-		initialized = true;
+	for (int sq = 0; sq < 64; sq++) {
+
+		int r = sq >> 3;
+		int f = sq & 7;
+
+		for (int k = 0; k < 8; k++) {
+			int nr = r + knightRank[k], nf = f + knightFile[k];
+			if (nr >= 0 && nr < 8 && nf >= 0 && nf < 8) { knightAttacks[sq] |= 1ULL << (nr * 8 + nf); }
+
+			nr = r + rayRank[k]; nf = f + rayFile[k];
+			if (nr >= 0 && nr < 8 && nf >= 0 && nf < 8) { kingAttacks[sq] |= 1ULL << (nr * 8 + nf); }
+
+			/* Walk The Ray Until It Leaves The Board */
+			while (nr >= 0 && nr < 8 && nf >= 0 && nf < 8) {
+				rayMasks[k][sq] |= 1ULL << (nr * 8 + nf);
+				nr += rayRank[k]; nf += rayFile[k];
+			}
+		}
+
+		/* White Pawns Capture Towards Rank 8 (Lower Squares), Black Towards Rank 1 */
+		if (r > 0 && f > 0) { pawnAttacks[0][sq] |= 1ULL << (sq - 9); }
+		if (r > 0 && f < 7) { pawnAttacks[0][sq] |= 1ULL << (sq - 7); }
+		if (r < 7 && f > 0) { pawnAttacks[1][sq] |= 1ULL << (sq + 7); }
+		if (r < 7 && f < 7) { pawnAttacks[1][sq] |= 1ULL << (sq + 9); }
+
+		castleMask[sq] = 15;
 	}
-	sys_curtime = timeGetTime() - t->time;
 
+	castleMask[56] &= ~CASTLE_WHITE_LONG;  castleMask[63] &= ~CASTLE_WHITE_SHORT; castleMask[60] &= ~(CASTLE_WHITE_SHORT | CASTLE_WHITE_LONG);
+	castleMask[0]  &= ~CASTLE_BLACK_LONG;  castleMask[7]  &= ~CASTLE_BLACK_SHORT; castleMask[4]  &= ~(CASTLE_BLACK_SHORT | CASTLE_BLACK_LONG);
 
-	return sys_curtime;
+	for (int p = 0; p < 13; p++) {
+		for (int sq = 0; sq < 64; sq++) { zobristPiece[p][sq] = randomU64(&seed); }
+	}
+	for (int i = 0; i < 16; i++) { zobristCastle[i] = randomU64(&seed); }
+	for (int i = 0; i < 8; i++)  { zobristEp[i] = randomU64(&seed); }
+	zobristSide = randomU64(&seed);
+
+	memset(fenPieceTable, -1, sizeof(fenPieceTable));
+	for (int p = 1; p < 13; p++) { fenPieceTable[(unsigned char)pieceChars[p]] = (signed char)p; }
+	parseFEN(&startPosition, startFEN);
+
+	initEvaluation();
+	initSearch();
 }
 
-void timerStart(windowsTimer_s* t) {
+inline void putPiece(position_s* pos, int piece, int sq) {
 
-	t->start = Sys_Milliseconds(t);
+	bitboard_t bb = 1ULL << sq;
+
+	pos->pieceBB[piece] |= bb;
+	pos->colorBB[pieceColor(piece)] |= bb;
+	pos->occupiedBB |= bb;
+	pos->board[sq] = (unsigned char)piece;
+	pos->key ^= zobristPiece[piece][sq];
 }
 
-void timerEnd(windowsTimer_s* t) {
+inline void removePiece(position_s* pos, int sq) {
 
-	t->end = Sys_Milliseconds(t);
-	t->ms += t->end - t->start;
+	int piece = pos->board[sq];
+	bitboard_t bb = 1ULL << sq;
+
+	pos->pieceBB[piece] &= ~bb;
+	pos->colorBB[pieceColor(piece)] &= ~bb;
+	pos->occupiedBB &= ~bb;
+	pos->board[sq] = NONE;
+	pos->key ^= zobristPiece[piece][sq];
 }
 
+bool isSquareAttackedThrough(const position_s* pos, int sq, int byColor, bitboard_t occupied) { /* Sliders See Through Anything Missing From occupied */
 
-/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
- *                                                                                                                            *
- *            Main                                                                                                            *
- *	                                                                                                                          *
- * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+	bitboard_t queens = pos->pieceBB[makePiece(byColor, QUEEN)];
 
-int main(int argc, char* argv[]) {
 
-	windowsTimer_s winTimer = {};
+	if (pawnAttacks[byColor ^ 1][sq] & pos->pieceBB[makePiece(byColor, PAWN)]) { return true; }
+	if (knightAttacks[sq] & pos->pieceBB[makePiece(byColor, KNIGHT)])         { return true; }
+	if (kingAttacks[sq] & pos->pieceBB[makePiece(byColor, KING)])             { return true; }
+	if (bishopAttacks(sq, occupied) & (pos->pieceBB[makePiece(byColor, BISHOP)] | queens)) { return true; }
+	if (rookAttacks(sq, occupied) & (pos->pieceBB[makePiece(byColor, ROOK)] | queens))     { return true; }
 
+	return false;
+}
 
-	timerStart(&winTimer);
+inline bool isSquareAttacked(const position_s* pos, int sq, int byColor) { return isSquareAttackedThrough(pos, sq, byColor, pos->occupiedBB); }
 
+inline int kingSquare(const position_s* pos, int color) {
 
-    /* oooooooooooooooooooooooooooooooooooooooooooooooooooo GLFW -- Init oooooooooooooooooooooooooooooooooooooooooooooooooooo */
+	return bitScan(pos->pieceBB[makePiece(color, KING)]);
+}
 
-	GLFWwindow* window;
+inline bool inCheck(const position_s* pos) {
 
+	return isSquareAttacked(pos, kingSquare(pos, pos->sideToMove), pos->sideToMove ^ 1);
+}
 
-    if (!glfwInit()) return 1;
-        
-	window = glfwCreateWindow(windowResolution.x, windowResolution.y, "jonochess", NULL, NULL);
-    if (!window) {glfwTerminate();return 1;}
+void setEnPassantSquare(position_s* pos, int sq) { /* Only Recorded When A Capture Is Really Possible, Keeps Hashes Of Equal Positions Equal */
 
-    glfwMakeContextCurrent(window);
+	int us = pos->sideToMove;
 
-	/* Callbacks */
-	GLFWcursor* cursor = glfwCreateStandardCursor(GLFW_CROSSHAIR_CURSOR);
-	
 
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
-	glfwSetCursor(window, cursor);
-	
-	glfwSetFramebufferSizeCallback(window, windowResize);
-	glfwSetMouseButtonCallback(window, mouse_button_callback);
+	if (pawnAttacks[us ^ 1][sq] & pos->pieceBB[makePiece(us, PAWN)]) {
+		pos->epSquare = (signed char)sq;
+		pos->key ^= zobristEp[sq & 7];
+	}
+}
 
-	glfwSetKeyCallback(window, key_callback);
+int parseFENLength(position_s* pos, const char* fen, size_t length) { /* Returns 1 For Error, Never Reads Past fen + length So Mapped Files Need No Terminator */
 
+	const char* p = fen;
+	const char* end = fen + length;
+	int sq = 0;
 
-    /* oooooooooooooooooooooooooooooooooooooooooooooooooooo GLEW -- Init oooooooooooooooooooooooooooooooooooooooooooooooooooo */
-    
-	GLenum err = glewInit();
 
+	memset(pos, 0, sizeof(position_s));
+	pos->epSquare = -1;
+	pos->fullmoveNumber = 1;
 
-    if (GLEW_OK != err) { fprintf(stderr, "Error: %s\n", glewGetErrorString(err)); glfwTerminate(); return 1;}
+	/* Piece Placement, Rank 8 First Which Is Exactly Our Square Order */
+	while (p < end && *p == ' ') { p++; }
+	for (; p < end && *p != ' '; p++) {
+		if (*p == '/') { continue; }
+		if (*p >= '1' && *p <= '8') { sq += *p - '0'; continue; }
+		int piece = fenPieceTable[(unsigned char)*p];
+		if (piece < 0 || sq > 63) { return 1; }
+		putPiece(pos, piece, sq);
+		sq++;
+	}
+	if (sq != 64) { return 1; }
+	if (bitCount(pos->pieceBB[WHITE_KING]) != 1 || bitCount(pos->pieceBB[BLACK_KING]) != 1) { return 1; }
+
+	/* Side To Move */
+	while (p < end && *p == ' ') { p++; }
+	if (p == end) { return 1; }
+	if (*p == 'b') { pos->sideToMove = 1; pos->key ^= zobristSide; }
+	else if (*p != 'w') { return 1; }
+	p++;
+
+	/* Castling Rights */
+	while (p < end && *p == ' ') { p++; }
+	for (; p < end && *p != ' ' && *p != '\r' && *p != '\n'; p++) {
+		switch (*p) {
+		case('K'): pos->castling |= CASTLE_WHITE_SHORT; break;
+		case('Q'): pos->castling |= CASTLE_WHITE_LONG;  break;
+		case('k'): pos->castling |= CASTLE_BLACK_SHORT; break;
+		case('q'): pos->castling |= CASTLE_BLACK_LONG;  break;
+		case('-'): break;
+		default: return 1;
+		}
+	}
 
-    fprintf(stdout, "Status: Using GLEW %s\n", glewGetString(GLEW_VERSION));    
-    
+	/* Rights Whose King Or Rook Left Home Are Dropped, Castling Moves Them From Exactly These Squares */
+	if (pos->board[60] != WHITE_KING) { pos->castling &= ~(CASTLE_WHITE_SHORT | CASTLE_WHITE_LONG); }
+	if (pos->board[63] != WHITE_ROOK) { pos->castling &= ~CASTLE_WHITE_SHORT; }
+	if (pos->board[56] != WHITE_ROOK) { pos->castling &= ~CASTLE_WHITE_LONG; }
+	if (pos->board[4] != BLACK_KING)  { pos->castling &= ~(CASTLE_BLACK_SHORT | CASTLE_BLACK_LONG); }
+	if (pos->board[7] != BLACK_ROOK)  { pos->castling &= ~CASTLE_BLACK_SHORT; }
+	if (pos->board[0] != BLACK_ROOK)  { pos->castling &= ~CASTLE_BLACK_LONG; }
+	pos->key ^= zobristCastle[pos->castling];
+
+	/* En Passant Square, Only Behind A Pawn That Can Just Have Pushed Two, Anything Else Is Ignored Like '-' */
+	while (p < end && *p == ' ') { p++; }
+	if (end - p >= 2 && *p >= 'a' && *p <= 'h' && p[1] >= '1' && p[1] <= '8') {
+		int ep = ('8' - p[1]) * 8 + (p[0] - 'a');
+		int forward = pos->sideToMove ? -8 : 8; /* Toward The Pawn That Pushed */
+		if (ep >> 3 == (pos->sideToMove ? 5 : 2) && pos->board[ep + forward] == makePiece(pos->sideToMove ^ 1, PAWN) &&
+			pos->board[ep] == NONE && pos->board[ep - forward] == NONE) {
+			setEnPassantSquare(pos, ep);
+		}
+		p += 2;
+	}
+	else if (p < end && *p == '-') { p++; }
+
+	/* Clocks Are Optional, EPD Lines Stop Before Them */
+	while (p < end && *p == ' ') { p++; }
+	if (p < end && *p >= '0' && *p <= '9') {
+		int halfmove = 0;
+		while (p < end && *p >= '0' && *p <= '9') { halfmove = halfmove * 10 + *p++ - '0'; }
+		pos->halfmoveClock = (unsigned char)(halfmove < 255 ? halfmove : 255);
+
+		while (p < end && *p == ' ') { p++; }
+		if (p < end && *p >= '1' && *p <= '9') {
+			int fullmove = 0;
+			while (p < end && *p >= '0' && *p <= '9') { fullmove = fullmove * 10 + *p++ - '0'; }
+			pos->fullmoveNumber = (unsigned short)(fullmove < 65535 ? fullmove : 65535);
+		}
+	}
 
-	/* ooooooooooooooooooooooooooooooooooooooooooooooooooo Shader -- Init ooooooooooooooooooooooooooooooooooooooooooooooooooo */
+	return 0;
+}
 
-	shaderBuffer_s chessBoardShader = {};
-	shaderBuffer_s chessPieceDynamicShader = {};
-	shaderBuffer_s chessPieceStaticShader = {};
+int parseFEN(position_s* pos, const char* fen) { /* Returns 1 For Error */
 
+	return parseFENLength(pos, fen, strlen(fen));
+}
 
-	InitShader("res/shader/board.vs", "res/shader/board.fs", &chessBoardShader);
-	InitShader("res/shader/piece.vs", "res/shader/piece.fs", &chessPieceDynamicShader);
-	InitShader("res/shader/grid.vs", "res/shader/grid.fs", &chessPieceStaticShader);
+int positionToFEN(const position_s* pos, char* str) { /* Needs Room For MAX_FEN_MACRO Chars, Returns The Length */
 
-	/* Used To Bind A Chess Piece To Mouse Cursor */
-	uniformMat4_s transform = {}; transform.name = "transform";
-	transform.location = glGetUniformLocation(chessPieceDynamicShader.program, transform.name);
+	char* p = str;
 
-	GLint TexCoordShiftLoc1 = glGetUniformLocation(chessPieceDynamicShader.program, "TexCoordShift1");
 
-	/* Used To Index The Board Coordinates And Draw Static Pieces To Correct Squares */
-	uniformMat4_s transform1 = {}; transform1.name = "transform1";
-	transform1.location = glGetUniformLocation(chessPieceStaticShader.program, transform1.name);
+	for (int v = 0; v < 8; v++) {
+		int empty = 0;
+		for (int u = 0; u < 8; u++) {
+			int piece = pos->board[v * 8 + u];
+			if (piece == NONE) { empty++; continue; }
+			if (empty) { *p++ = (char)('0' + empty); empty = 0; }
+			*p++ = pieceChars[piece];
+		}
+		if (empty) { *p++ = (char)('0' + empty); }
+		if (v < 7) { *p++ = '/'; }
+	}
 
-	GLint TexCoordShiftLoc = glGetUniformLocation(chessPieceStaticShader.program, "TexCoordShift");
+	*p++ = ' ';
+	*p++ = pos->sideToMove ? 'b' : 'w';
+	*p++ = ' ';
+	if (pos->castling == 0) { *p++ = '-'; }
+	if (pos->castling & CASTLE_WHITE_SHORT) { *p++ = 'K'; }
+	if (pos->castling & CASTLE_WHITE_LONG)  { *p++ = 'Q'; }
+	if (pos->castling & CASTLE_BLACK_SHORT) { *p++ = 'k'; }
+	if (pos->castling & CASTLE_BLACK_LONG)  { *p++ = 'q'; }
+
+	/* Only Written When A Capture Is Really Possible, Same As setEnPassantSquare() */
+	*p++ = ' ';
+	if (pos->epSquare >= 0) { *p++ = (char)('a' + (pos->epSquare & 7)); *p++ = (char)('8' - (pos->epSquare >> 3)); }
+	else { *p++ = '-'; }
+
+	p += sprintf(p, " %d %d", pos->halfmoveClock, pos->fullmoveNumber);
+	return (int)(p - str);
+}
 
-	
-	/* oooooooooooooooooooooooooooooooooooooooooooooooooo Texture -- Init ooooooooooooooooooooooooooooooooooooooooooooooooooo */
+typedef void (*fenCallback_t)(const position_s* pos, const char* line, size_t length, void* user);
 
-	textureBuffer_s texture0 = {}; texture0.name = "texture0";
-	textureBuffer_s texture1 = {}; texture1.name = "texture0";
+struct fenFileStats_s {
 
-	InitTexture("res/texture/chesspiece.png", &texture0);
-	InitTexture("res/texture/chesspieceflip.png", &texture1);
+	unsigned long long positions;
+	unsigned long long skipped;  /* Lines That Are Not A Valid FEN Or EPD, Blank Lines Excluded */
+};
 
-	/* Set Texture Uniforms */
-	shaderUse(chessPieceStaticShader.program); /* don't forget to activate/use the shader before setting uniforms! */
-	setTextureUniform(&chessPieceStaticShader, &texture0);
+int forEachFEN(const char* filepath, fenCallback_t onPosition, void* user, fenFileStats_s* stats) { /* Bulk Loader, Returns 1 For Error, No Allocations Per Line */
 
-	shaderUse(chessPieceDynamicShader.program);
-	setTextureUniform(&chessPieceDynamicShader, &texture0);
+	mappedFile_s mf;
+	position_s pos;
 
 
-	/* ooooooooooooooooooooooooooooooooooooooooooooooooooo Object -- Init ooooooooooooooooooooooooooooooooooooooooooooooooooo */
-	
-	objectBuffer_s chessBoardObject = {};
-	objectBuffer_s chessPieceDynamicObject = {};
-	objectBuffer_s chessPieceStaticObject = {};
+	memset(stats, 0, sizeof(fenFileStats_s));
+	if (mapFile(filepath, &mf)) { return 1; }
 
+	const char* p = mf.data;
+	const char* end = mf.data + mf.size;
+	while (p < end) {
+		const char* eol = (const char*)memchr(p, '\n', end - p);
+		if (eol == NULL) { eol = end; }
 
-	InitObject("res/obj/chessboard.obj", &chessBoardObject);
-	InitObject("res/obj/chesspiece.obj", &chessPieceDynamicObject);
-	InitObject("res/obj/chessgrid.obj", &chessPieceStaticObject);
+		size_t length = eol - p;
+		if (length && p[length - 1] == '\r') { length--; }
+		if (length) {
+			if (parseFENLength(&pos, p, length) == 0) { stats->positions++; onPosition(&pos, p, length, user); }
+			else { stats->skipped++; }
+		}
+		p = eol + 1;
+	}
 
+	unmapFile(&mf);
+	return 0;
+}
 
-	/* oooooooooooooooooooooooooooooooooooooooooooooooooo Game Logic -- Init oooooooooooooooooooooooooooooooooooooooooooooooo */
-	
-	blackKing.currentIndex = 0x15; whiteKing.currentIndex = 0x85;
-	
-	/* TODO: Make A Board From Black Or White Perspective */
+void moveToUCI(move_t m, char* str) { /* Needs Room For 6 Chars */
 
+	int from = moveFrom(m);
+	int to = moveTo(m);
 
-	/* oooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooo */
 
-	/* Timing */
-	timerEnd(&winTimer);
-    fprintf(stdout, "Status: Init complete in %u ms\n", winTimer.ms);
+	if (m == 0) { strcpy(str, "0000"); return; }
+	str[0] = 'a' + (from & 7); str[1] = '8' - (from >> 3);
+	str[2] = 'a' + (to & 7);   str[3] = '8' - (to >> 3);
+	str[4] = '\0';
+	if (isPromotionMove(m)) { str[4] = pieceChars[promotionType(m) + BLACK_PAWN - 1]; str[5] = '\0'; }
+}
 
 
-	/* oooooooooooooooooooooooooooooooooooooooooooooooooooooo Main Loop ooooooooooooooooooooooooooooooooooooooooooooooooooooo */
-    while (!glfwWindowShouldClose(window)) {
-		
-		/* Promoting */
-		while (bValidPromotion) {
-			glfwSetMouseButtonCallback(window, mouse_button_disabled);
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Engine -- Move Generation                                                                                       *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+void addPieceMoves(move_t* list, int* n, int from, bitboard_t targets, bitboard_t enemy) {
+
+	while (targets) {
+		int to = popBit(&targets);
+		list[(*n)++] = encodeMove(from, to, ((enemy >> to) & 1) ? CAPTURE : QUIET_MOVE);
+	}
+}
+
+void addPromotions(move_t* list, int* n, int from, int to, int captureFlag, bool bQueenOnly) {
+
+	list[(*n)++] = encodeMove(from, to, PROMOTE_QUEEN | captureFlag);
+	if (bQueenOnly) { return; }
+	list[(*n)++] = encodeMove(from, to, PROMOTE_KNIGHT | captureFlag);
+	list[(*n)++] = encodeMove(from, to, PROMOTE_ROOK | captureFlag);
+	list[(*n)++] = encodeMove(from, to, PROMOTE_BISHOP | captureFlag);
+}
+
+int generateMoves(const position_s* pos, move_t* list, bool bCapturesOnly) { /* Pseudo Legal, makeMove() Filters Self-Checks */
+
+	int n = 0;
+	int us = pos->sideToMove;
+	int them = us ^ 1;
+	bitboard_t own = pos->colorBB[us];
+	bitboard_t enemy = pos->colorBB[them];
+	bitboard_t targets = bCapturesOnly ? enemy : ~own;
+	bitboard_t bb;
+	int push = us ? 8 : -8;
+	int promoRow = us ? 7 : 0;
+	int startRow = us ? 1 : 6;
+
+
+	/* Pawns */
+	bb = pos->pieceBB[makePiece(us, PAWN)];
+	while (bb) {
+		int from = popBit(&bb);
+		int to = from + push;
+		bitboard_t captures = pawnAttacks[us][from] & enemy;
+
+		if (!((pos->occupiedBB >> to) & 1)) {
+			if ((to >> 3) == promoRow) { addPromotions(list, &n, from, to, QUIET_MOVE, bCapturesOnly); }
+			else if (!bCapturesOnly) {
+				list[n++] = encodeMove(from, to, QUIET_MOVE);
+				if ((from >> 3) == startRow && !((pos->occupiedBB >> (to + push)) & 1)) {
+					list[n++] = encodeMove(from, to + push, DOUBLE_PAWN_PUSH);
+				}
+			}
+		}
+		while (captures) {
+			to = popBit(&captures);
+			if ((to >> 3) == promoRow) { addPromotions(list, &n, from, to, CAPTURE, bCapturesOnly); }
+			else { list[n++] = encodeMove(from, to, CAPTURE); }
+		}
+		if (pos->epSquare >= 0 && ((pawnAttacks[us][from] >> pos->epSquare) & 1)) {
+			list[n++] = encodeMove(from, pos->epSquare, EN_PASSANT_CAPTURE);
+		}
+	}
+
+	/* Knights */
+	bb = pos->pieceBB[makePiece(us, KNIGHT)];
+	while (bb) {
+		int from = popBit(&bb);
+		addPieceMoves(list, &n, from, knightAttacks[from] & targets, enemy);
+	}
+
+	/* Bishops And Queens Diagonally */
+	bb = pos->pieceBB[makePiece(us, BISHOP)] | pos->pieceBB[makePiece(us, QUEEN)];
+	while (bb) {
+		int from = popBit(&bb);
+		addPieceMoves(list, &n, from, bishopAttacks(from, pos->occupiedBB) & targets, enemy);
+	}
+
+	/* Rooks And Queens Straight */
+	bb = pos->pieceBB[makePiece(us, ROOK)] | pos->pieceBB[makePiece(us, QUEEN)];
+	while (bb) {
+		int from = popBit(&bb);
+		addPieceMoves(list, &n, from, rookAttacks(from, pos->occupiedBB) & targets, enemy);
+	}
+
+	/* King */
+	int king = kingSquare(pos, us);
+	addPieceMoves(list, &n, king, kingAttacks[king] & targets, enemy);
+
+	/* Castling, Same Rules As validateKingMove(): Path Empty And King Never Passes Through Check */
+	if (!bCapturesOnly && pos->castling) {
+		int back = us ? 0 : 56;
+		int shortRight = us ? CASTLE_BLACK_SHORT : CASTLE_WHITE_SHORT;
+		int longRight = us ? CASTLE_BLACK_LONG : CASTLE_WHITE_LONG;
+
+		if ((pos->castling & shortRight) && !(pos->occupiedBB & (3ULL << (back + 5)))) {
+			if (!isSquareAttacked(pos, back + 4, them) && !isSquareAttacked(pos, back + 5, them)) {
+				list[n++] = encodeMove(back + 4, back + 6, KING_CASTLE);
+			}
+		}
+		if ((pos->castling & longRight) && !(pos->occupiedBB & (7ULL << (back + 1)))) {
+			if (!isSquareAttacked(pos, back + 4, them) && !isSquareAttacked(pos, back + 3, them)) {
+				list[n++] = encodeMove(back + 4, back + 2, QUEEN_CASTLE);
+			}
+		}
+	}
+
+	return n;
+}
+
+bool makeMove(const position_s* pos, position_s* next, move_t m) { /* Copy-Make, Returns False If The Move Leaves Our King In Check */
+
+	int from = moveFrom(m);
+	int to = moveTo(m);
+	int flag = moveFlag(m);
+	int us = pos->sideToMove;
+	int piece = pos->board[from];
+
+
+	*next = *pos;
+
+	if (next->epSquare >= 0) { next->key ^= zobristEp[next->epSquare & 7]; next->epSquare = -1; }
+	next->key ^= zobristCastle[next->castling];
+	next->halfmoveClock++;
+
+	if (flag == EN_PASSANT_CAPTURE) {
+		removePiece(next, to + (us ? -8 : 8));
+		next->halfmoveClock = 0;
+	}
+	else if (flag & CAPTURE) {
+		removePiece(next, to);
+		next->halfmoveClock = 0;
+	}
+	if (pieceType(piece) == PAWN) { next->halfmoveClock = 0; }
+
+	removePiece(next, from);
+	putPiece(next, (flag & PROMOTE_KNIGHT) ? makePiece(us, promotionType(m)) : piece, to);
+
+	if (flag == KING_CASTLE) {
+		removePiece(next, to + 1);
+		putPiece(next, makePiece(us, ROOK), to - 1);
+	}
+	else if (flag == QUEEN_CASTLE) {
+		removePiece(next, to - 2);
+		putPiece(next, makePiece(us, ROOK), to + 1);
+	}
+
+	next->castling &= castleMask[from] & castleMask[to];
+	next->key ^= zobristCastle[next->castling];
+
+	next->sideToMove = (unsigned char)(us ^ 1);
+	next->key ^= zobristSide;
+	if (us == 1) { next->fullmoveNumber++; }
+
+	if (flag == DOUBLE_PAWN_PUSH) { setEnPassantSquare(next, (from + to) >> 1); }
+
+	return !isSquareAttacked(next, kingSquare(next, us), us ^ 1);
+}
+
+void makeNullMove(const position_s* pos, position_s* next) {
+
+	*next = *pos;
+	if (next->epSquare >= 0) { next->key ^= zobristEp[next->epSquare & 7]; next->epSquare = -1; }
+	next->sideToMove ^= 1;
+	next->key ^= zobristSide;
+	next->halfmoveClock++;
+}
+
+bitboard_t pinnedPieces(const position_s* pos, int color) { /* Pieces Of color That Alone Stand Between Their King And An Enemy Slider */
+
+	int king = kingSquare(pos, color);
+	int them = color ^ 1;
+	bitboard_t kingBB = 1ULL << king;
+	bitboard_t pinned = 0;
+	bitboard_t rooks = rookAttacks(king, pos->colorBB[them]) & (pos->pieceBB[makePiece(them, ROOK)] | pos->pieceBB[makePiece(them, QUEEN)]);
+	bitboard_t bishops = bishopAttacks(king, pos->colorBB[them]) & (pos->pieceBB[makePiece(them, BISHOP)] | pos->pieceBB[makePiece(them, QUEEN)]);
+
+
+	while (rooks) {
+		int sq = popBit(&rooks);
+		bitboard_t between = rookAttacks(king, 1ULL << sq) & rookAttacks(sq, kingBB) & pos->occupiedBB;
+		if (bitCount(between) == 1) { pinned |= between & pos->colorBB[color]; }
+	}
+	while (bishops) {
+		int sq = popBit(&bishops);
+		bitboard_t between = bishopAttacks(king, 1ULL << sq) & bishopAttacks(sq, kingBB) & pos->occupiedBB;
+		if (bitCount(between) == 1) { pinned |= between & pos->colorBB[color]; }
+	}
+	return pinned;
+}
+
+int generateLegalMoves(const position_s* pos, move_t* list) {
+
+	move_t pseudo[MAX_MOVES_MACRO];
+	position_s next;
+	int count = generateMoves(pos, pseudo, false);
+	int n = 0;
+	int king = kingSquare(pos, pos->sideToMove);
+	bitboard_t pinned = pinnedPieces(pos, pos->sideToMove);
+	bool bCheck = inCheck(pos);
+
+
+	/* Out Of Check, A Move That Is Not By The King, A Pinned Piece Or En Passant Cannot Expose The King */
+	for (int i = 0; i < count; i++) {
+		int from = moveFrom(pseudo[i]);
+		int flag = moveFlag(pseudo[i]);
+		if (from == king && flag != KING_CASTLE && flag != QUEEN_CASTLE) { /* The King Itself Must Not Block The Ray It Steps Along */
+			if (!isSquareAttackedThrough(pos, moveTo(pseudo[i]), pos->sideToMove ^ 1, pos->occupiedBB ^ (1ULL << king))) { list[n++] = pseudo[i]; }
+		}
+		else if (!bCheck && from != king && !((pinned >> from) & 1) && flag != EN_PASSANT_CAPTURE) { list[n++] = pseudo[i]; }
+		else if (makeMove(pos, &next, pseudo[i])) { list[n++] = pseudo[i]; }
+	}
+	return n;
+}
+
+move_t parseUCIMove(const position_s* pos, const char* str) { /* Returns 0 If It Isn't A Legal Move */
+
+	move_t list[MAX_MOVES_MACRO];
+	char buffer[6];
+	int n = generateLegalMoves(pos, list);
+
+
+	for (int i = 0; i < n; i++) {
+		moveToUCI(list[i], buffer);
+		if (!strcmp(buffer, str)) { return list[i]; }
+	}
+	return 0;
+}
+
+bitboard_t pieceAttacksTo(const position_s* pos, int type, int sq) { /* Where A Piece Of This Type Has To Stand To Reach sq, Not For Pawns */
+
+	switch (type) {
+	case(KNIGHT): return knightAttacks[sq];
+	case(BISHOP): return bishopAttacks(sq, pos->occupiedBB);
+	case(ROOK):   return rookAttacks(sq, pos->occupiedBB);
+	case(QUEEN):  return bishopAttacks(sq, pos->occupiedBB) | rookAttacks(sq, pos->occupiedBB);
+	case(KING):   return kingAttacks[sq];
+	}
+	return 0;
+}
+
+bool hasLegalMove(const position_s* pos) { /* Stops At The First One, King Steps First As They Are The Usual Way Out Of Check */
+
+	move_t list[MAX_MOVES_MACRO];
+	position_s next;
+	int us = pos->sideToMove;
+	int king = kingSquare(pos, us);
+	bitboard_t targets = kingAttacks[king] & ~pos->colorBB[us];
+
+
+	while (targets) {
+		int to = popBit(&targets);
+		if (makeMove(pos, &next, encodeMove(king, to, ((pos->occupiedBB >> to) & 1) ? CAPTURE : QUIET_MOVE))) { return true; }
+	}
+
+	int n = generateMoves(pos, list, false);
+	for (int i = 0; i < n; i++) {
+		if (makeMove(pos, &next, list[i])) { return true; }
+	}
+	return false;
+}
+
+move_t parseSAN(const position_s* pos, const char* san, size_t length) { /* Returns 0 If It Isn't Exactly One Legal Move, Only Pieces Attacking The Destination Are Tried */
+
+	position_s next;
+	int us = pos->sideToMove;
+	int them = us ^ 1;
+	int type = PAWN;
+	int promotion = 0;
+	int fromFile = -1;
+	int fromRank = -1;
+	move_t found = 0;
+
+
+	/* Check, Mate And Annotation Suffixes Carry No Information We Need */
+	while (length && (san[length - 1] == '+' || san[length - 1] == '#' || san[length - 1] == '!' || san[length - 1] == '?')) { length--; }
+	if (length < 2) { return 0; }
+
+	/* Castling, Same Rules As generateMoves() */
+	if (san[0] == 'O' || san[0] == '0') {
+		bool bLong = length >= 5;
+		int back = us ? 0 : 56;
+		int right = us ? (bLong ? CASTLE_BLACK_LONG : CASTLE_BLACK_SHORT) : (bLong ? CASTLE_WHITE_LONG : CASTLE_WHITE_SHORT);
+		bitboard_t path = bLong ? 7ULL << (back + 1) : 3ULL << (back + 5);
+
+		if (!(pos->castling & right) || (pos->occupiedBB & path)) { return 0; }
+		if (isSquareAttacked(pos, back + 4, them) || isSquareAttacked(pos, bLong ? back + 3 : back + 5, them)) { return 0; }
+		move_t m = encodeMove(back + 4, bLong ? back + 2 : back + 6, bLong ? QUEEN_CASTLE : KING_CASTLE);
+		return makeMove(pos, &next, m) ? m : 0;
+	}
+
+	const char* p = san;
+	const char* end = san + length;
+	switch (*p) {
+	case('N'): type = KNIGHT; p++; break;
+	case('B'): type = BISHOP; p++; break;
+	case('R'): type = ROOK;   p++; break;
+	case('Q'): type = QUEEN;  p++; break;
+	case('K'): type = KING;   p++; break;
+	}
+
+	/* Promotion At The End, With Or Without The = */
+	if (type == PAWN && end - p >= 3 && (end[-1] == 'N' || end[-1] == 'B' || end[-1] == 'R' || end[-1] == 'Q')) {
+		promotion = end[-1] == 'N' ? KNIGHT : end[-1] == 'B' ? BISHOP : end[-1] == 'R' ? ROOK : QUEEN;
+		end--;
+		if (end[-1] == '=') { end--; }
+	}
+
+	/* Destination Is Always The Last Square, Anything Before It Disambiguates */
+	if (end - p < 2 || end[-2] < 'a' || end[-2] > 'h' || end[-1] < '1' || end[-1] > '8') { return 0; }
+	int to = ('8' - end[-1]) * 8 + (end[-2] - 'a');
+	for (const char* q = p; q < end - 2; q++) {
+		if (*q >= 'a' && *q <= 'h') { fromFile = *q - 'a'; }
+		else if (*q >= '1' && *q <= '8') { fromRank = '8' - *q; }
+		else if (*q != 'x' && *q != '-') { return 0; }
+	}
+	if ((pos->colorBB[us] >> to) & 1) { return 0; }
+
+	bitboard_t ours = pos->pieceBB[makePiece(us, type)];
+	bitboard_t candidates;
+	int flag = ((pos->occupiedBB >> to) & 1) ? CAPTURE : QUIET_MOVE;
+
+	if (type == PAWN) {
+		int push = us ? 8 : -8;
+		int row = to >> 3;
+
+		if (((row == (us ? 7 : 0)) ? 1 : 0) != (promotion ? 1 : 0)) { return 0; }
+
+		if (fromFile >= 0 && fromFile != (to & 7)) { /* Pawn Captures Always Name Their File */
+			candidates = pawnAttacks[them][to] & ours;
+			if (to == pos->epSquare) { flag = EN_PASSANT_CAPTURE; }
+			else if (flag != CAPTURE) { return 0; }
+		}
+		else {
+			int from = to - push;
+			if (flag == CAPTURE || from < 0 || from > 63) { return 0; }
+			candidates = ours & (1ULL << from);
+
+			/* Double Push Only From The Start Row, Over An Empty Square */
+			if (!candidates && !((pos->occupiedBB >> from) & 1) && row == (us ? 3 : 4)) {
+				candidates = ours & (1ULL << (from - push));
+				flag = DOUBLE_PAWN_PUSH;
+			}
+		}
+		if (promotion) { flag |= PROMOTE_KNIGHT + promotion - KNIGHT; }
+	}
+	else {
+		candidates = pieceAttacksTo(pos, type, to) & ours;
+	}
+
+	if (fromFile >= 0) { candidates &= 0x0101010101010101ULL << fromFile; }
+	if (fromRank >= 0) { candidates &= 0xFFULL << (fromRank * 8); }
+
+	/* Usually One Candidate, More Only When A Pinned Piece Or Missing Disambiguation Is Involved */
+	while (candidates) {
+		move_t m = encodeMove(popBit(&candidates), to, flag);
+		if (!makeMove(pos, &next, m)) { continue; }
+		if (found) { return 0; } /* Ambiguous */
+		found = m;
+	}
+	return found;
+}
+
+int moveToSAN(const position_s* pos, move_t m, char* str) { /* Needs Room For 8 Chars, Returns The Length */
+
+	position_s next;
+	int from = moveFrom(m);
+	int to = moveTo(m);
+	int flag = moveFlag(m);
+	int type = pieceType(pos->board[from]);
+	char* p = str;
+
+
+	if (flag == KING_CASTLE)       { memcpy(p, "O-O", 3);   p += 3; }
+	else if (flag == QUEEN_CASTLE) { memcpy(p, "O-O-O", 5); p += 5; }
+	else {
+		if (type == PAWN) {
+			if (isCaptureMove(m)) { *p++ = (char)('a' + (from & 7)); }
+		}
+		else {
+			*p++ = " PNBRQK"[type];
+
+			/* Other Pieces Of The Same Kind That Reach To, Pinned Ones Do Not Count */
+			bitboard_t others = pieceAttacksTo(pos, type, to) & pos->pieceBB[pos->board[from]] & ~(1ULL << from);
+			bitboard_t rivals = 0;
+			while (others) {
+				int sq = popBit(&others);
+				if (makeMove(pos, &next, encodeMove(sq, to, flag))) { rivals |= 1ULL << sq; }
+			}
+			if (rivals) {
+				if (!(rivals & (0x0101010101010101ULL << (from & 7)))) { *p++ = (char)('a' + (from & 7)); }
+				else if (!(rivals & (0xFFULL << (from & 56))))       { *p++ = (char)('8' - (from >> 3)); }
+				else { *p++ = (char)('a' + (from & 7)); *p++ = (char)('8' - (from >> 3)); }
+			}
+		}
+		if (isCaptureMove(m)) { *p++ = 'x'; }
+		*p++ = (char)('a' + (to & 7));
+		*p++ = (char)('8' - (to >> 3));
+		if (isPromotionMove(m)) { *p++ = '='; *p++ = " PNBRQK"[promotionType(m)]; }
+	}
+
+	/* Mate Only Needs One Legal Reply To Be Ruled Out */
+	if (makeMove(pos, &next, m) && inCheck(&next)) { *p++ = hasLegalMove(&next) ? '+' : '#'; }
+	*p = '\0';
+	return (int)(p - str);
+}
+
+bool isInsufficientMaterial(const position_s* pos) { /* K v K, K+N v K, K+B v K */
+
+	bitboard_t heavy = pos->pieceBB[WHITE_PAWN] | pos->pieceBB[BLACK_PAWN] | pos->pieceBB[WHITE_ROOK] |
+	                   pos->pieceBB[BLACK_ROOK] | pos->pieceBB[WHITE_QUEEN] | pos->pieceBB[BLACK_QUEEN];
+
+
+	if (heavy) { return false; }
+	return bitCount(pos->occupiedBB) <= 3;
+}
+
+unsigned long long perft(const position_s* pos, int depth) {
+
+	move_t list[MAX_MOVES_MACRO];
+	position_s next;
+	unsigned long long nodes = 0;
+	int n = generateMoves(pos, list, false);
+
+
+	for (int i = 0; i < n; i++) {
+		if (!makeMove(pos, &next, list[i])) { continue; }
+		nodes += (depth > 1) ? perft(&next, depth - 1) : 1;
+	}
+	return nodes;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Engine -- Evaluation                                                                                            *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+/* Tables Are Written From White's Side With Rank 8 On Top, Which Is Our Square Order, Black Reads Them Mirrored (sq ^ 56) */
+/* jonochess --tune Writes evalweights.h With The Same Names, Once It Is Next To This File It Replaces The Hand Written Tables Below */
+#if defined(__has_include)
+#if __has_include("evalweights.h")
+#define TUNED_EVAL_WEIGHTS
+#endif
+#endif
+
+#ifdef TUNED_EVAL_WEIGHTS
+#include "evalweights.h"
+#else
+int pieceValueMG[6] = { 82, 337, 365, 477, 1025, 0 };
+int pieceValueEG[6] = { 94, 281, 297, 512,  936, 0 };
+
+int pieceSquareMG[6][64] = {
+	{   0,   0,   0,   0,   0,   0,   0,   0,
+	   50,  50,  50,  50,  50,  50,  50,  50,
+	   10,  10,  20,  30,  30,  20,  10,  10,
+	    5,   5,  10,  25,  25,  10,   5,   5,
+	    0,   0,   0,  20,  20,   0,   0,   0,
+	    5,  -5, -10,   0,   0, -10,  -5,   5,
+	    5,  10,  10, -20, -20,  10,  10,   5,
+	    0,   0,   0,   0,   0,   0,   0,   0 },
+	{ -50, -40, -30, -30, -30, -30, -40, -50,
+	  -40, -20,   0,   0,   0,   0, -20, -40,
+	  -30,   0,  10,  15,  15,  10,   0, -30,
+	  -30,   5,  15,  20,  20,  15,   5, -30,
+	  -30,   0,  15,  20,  20,  15,   0, -30,
+	  -30,   5,  10,  15,  15,  10,   5, -30,
+	  -40, -20,   0,   5,   5,   0, -20, -40,
+	  -50, -40, -30, -30, -30, -30, -40, -50 },
+	{ -20, -10, -10, -10, -10, -10, -10, -20,
+	  -10,   0,   0,   0,   0,   0,   0, -10,
+	  -10,   0,   5,  10,  10,   5,   0, -10,
+	  -10,   5,   5,  10,  10,   5,   5, -10,
+	  -10,   0,  10,  10,  10,  10,   0, -10,
+	  -10,  10,  10,  10,  10,  10,  10, -10,
+	  -10,   5,   0,   0,   0,   0,   5, -10,
+	  -20, -10, -10, -10, -10, -10, -10, -20 },
+	{   0,   0,   0,   0,   0,   0,   0,   0,
+	    5,  10,  10,  10,  10,  10,  10,   5,
+	   -5,   0,   0,   0,   0,   0,   0,  -5,
+	   -5,   0,   0,   0,   0,   0,   0,  -5,
+	   -5,   0,   0,   0,   0,   0,   0,  -5,
+	   -5,   0,   0,   0,   0,   0,   0,  -5,
+	   -5,   0,   0,   0,   0,   0,   0,  -5,
+	    0,   0,   0,   5,   5,   0,   0,   0 },
+	{ -20, -10, -10,  -5,  -5, -10, -10, -20,
+	  -10,   0,   0,   0,   0,   0,   0, -10,
+	  -10,   0,   5,   5,   5,   5,   0, -10,
+	   -5,   0,   5,   5,   5,   5,   0,  -5,
+	    0,   0,   5,   5,   5,   5,   0,  -5,
+	  -10,   5,   5,   5,   5,   5,   0, -10,
+	  -10,   0,   5,   0,   0,   0,   0, -10,
+	  -20, -10, -10,  -5,  -5, -10, -10, -20 },
+	{ -30, -40, -40, -50, -50, -40, -40, -30,
+	  -30, -40, -40, -50, -50, -40, -40, -30,
+	  -30, -40, -40, -50, -50, -40, -40, -30,
+	  -30, -40, -40, -50, -50, -40, -40, -30,
+	  -20, -30, -30, -40, -40, -30, -30, -20,
+	  -10, -20, -20, -20, -20, -20, -20, -10,
+	   20,  20,   0,   0,   0,   0,  20,  20,
+	   20,  30,  10,   0,   0,  10,  30,  20 }
+};
+
+int pieceSquareEG[6][64] = {
+	{   0,   0,   0,   0,   0,   0,   0,   0,
+	   80,  80,  80,  80,  80,  80,  80,  80,
+	   50,  50,  50,  50,  50,  50,  50,  50,
+	   30,  30,  30,  30,  30,  30,  30,  30,
+	   20,  20,  20,  20,  20,  20,  20,  20,
+	   10,  10,  10,  10,  10,  10,  10,  10,
+	    5,   5,   5,   5,   5,   5,   5,   5,
+	    0,   0,   0,   0,   0,   0,   0,   0 },
+	{ -50, -40, -30, -30, -30, -30, -40, -50,
+	  -40, -20,   0,   0,   0,   0, -20, -40,
+	  -30,   0,  10,  15,  15,  10,   0, -30,
+	  -30,   5,  15,  20,  20,  15,   5, -30,
+	  -30,   0,  15,  20,  20,  15,   0, -30,
+	  -30,   5,  10,  15,  15,  10,   5, -30,
+	  -40, -20,   0,   5,   5,   0, -20, -40,
+	  -50, -40, -30, -30, -30, -30, -40, -50 },
+	{ -20, -10, -10, -10, -10, -10, -10, -20,
+	  -10,   0,   0,   0,   0,   0,   0, -10,
+	  -10,   0,   5,  10,  10,   5,   0, -10,
+	  -10,   5,   5,  10,  10,   5,   5, -10,
+	  -10,   0,  10,  10,  10,  10,   0, -10,
+	  -10,  10,  10,  10,  10,  10,  10, -10,
+	  -10,   5,   0,   0,   0,   0,   5, -10,
+	  -20, -10, -10, -10, -10, -10, -10, -20 },
+	{   0,   0,   0,   0,   0,   0,   0,   0,
+	   10,  10,  10,  10,  10,  10,  10,  10,
+	    0,   0,   0,   0,   0,   0,   0,   0,
+	    0,   0,   0,   0,   0,   0,   0,   0,
+	    0,   0,   0,   0,   0,   0,   0,   0,
+	    0,   0,   0,   0,   0,   0,   0,   0,
+	    0,   0,   0,   0,   0,   0,   0,   0,
+	    0,   0,   0,   0,   0,   0,   0,   0 },
+	{ -20, -10, -10,  -5,  -5, -10, -10, -20,
+	  -10,   0,   0,   0,   0,   0,   0, -10,
+	  -10,   0,   5,   5,   5,   5,   0, -10,
+	   -5,   0,   5,   5,   5,   5,   0,  -5,
+	   -5,   0,   5,   5,   5,   5,   0,  -5,
+	  -10,   0,   5,   5,   5,   5,   0, -10,
+	  -10,   0,   0,   0,   0,   0,   0, -10,
+	  -20, -10, -10,  -5,  -5, -10, -10, -20 },
+	{ -50, -40, -30, -20, -20, -30, -40, -50,
+	  -30, -20, -10,   0,   0, -10, -20, -30,
+	  -30, -10,  20,  30,  30,  20, -10, -30,
+	  -30, -10,  30,  40,  40,  30, -10, -30,
+	  -30, -10,  30,  40,  40,  30, -10, -30,
+	  -30, -10,  20,  30,  30,  20, -10, -30,
+	  -30, -30,   0,   0,   0,   0, -30, -30,
+	  -50, -30, -30, -30, -30, -30, -30, -50 }
+};
+#endif
+
+const int phaseWeight[7] = { 0, 0, 1, 1, 2, 4, 0 }; /* Indexed By pieceType_e, 24 Means All Pieces Are On The Board */
+
+int evalTableMG[13][64]; /* Material Plus Piece Square Bonus, Indexed By chessPiece_e */
+int evalTableEG[13][64];
+
+
+void initEvaluation(void) {
+
+	for (int type = PAWN; type <= KING; type++) {
+		for (int sq = 0; sq < 64; sq++) {
+			evalTableMG[makePiece(0, type)][sq] = pieceValueMG[type - 1] + pieceSquareMG[type - 1][sq];
+			evalTableEG[makePiece(0, type)][sq] = pieceValueEG[type - 1] + pieceSquareEG[type - 1][sq];
+			evalTableMG[makePiece(1, type)][sq] = pieceValueMG[type - 1] + pieceSquareMG[type - 1][sq ^ 56];
+			evalTableEG[makePiece(1, type)][sq] = pieceValueEG[type - 1] + pieceSquareEG[type - 1][sq ^ 56];
+		}
+	}
+}
+
+int evaluate(const position_s* pos) { /* Tapered Score In Centipawns From The Side To Move's Point Of View */
+
+	int mg[2] = { 0, 0 };
+	int eg[2] = { 0, 0 };
+	int phase = 0;
+
+
+	for (int piece = WHITE_PAWN; piece <= BLACK_KING; piece++) {
+		bitboard_t bb = pos->pieceBB[piece];
+		int color = pieceColor(piece);
+
+		while (bb) {
+			int sq = popBit(&bb);
+			mg[color] += evalTableMG[piece][sq];
+			eg[color] += evalTableEG[piece][sq];
+			phase += phaseWeight[pieceType(piece)];
+		}
+	}
+	if (phase > 24) { phase = 24; } /* Early Promotions */
+
+	int score = ((mg[0] - mg[1]) * phase + (eg[0] - eg[1]) * (24 - phase)) / 24;
+
+	return pos->sideToMove ? -score : score;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Engine -- Transposition Table                                                                                   *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+enum ttBound_e {
+
+	BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT
+};
+
+struct ttEntry_s { /* Check Is key ^ data, So A Torn Write From Another Thread Just Looks Like A Miss */
+
+	unsigned long long check;
+	unsigned long long data; /* Move 0-15, Score 16-31, Eval 32-47, Depth 48-55, Bound 56-57, Generation 58-63 */
+};
+
+struct transTable_s {
+
+	ttEntry_s* entries = NULL;
+	unsigned long long mask = 0;
+	unsigned char generation = 0;
+	size_t sizeMB = 0;
+};
+
+struct ttHit_s {
+
+	move_t move;
+	int score;
+	int eval;
+	int depth;
+	int bound;
+};
+
+
+void ttResize(transTable_s* tt, size_t sizeMB) {
+
+	unsigned long long count = 1;
+
+
+	/* Largest Power Of Two That Fits, So The Index Is A Single Mask */
+	while (count * 2 * sizeof(ttEntry_s) <= (unsigned long long)sizeMB << 20) { count *= 2; }
+
+	free(tt->entries);
+	tt->entries = (ttEntry_s*)calloc((size_t)count, sizeof(ttEntry_s));
+	if (tt->entries == NULL) { fputs("Memory error", stderr); exit(2); }
+
+	tt->mask = count - 1;
+	tt->generation = 0;
+	tt->sizeMB = sizeMB;
+}
+
+void ttNewSearch(transTable_s* tt) { /* Entries Of Older Generations Are Replaced First, Callers Sharing A Table Serialize This */
+
+	tt->generation = (tt->generation + 1) & 63;
+}
+
+void ttClear(transTable_s* tt) {
+
+	memset(tt->entries, 0, (size_t)(tt->mask + 1) * sizeof(ttEntry_s));
+	tt->generation = 0;
+}
+
+void ttFree(transTable_s* tt) {
+
+	free(tt->entries); tt->entries = NULL;
+	tt->mask = 0;
+}
+
+bool ttProbe(const transTable_s* tt, unsigned long long key, ttHit_s* hit) {
+
+	const ttEntry_s* entry = &tt->entries[key & tt->mask];
+	unsigned long long data = entry->data;
+
+
+	if ((entry->check ^ data) != key) { return false; }
+
+	hit->move  = (move_t)(data & 0xffff);
+	hit->score = (short)((data >> 16) & 0xffff);
+	hit->eval  = (short)((data >> 32) & 0xffff);
+	hit->depth = (int)((data >> 48) & 0xff);
+	hit->bound = (int)((data >> 56) & 3);
+	return true;
+}
+
+void ttStore(transTable_s* tt, unsigned long long key, move_t move, int score, int eval, int depth, int bound) {
+
+	ttEntry_s* entry = &tt->entries[key & tt->mask];
+	unsigned long long old = entry->data;
+	bool bSameKey = (entry->check ^ old) == key;
+
+
+	/* Keep Deeper Entries From This Search Unless The New One Is Exact */
+	if (bSameKey && move == 0) { move = (move_t)(old & 0xffff); }
+	if (old != 0 && (old >> 58) == tt->generation && bound != BOUND_EXACT && depth + 2 < (int)((old >> 48) & 0xff)) { return; }
+	if (depth < 0) { depth = 0; }
+
+	unsigned long long data = (unsigned long long)move | ((unsigned long long)(unsigned short)(short)score << 16) |
+	                          ((unsigned long long)(unsigned short)(short)eval << 32) | ((unsigned long long)depth << 48) |
+	                          ((unsigned long long)bound << 56) | ((unsigned long long)tt->generation << 58);
+
+	entry->check = key ^ data;
+	entry->data = data;
+}
+
+int ttHashfull(const transTable_s* tt) { /* Permill Of Entries Written During The Current Search, UCI Style */
+
+	int used = 0;
+	unsigned long long samples = tt->mask + 1 < 1000 ? tt->mask + 1 : 1000;
+
+
+	for (unsigned long long i = 0; i < samples; i++) {
+		unsigned long long data = tt->entries[i].data;
+		if (data != 0 && (data >> 58) == tt->generation) { used++; }
+	}
+	return (int)(used * 1000 / samples);
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Engine -- Search                                                                                                *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+enum searchScore_e {
+
+	DRAW_SCORE = 0,
+	MATE_SCORE = 32000,
+	MATE_BOUND_SCORE = MATE_SCORE - MAX_PLY_MACRO, /* Anything Above Is A Forced Mate */
+	INFINITE_SCORE = 32001
+};
+
+struct searchLimits_s {
+
+	int depth = 0;                /* 0 For No Limit */
+	unsigned long long nodes = 0; /* 0 For No Limit */
+	int movetime = 0;             /* Milliseconds, 0 For No Limit */
+	int time[2] = { 0, 0 };       /* Remaining Clock For White And Black */
+	int inc[2] = { 0, 0 };
+	int movestogo = 0;
+	bool infinite = false;        /* Keep Searching Until Stopped */
+};
+
+struct searchInfo_s { /* Handed To The Info Callback Every Time A Root Line Finishes, So Results Stream In Per Depth */
+
+	int multipv;  /* 1 Is The Best Line */
+	int depth;
+	int seldepth;
+	int score;
+	unsigned long long nodes;
+	unsigned long long nps;
+	unsigned int timeMs;
+	int hashfull;
+	int pvLength;
+	move_t pv[MAX_PLY_MACRO];
+};
+
+typedef void (*searchInfoCallback_t)(const searchInfo_s* info, void* user);
+
+struct searchLine_s {
+
+	int score;
+	int depth;
+	int seldepth;
+	int pvLength;
+	move_t pv[MAX_PLY_MACRO];
+};
+
+struct searchStats_s { /* Plain Per-Thread Counters, All unsigned long long So They Can Be Summed As An Array */
+
+	unsigned long long nodes;
+	unsigned long long qnodes;
+	unsigned long long ttProbes;
+	unsigned long long ttHits;
+	unsigned long long ttCutoffs;
+	unsigned long long betaCutoffs;
+	unsigned long long firstMoveCutoffs;
+	unsigned long long nullMovePrunes;
+	unsigned long long futilityPrunes;
+	unsigned long long razorPrunes;
+	unsigned long long lmrReductions;
+	unsigned long long lmrResearches;
+};
+
+struct searchDepthStats_s { /* Snapshot Taken When An Iteration Completes, Counters Are Totals Since The Search Started */
+
+	int depth;
+	unsigned int timeMs;
+	unsigned long long iterationNodes;
+	double branchingFactor;  /* Nodes Of This Iteration Over Nodes Of The Previous One */
+	double firstMoveCutoffRate;
+	double ttHitRate;
+	searchStats_s total;
+};
+
+typedef void (*searchIterationCallback_t)(const searchDepthStats_s* stats, void* user);
+
+struct searchFeatures_s { /* Every Selective Technique Can Be Switched Off To Measure What It Buys */
+
+	bool bNullMove = true;
+	bool bLMR = true;
+	bool bFutility = true;
+	bool bRazoring = true;
+	bool bCheckExtension = true;
+	bool bAspiration = true;
+};
+
+unsigned char lmrTable[64][64]; /* [depth][move number], Filled By initSearch() */
+
+struct searchEngine_s;
+
+struct searchWorker_s {
+
+	searchEngine_s* engine;
+	int id;
+	HANDLE thread;
+	unsigned long long nodes;
+	searchStats_s stats; /* Only This Thread Writes, No Atomics On The Hot Path */
+	int seldepth;
+	int completedDepth;
+	int bestScore;
+	move_t killers[MAX_PLY_MACRO][2];
+	int history[13][64];
+	int pvLength[MAX_PLY_MACRO];
+	move_t pv[MAX_PLY_MACRO][MAX_PLY_MACRO];
+	move_t rootPv[MAX_PLY_MACRO];
+	int rootPvLength;
+	move_t excludedRoot[MAX_MULTIPV_MACRO]; /* Root Moves Already Taken By Earlier MultiPV Lines */
+	int excludedCount;
+	unsigned long long keyStack[MAX_GAME_PLY_MACRO + MAX_PLY_MACRO]; /* Game History Followed By The Current Search Line */
+	int keyCount;
+};
+
+struct searchEngine_s {
+
+	transTable_s* tt = NULL;
+	bool bOwnsTT = false;
+	int numThreads = 0;
+	searchWorker_s* workers = NULL;
+	volatile LONG bStop = 0;
+	searchLimits_s limits;
+	position_s rootPos;
+	unsigned long long gameKeys[MAX_GAME_PLY_MACRO];
+	int gameKeyCount = 0;
+	DWORD startTime = 0;
+	DWORD softTimeMs = 0;
+	DWORD hardTimeMs = 0;
+	bool bTimeLimited = false;
+	searchInfoCallback_t onInfo = NULL;
+	void* onInfoUser = NULL;
+	int multiPV = 1;
+	searchFeatures_s features;
+	int rootMoveCount = 0;
+	searchLine_s lines[MAX_MULTIPV_MACRO]; /* Latest Result For Each MultiPV Line, Best First */
+	int lineCount = 0;
+	searchIterationCallback_t onIteration = NULL;
+	void* onIterationUser = NULL;
+	searchDepthStats_s depthStats[MAX_PLY_MACRO]; /* Indexed By Depth, Only Completed Iterations Are Filled In */
+	int lastStatsDepth = 0;
+	move_t bestMove = 0;
+	move_t ponderMove = 0;
+	int bestScore = 0;
+};
+
+
+void initSearch(void) { /* Reductions Grow With The Log Of Both Depth And Move Number */
+
+	for (int d = 0; d < 64; d++) {
+		for (int m = 0; m < 64; m++) {
+			lmrTable[d][m] = (d && m) ? (unsigned char)(0.75 + log((double)d) * log((double)m) / 2.25) : 0;
+		}
+	}
+}
+
+void searchSetThreads(searchEngine_s* engine, int numThreads) {
+
+	if (numThreads < 1) { numThreads = 1; }
+	free(engine->workers);
+	engine->workers = (searchWorker_s*)calloc(numThreads, sizeof(searchWorker_s));
+	if (engine->workers == NULL) { fputs("Memory error", stderr); exit(2); }
+
+	for (int i = 0; i < numThreads; i++) {
+		engine->workers[i].engine = engine;
+		engine->workers[i].id = i;
+	}
+	engine->numThreads = numThreads;
+}
+
+void searchInit(searchEngine_s* engine, transTable_s* sharedTT, size_t hashMB, int numThreads) { /* Pass A sharedTT To Let Several Engines Use One Table */
+
+	if (sharedTT != NULL) {
+		engine->tt = sharedTT;
+		engine->bOwnsTT = false;
+	}
+	else {
+		engine->tt = (transTable_s*)calloc(1, sizeof(transTable_s));
+		if (engine->tt == NULL) { fputs("Memory error", stderr); exit(2); }
+		ttResize(engine->tt, hashMB);
+		engine->bOwnsTT = true;
+	}
+	searchSetThreads(engine, numThreads);
+}
+
+void searchFree(searchEngine_s* engine) {
+
+	if (engine->bOwnsTT) { ttFree(engine->tt); free(engine->tt); }
+	engine->tt = NULL;
+	free(engine->workers); engine->workers = NULL;
+	engine->numThreads = 0;
+}
+
+void searchClearHistory(searchEngine_s* engine) { /* New Game, Forget Everything Learned About The Old One */
+
+	for (int i = 0; i < engine->numThreads; i++) {
+		memset(engine->workers[i].history, 0, sizeof(engine->workers[i].history));
+	}
+	ttClear(engine->tt);
+}
+
+bool searchSetOption(searchEngine_s* engine, const char* name, const char* value) { /* UCI Option Names, Shared With --match, Returns false If Unknown */
+
+	bool bOn = !_stricmp(value, "true");
+
+
+	if (!_stricmp(name, "Hash")) {
+		int mb = atoi(value);
+		if (mb < 1) { mb = 1; }
+		ttResize(engine->tt, (size_t)mb);
+	}
+	else if (!_stricmp(name, "Threads")) {
+		int threads = atoi(value);
+		if (threads < 1) { threads = 1; }
+		if (threads > 256) { threads = 256; }
+		searchSetThreads(engine, threads);
+	}
+	else if (!_stricmp(name, "MultiPV")) {
+		int lines = atoi(value);
+		if (lines < 1) { lines = 1; }
+		if (lines > MAX_MULTIPV_MACRO) { lines = MAX_MULTIPV_MACRO; }
+		engine->multiPV = lines;
+	}
+	else if (!_stricmp(name, "NullMove"))       { engine->features.bNullMove = bOn; }
+	else if (!_stricmp(name, "LMR"))            { engine->features.bLMR = bOn; }
+	else if (!_stricmp(name, "Futility"))       { engine->features.bFutility = bOn; }
+	else if (!_stricmp(name, "Razoring"))       { engine->features.bRazoring = bOn; }
+	else if (!_stricmp(name, "CheckExtension")) { engine->features.bCheckExtension = bOn; }
+	else if (!_stricmp(name, "Aspiration"))     { engine->features.bAspiration = bOn; }
+	else { return false; }
+	return true;
+}
+
+void mergeSearchStats(searchEngine_s* engine, int depth) { /* Main Worker Only, At The End Of Each Iteration */
+
+	searchDepthStats_s* out = &engine->depthStats[depth];
+	unsigned long long* total = (unsigned long long*)&out->total;
+	const int fields = sizeof(searchStats_s) / sizeof(unsigned long long);
+	unsigned long long previousNodes = 0;
+	unsigned long long previousIteration = 0;
+
+
+	memset(out, 0, sizeof(searchDepthStats_s));
+	for (int i = 0; i < engine->numThreads; i++) {
+		const unsigned long long* counters = (const unsigned long long*)&engine->workers[i].stats;
+		for (int f = 0; f < fields; f++) { total[f] += counters[f]; }
+		out->total.nodes += engine->workers[i].nodes;
+	}
+
+	if (engine->lastStatsDepth > 0) {
+		previousNodes = engine->depthStats[engine->lastStatsDepth].total.nodes;
+		previousIteration = engine->depthStats[engine->lastStatsDepth].iterationNodes;
+	}
+
+	out->depth = depth;
+	out->timeMs = timeGetTime() - engine->startTime;
+	out->iterationNodes = out->total.nodes - previousNodes;
+	out->branchingFactor = previousIteration ? (double)out->iterationNodes / previousIteration : 0.0;
+	out->firstMoveCutoffRate = out->total.betaCutoffs ? (double)out->total.firstMoveCutoffs / out->total.betaCutoffs : 0.0;
+	out->ttHitRate = out->total.ttProbes ? (double)out->total.ttHits / out->total.ttProbes : 0.0;
+	engine->lastStatsDepth = depth;
+
+	if (engine->onIteration != NULL) { engine->onIteration(out, engine->onIterationUser); }
+}
+
+int formatSearchStats(char* str, const searchDepthStats_s* stats) { /* One Line, Shared By UCI And The GUI Console */
+
+	const searchStats_s* t = &stats->total;
+
+
+	return sprintf(str, "depth %d time %u nodes %llu qnodes %llu ebf %.2f ttprobes %llu tthits %llu (%.1f%%) ttcuts %llu "
+		"cutoffs %llu firstmove %.1f%% nullprunes %llu futility %llu razor %llu lmr %llu lmrresearch %llu",
+		stats->depth, stats->timeMs, t->nodes, t->qnodes, stats->branchingFactor, t->ttProbes, t->ttHits, stats->ttHitRate * 100.0,
+		t->ttCutoffs, t->betaCutoffs, stats->firstMoveCutoffRate * 100.0, t->nullMovePrunes, t->futilityPrunes, t->razorPrunes,
+		t->lmrReductions, t->lmrResearches);
+}
+
+void writeSearchStatsJSON(FILE* FHDL, const searchEngine_s* engine) { /* One JSON Object Per Search, One Per Line */
+
+	char move[6];
+
+
+	moveToUCI(engine->bestMove, move);
+	fprintf(FHDL, "{\"bestmove\":\"%s\",\"score\":%d,\"depths\":[", move, engine->bestScore);
+
+	for (int d = 1, first = 1; d <= engine->lastStatsDepth; d++) {
+		const searchDepthStats_s* s = &engine->depthStats[d];
+		const searchStats_s* t = &s->total;
+		if (s->depth != d) { continue; }
+
+		fprintf(FHDL, "%s{\"depth\":%d,\"time_ms\":%u,\"nodes\":%llu,\"iteration_nodes\":%llu,\"qnodes\":%llu,\"ebf\":%.3f,"
+			"\"tt_probes\":%llu,\"tt_hits\":%llu,\"tt_cutoffs\":%llu,\"beta_cutoffs\":%llu,\"first_move_cutoffs\":%llu,"
+			"\"first_move_cutoff_rate\":%.4f,\"null_move_prunes\":%llu,\"futility_prunes\":%llu,\"razor_prunes\":%llu,"
+			"\"lmr_reductions\":%llu,\"lmr_researches\":%llu}",
+			first ? "" : ",", d, s->timeMs, t->nodes, s->iterationNodes, t->qnodes, s->branchingFactor,
+			t->ttProbes, t->ttHits, t->ttCutoffs, t->betaCutoffs, t->firstMoveCutoffs, s->firstMoveCutoffRate,
+			t->nullMovePrunes, t->futilityPrunes, t->razorPrunes, t->lmrReductions, t->lmrResearches);
+		first = 0;
+	}
+	fprintf(FHDL, "]}\n");
+	fflush(FHDL);
+}
+
+unsigned long long searchTotalNodes(const searchEngine_s* engine) { /* Other Threads' Counters Are Read Without Locking, Close Enough For Reporting */
+
+	unsigned long long nodes = 0;
+
+
+	for (int i = 0; i < engine->numThreads; i++) { nodes += engine->workers[i].nodes; }
+	return nodes;
+}
+
+void checkSearchLimits(searchWorker_s* w) { /* Only The Main Worker Decides When To Stop */
+
+	searchEngine_s* engine = w->engine;
+
+
+	if (w->id != 0) { return; }
+	if (engine->limits.nodes && searchTotalNodes(engine) >= engine->limits.nodes) { InterlockedExchange(&engine->bStop, 1); }
+	if (engine->bTimeLimited && timeGetTime() - engine->startTime >= engine->hardTimeMs) { InterlockedExchange(&engine->bStop, 1); }
+}
+
+inline int scoreToTT(int score, int ply) {
+
+	if (score >= MATE_BOUND_SCORE)  { return score + ply; }
+	if (score <= -MATE_BOUND_SCORE) { return score - ply; }
+	return score;
+}
+
+inline int scoreFromTT(int score, int ply) {
+
+	if (score >= MATE_BOUND_SCORE)  { return score - ply; }
+	if (score <= -MATE_BOUND_SCORE) { return score + ply; }
+	return score;
+}
+
+bool isRepetition(const searchWorker_s* w, const position_s* pos) {
+
+	int limit = w->keyCount - 1 - pos->halfmoveClock;
+
+
+	for (int i = w->keyCount - 3; i >= 0 && i >= limit; i -= 2) {
+		if (w->keyStack[i] == pos->key) { return true; }
+	}
+	return false;
+}
+
+void scoreMoves(const searchWorker_s* w, const position_s* pos, const move_t* list, int* scores, int n, move_t ttMove, int ply) {
+
+	static const int victimValue[7] = { 0, 1, 3, 3, 5, 9, 0 };
+
+
+	for (int i = 0; i < n; i++) {
+		move_t m = list[i];
+		int from = moveFrom(m);
+		int to = moveTo(m);
+
+		if (m == ttMove) { scores[i] = 2000000; }
+		else if (isCaptureMove(m)) {
+			int victim = moveFlag(m) == EN_PASSANT_CAPTURE ? PAWN : pieceType(pos->board[to]);
+			scores[i] = 1000000 + victimValue[victim] * 16 - pieceType(pos->board[from]);
+			if (isPromotionMove(m)) { scores[i] += promotionType(m) * 16; }
+		}
+		else if (isPromotionMove(m))       { scores[i] = 900000 + promotionType(m); }
+		else if (m == w->killers[ply][0])  { scores[i] = 800000; }
+		else if (m == w->killers[ply][1])  { scores[i] = 790000; }
+		else { scores[i] = w->history[pos->board[from]][to]; }
+	}
+}
+
+move_t pickMove(move_t* list, int* scores, int n, int i) { /* Selection Sort One Step At A Time, Most Nodes Never Look Past The First Few */
+
+	int best = i;
+
+
+	for (int j = i + 1; j < n; j++) {
+		if (scores[j] > scores[best]) { best = j; }
+	}
+	move_t m = list[best]; list[best] = list[i]; list[i] = m;
+	int s = scores[best]; scores[best] = scores[i]; scores[i] = s;
+	return m;
+}
+
+int quiescence(searchWorker_s* w, const position_s* pos, int alpha, int beta, int ply) {
+
+	move_t list[MAX_MOVES_MACRO];
+	int scores[MAX_MOVES_MACRO];
+	position_s next;
+
+
+	w->pvLength[ply] = ply;
+	w->stats.qnodes++;
+	if ((++w->nodes & 1023) == 0 || w->engine->limits.nodes) { checkSearchLimits(w); }
+	if (w->engine->bStop) { return 0; }
+	if (ply > w->seldepth) { w->seldepth = ply; }
+
+	int standPat = evaluate(pos);
+	if (ply >= MAX_PLY_MACRO - 1) { return standPat; }
+	if (standPat >= beta) { return standPat; }
+	if (standPat > alpha) { alpha = standPat; }
+
+	int bestScore = standPat;
+	int n = generateMoves(pos, list, true);
+	scoreMoves(w, pos, list, scores, n, 0, ply);
+
+	for (int i = 0; i < n; i++) {
+		move_t m = pickMove(list, scores, n, i);
+		if (!makeMove(pos, &next, m)) { continue; }
+
+		int score = -quiescence(w, &next, -beta, -alpha, ply + 1);
+		if (w->engine->bStop) { return 0; }
+
+		if (score > bestScore) {
+			bestScore = score;
+			if (score > alpha) {
+				alpha = score;
+				if (score >= beta) { break; }
+			}
+		}
+	}
+	return bestScore;
+}
+
+bool isExcludedRootMove(const searchWorker_s* w, move_t m) {
+
+	for (int i = 0; i < w->excludedCount; i++) {
+		if (w->excludedRoot[i] == m) { return true; }
+	}
+	return false;
+}
+
+inline bool hasNonPawnMaterial(const position_s* pos, int side) { /* Zugzwang Guard, King And Pawns Alone Often Must Not Pass */
+
+	return (pos->colorBB[side] & ~(pos->pieceBB[makePiece(side, PAWN)] | pos->pieceBB[makePiece(side, KING)])) != 0;
+}
+
+int alphaBeta(searchWorker_s* w, const position_s* pos, int alpha, int beta, int depth, int ply, bool bNullAllowed) {
+
+	move_t list[MAX_MOVES_MACRO];
+	int scores[MAX_MOVES_MACRO];
+	position_s next;
+	ttHit_s hit;
+	move_t ttMove = 0;
+	move_t bestMove = 0;
+	int bestScore = -INFINITE_SCORE;
+	int legalMoves = 0;
+	bool bPvNode = beta - alpha > 1;
+	bool bHit = false;
+	transTable_s* tt = w->engine->tt;
+	const searchFeatures_s* features = &w->engine->features;
+
+
+	/* Check Extension, Before The Horizon Test So A Check At Depth 0 Is Still Answered With A Full Search */
+	bool bInCheck = inCheck(pos);
+	if (bInCheck && features->bCheckExtension && ply > 0) { depth++; }
+
+	if (depth <= 0) { return quiescence(w, pos, alpha, beta, ply); }
+
+	w->pvLength[ply] = ply;
+	if ((++w->nodes & 1023) == 0 || w->engine->limits.nodes) { checkSearchLimits(w); }
+	if (w->engine->bStop) { return 0; }
+	if (ply > w->seldepth) { w->seldepth = ply; }
+
+	if (ply > 0) {
+		if (pos->halfmoveClock >= 100 || isInsufficientMaterial(pos) || isRepetition(w, pos)) { return DRAW_SCORE; }
+		if (ply >= MAX_PLY_MACRO - 1) { return evaluate(pos); }
+
+		/* Mate Distance Pruning */
+		if (alpha < -MATE_SCORE + ply)    { alpha = -MATE_SCORE + ply; }
+		if (beta > MATE_SCORE - ply - 1)  { beta = MATE_SCORE - ply - 1; }
+		if (alpha >= beta) { return alpha; }
+	}
+
+	int alphaOrg = alpha; /* After Mate Distance Pruning, A Raised alpha Nothing Beat Is Still An Upper Bound */
+
+	w->stats.ttProbes++;
+	if (ttProbe(tt, pos->key, &hit)) {
+		bHit = true;
+		w->stats.ttHits++;
+		ttMove = hit.move;
+		if (!bPvNode && hit.depth >= depth) {
+			int ttScore = scoreFromTT(hit.score, ply);
+			if (hit.bound == BOUND_EXACT || (hit.bound == BOUND_LOWER && ttScore >= beta) || (hit.bound == BOUND_UPPER && ttScore <= alpha)) {
+				w->stats.ttCutoffs++;
+				return ttScore;
+			}
+		}
+	}
+
+	/* Static Pruning, Never In Check, At The Root Or Near Mate Scores */
+	int staticEval = bInCheck ? -INFINITE_SCORE : (bHit ? hit.eval : evaluate(pos));
+	bool bQuietPrunable = !bPvNode && !bInCheck && ply > 0 && beta < MATE_BOUND_SCORE && alpha > -MATE_BOUND_SCORE;
+
+	if (bQuietPrunable) {
+
+		/* Reverse Futility: So Far Above Beta That A Quiet Move Will Not Bring It Back Within Depth Plies */
+		if (features->bFutility && depth <= 6 && staticEval - 90 * depth >= beta) {
+			w->stats.futilityPrunes++;
+			return staticEval;
+		}
+
+		/* Razoring: Hopelessly Below Alpha, Only Captures Can Save It */
+		if (features->bRazoring && depth <= 2 && staticEval + 300 * depth < alpha) {
+			int score = quiescence(w, pos, alpha - 1, alpha, ply);
+			if (w->engine->bStop) { return 0; }
+			if (score < alpha) { w->stats.razorPrunes++; return score; }
+		}
+
+		/* Null Move: Pass, And If A Reduced Search Still Fails High The Real Moves Will Too */
+		if (features->bNullMove && bNullAllowed && depth >= 3 && staticEval >= beta && hasNonPawnMaterial(pos, pos->sideToMove)) {
+			int reduction = 3 + depth / 6;
+
+			makeNullMove(pos, &next);
+			w->keyStack[w->keyCount++] = next.key;
+			int score = -alphaBeta(w, &next, -beta, -beta + 1, depth - 1 - reduction, ply + 1, false);
+			w->keyCount--;
+			if (w->engine->bStop) { return 0; }
+
+			if (score >= beta) {
+				w->stats.nullMovePrunes++;
+				return score >= MATE_BOUND_SCORE ? beta : score; /* Unproven Mates Are Not Returned */
+			}
+		}
+	}
+
+	int n = generateMoves(pos, list, false);
+	scoreMoves(w, pos, list, scores, n, ttMove, ply);
+
+	/* Futility: Quiet Moves Near The Horizon Cannot Raise A Hopeless Eval Above Alpha */
+	bool bFutile = bQuietPrunable && features->bFutility && depth <= 3 && staticEval + 100 + 120 * depth <= alpha;
+
+	for (int i = 0; i < n; i++) {
+		move_t m = pickMove(list, scores, n, i);
+		bool bQuiet = !isCaptureMove(m) && !isPromotionMove(m);
+		int score;
+
+		if (ply == 0 && isExcludedRootMove(w, m)) { continue; }
+		if (!makeMove(pos, &next, m)) { continue; }
+		legalMoves++;
+
+		bool bGivesCheck = inCheck(&next);
+		if (bFutile && bQuiet && !bGivesCheck && legalMoves > 1) {
+			w->stats.futilityPrunes++;
+			continue;
+		}
+
+		w->keyStack[w->keyCount++] = next.key;
+
+		/* Principal Variation Search, Full Window Only For The First Move Or When A Null Window Fails High */
+		if (legalMoves == 1) {
+			score = -alphaBeta(w, &next, -beta, -alpha, depth - 1, ply + 1, true);
+		}
+		else {
+			/* Late Move Reductions: Well Ordered Quiet Moves This Far Down The List Rarely Matter */
+			int reduction = 0;
+			if (features->bLMR && depth >= 3 && legalMoves > (bPvNode ? 3 : 2) && bQuiet && !bInCheck && !bGivesCheck) {
+				reduction = lmrTable[depth < 63 ? depth : 63][legalMoves < 63 ? legalMoves : 63];
+				if (bPvNode && reduction > 0) { reduction--; }
+				if (m == w->killers[ply][0] || m == w->killers[ply][1]) { reduction--; }
+				if (reduction > depth - 2) { reduction = depth - 2; }
+				if (reduction < 0) { reduction = 0; }
+				if (reduction > 0) { w->stats.lmrReductions++; }
+			}
+
+			score = -alphaBeta(w, &next, -alpha - 1, -alpha, depth - 1 - reduction, ply + 1, true);
+			if (reduction > 0 && score > alpha) {
+				w->stats.lmrResearches++;
+				score = -alphaBeta(w, &next, -alpha - 1, -alpha, depth - 1, ply + 1, true);
+			}
+			if (score > alpha && score < beta) { score = -alphaBeta(w, &next, -beta, -alpha, depth - 1, ply + 1, true); }
+		}
+		w->keyCount--;
+		if (w->engine->bStop) { return 0; }
+
+		if (score > bestScore) {
+			bestScore = score;
+			bestMove = m;
+
+			if (score > alpha) {
+				alpha = score;
+
+				/* Update Triangular PV Table */
+				w->pv[ply][ply] = m;
+				for (int j = ply + 1; j < w->pvLength[ply + 1]; j++) { w->pv[ply][j] = w->pv[ply + 1][j]; }
+				w->pvLength[ply] = w->pvLength[ply + 1] > ply + 1 ? w->pvLength[ply + 1] : ply + 1;
+
+				if (score >= beta) {
+					w->stats.betaCutoffs++;
+					if (legalMoves == 1) { w->stats.firstMoveCutoffs++; }
+					if (bQuiet) {
+						if (w->killers[ply][0] != m) { w->killers[ply][1] = w->killers[ply][0]; w->killers[ply][0] = m; }
+						int* h = &w->history[pos->board[moveFrom(m)]][moveTo(m)];
+						*h += depth * depth;
+						if (*h > 400000) { /* Keep History Below The Killer Scores */
+							for (int p = 0; p < 13; p++) {
+								for (int sq = 0; sq < 64; sq++) { w->history[p][sq] >>= 1; }
+							}
+						}
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	if (legalMoves == 0) { return bInCheck ? -MATE_SCORE + ply : DRAW_SCORE; }
+
+	/* Secondary MultiPV Lines Would Overwrite The Real Best Root Move */
+	if (ply > 0 || w->excludedCount == 0) {
+		int bound = bestScore >= beta ? BOUND_LOWER : (alpha > alphaOrg ? BOUND_EXACT : BOUND_UPPER);
+		ttStore(tt, pos->key, bestMove, scoreToTT(bestScore, ply), bInCheck ? 0 : staticEval, depth, bound);
+	}
+
+	return bestScore;
+}
+
+void reportSearchInfo(searchWorker_s* w, int line) {
+
+	searchEngine_s* engine = w->engine;
+	const searchLine_s* result = &engine->lines[line];
+	searchInfo_s info;
+	DWORD elapsed = timeGetTime() - engine->startTime;
+
+
+	if (engine->onInfo == NULL) { return; }
+
+	info.multipv = line + 1;
+	info.depth = result->depth;
+	info.seldepth = result->seldepth;
+	info.score = result->score;
+	info.nodes = searchTotalNodes(engine);
+	info.timeMs = elapsed;
+	info.nps = info.nodes * 1000 / (elapsed ? elapsed : 1);
+	info.hashfull = ttHashfull(engine->tt);
+	info.pvLength = result->pvLength;
+	memcpy(info.pv, result->pv, sizeof(move_t) * result->pvLength);
+
+	engine->onInfo(&info, engine->onInfoUser);
+}
+
+int aspirationSearch(searchWorker_s* w, int depth, int previous) { /* Narrow Window Around The Last Score, Widened On Each Fail */
+
+	const searchFeatures_s* features = &w->engine->features;
+	int delta = 25;
+
+
+	if (!features->bAspiration || depth < 5 || previous >= MATE_BOUND_SCORE || previous <= -MATE_BOUND_SCORE) {
+		return alphaBeta(w, &w->engine->rootPos, -INFINITE_SCORE, INFINITE_SCORE, depth, 0, true);
+	}
+
+	int alpha = previous - delta;
+	int beta = previous + delta;
+	while (true) {
+		int score = alphaBeta(w, &w->engine->rootPos, alpha, beta, depth, 0, true);
+		if (w->engine->bStop) { return score; }
+
+		if (score <= alpha)     { beta = (alpha + beta) / 2; alpha = score - delta > -INFINITE_SCORE ? score - delta : -INFINITE_SCORE; }
+		else if (score >= beta) { beta = score + delta < INFINITE_SCORE ? score + delta : INFINITE_SCORE; }
+		else { return score; }
+
+		delta += delta;
+		if (delta > 1000) { alpha = -INFINITE_SCORE; beta = INFINITE_SCORE; }
+	}
+}
+
+void iterativeDeepening(searchWorker_s* w) {
+
+	searchEngine_s* engine = w->engine;
+	int maxDepth = MAX_PLY_MACRO - 1;
+	int lines = 1;
+
+
+	if (engine->limits.depth > 0 && engine->limits.depth < maxDepth) { maxDepth = engine->limits.depth; }
+
+	/* Helpers Only Ever Chase The Best Line, Their TT Entries Still Speed Up The Others */
+	if (w->id == 0) {
+		lines = engine->multiPV < engine->rootMoveCount ? engine->multiPV : engine->rootMoveCount;
+		if (lines < 1) { lines = 1; }
+	}
+
+	for (int depth = 1; depth <= maxDepth; depth++) {
+
+		/* Lazy SMP: Odd Helpers Skip Every Other Depth So The Threads Spread Over Different Trees */
+		if (w->id > 0 && (w->id & 1) && (depth & 1) && depth > 1 && depth < maxDepth) { continue; }
+
+		/* MultiPV: Search The Root Again Without The Moves Earlier Lines Already Claimed, Same TT Throughout */
+		bool bAborted = false;
+		w->excludedCount = 0;
+		for (int line = 0; line < lines; line++) {
+
+			w->seldepth = 0;
+			int previous = (w->id == 0 && line < engine->lineCount) ? engine->lines[line].score : w->bestScore;
+			int score = aspirationSearch(w, depth, previous);
+
+			if (engine->bStop && w->completedDepth > 0) { bAborted = true; break; } /* Unfinished Iteration, Keep The Previous One */
+
+			if (line == 0) {
+				w->completedDepth = depth;
+				w->bestScore = score;
+				w->rootPvLength = w->pvLength[0];
+				memcpy(w->rootPv, w->pv[0], sizeof(move_t) * w->rootPvLength);
+			}
+			if (w->id != 0) { break; }
+
+			searchLine_s* result = &engine->lines[line];
+			result->score = score;
+			result->depth = depth;
+			result->seldepth = w->seldepth;
+			result->pvLength = w->pvLength[0];
+			memcpy(result->pv, w->pv[0], sizeof(move_t) * result->pvLength);
+			if (line >= engine->lineCount) { engine->lineCount = line + 1; }
+
+			reportSearchInfo(w, line);
+
+			if (result->pvLength == 0) { break; } /* Mate Or Stalemate At The Root */
+			w->excludedRoot[w->excludedCount++] = result->pv[0];
+		}
+
+		if (w->id != 0) { continue; }
+		if (!bAborted) { mergeSearchStats(engine, depth); }
+
+		if (engine->bStop) { break; }
+		if (engine->bTimeLimited && timeGetTime() - engine->startTime >= engine->softTimeMs) { break; }
+		if (w->rootPvLength == 0) { break; }
+	}
+}
+
+DWORD WINAPI searchWorkerThread(LPVOID param) {
+
+	iterativeDeepening((searchWorker_s*)param);
+	return 0;
+}
+
+void setupTimeLimits(searchEngine_s* engine) {
+
+	const searchLimits_s* limits = &engine->limits;
+	int us = engine->rootPos.sideToMove;
+	const int overhead = 30; /* GUI And Pipe Latency */
+
+
+	engine->bTimeLimited = false;
+	if (limits->infinite) { return; }
+
+	if (limits->movetime > 0) {
+		engine->bTimeLimited = true;
+		engine->softTimeMs = engine->hardTimeMs = limits->movetime > overhead * 2 ? limits->movetime - overhead : limits->movetime / 2 + 1;
+	}
+	else if (limits->time[us] > 0) {
+		int movesToGo = limits->movestogo > 0 ? limits->movestogo : 30;
+		int remaining = limits->time[us] - overhead;
+		if (remaining < 1) { remaining = 1; }
+
+		int soft = remaining / movesToGo + limits->inc[us] * 3 / 4;
+		int hard = soft * 4;
+		if (hard > remaining / 3) { hard = remaining / 3; }
+		if (soft > hard) { soft = hard; }
+
+		engine->bTimeLimited = true;
+		engine->softTimeMs = soft > 1 ? soft : 1;
+		engine->hardTimeMs = hard > 1 ? hard : 1;
+	}
+}
+
+move_t searchRun(searchEngine_s* engine, const position_s* pos, const unsigned long long* gameKeys, int gameKeyCount, const searchLimits_s* limits) { /* Blocks Until Done, Call searchStop() From Another Thread To End Early */
+
+	engine->startTime = timeGetTime();
+	engine->rootPos = *pos;
+	engine->limits = *limits;
+	InterlockedExchange(&engine->bStop, 0);
+	setupTimeLimits(engine);
+	engine->lineCount = 0;
+	engine->lastStatsDepth = 0;
+
+	move_t rootMoves[MAX_MOVES_MACRO];
+	engine->rootMoveCount = generateLegalMoves(pos, rootMoves);
+	if (engine->bOwnsTT) { ttNewSearch(engine->tt); } /* A Shared Table Is Aged By Its Owner, Once Per Unit Of Work */
+
+	if (gameKeyCount > MAX_GAME_PLY_MACRO - 1) { /* Only The Most Recent Positions Can Repeat Anyway */
+		gameKeys += gameKeyCount - (MAX_GAME_PLY_MACRO - 1);
+		gameKeyCount = MAX_GAME_PLY_MACRO - 1;
+	}
+
+	for (int i = 0; i < engine->numThreads; i++) {
+		searchWorker_s* w = &engine->workers[i];
+		w->nodes = 0;
+		memset(&w->stats, 0, sizeof(searchStats_s));
+		w->completedDepth = 0;
+		w->rootPvLength = 0;
+		w->excludedCount = 0;
+		w->bestScore = 0;
+		memset(w->killers, 0, sizeof(w->killers));
+		memcpy(w->keyStack, gameKeys, sizeof(unsigned long long) * gameKeyCount);
+		w->keyStack[gameKeyCount] = pos->key;
+		w->keyCount = gameKeyCount + 1;
+	}
+
+	/* Helpers Run On Their Own Threads, The Main Worker On The Calling One */
+	for (int i = 1; i < engine->numThreads; i++) {
+		engine->workers[i].thread = CreateThread(NULL, 0, searchWorkerThread, &engine->workers[i], 0, NULL);
+	}
+	iterativeDeepening(&engine->workers[0]);
+
+	while (engine->limits.infinite && !engine->bStop) { Sleep(1); } /* UCI: No bestmove Before stop On go infinite */
+	InterlockedExchange(&engine->bStop, 1);
+
+	for (int i = 1; i < engine->numThreads; i++) {
+		WaitForSingleObject(engine->workers[i].thread, INFINITE);
+		CloseHandle(engine->workers[i].thread);
+	}
+
+	searchWorker_s* mainWorker = &engine->workers[0];
+	engine->bestMove = mainWorker->rootPvLength > 0 ? mainWorker->rootPv[0] : 0;
+	engine->ponderMove = mainWorker->rootPvLength > 1 ? mainWorker->rootPv[1] : 0;
+	engine->bestScore = mainWorker->bestScore;
+
+	/* Interrupted Before Depth 1 Finished, Any Legal Move Beats None */
+	if (engine->bestMove == 0 && engine->rootMoveCount > 0) { engine->bestMove = rootMoves[0]; }
+
+	return engine->bestMove;
+}
+
+void searchStop(searchEngine_s* engine) {
+
+	InterlockedExchange(&engine->bStop, 1);
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            UCI Protocol                                                                                                    *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define UCI_LINE_BUFFER_MACRO 16384 /* position startpos moves ... grows by 5 chars per ply, Input Lines Start Here And Grow */
+
+struct uciState_s {
+
+	searchEngine_s engine;
+	position_s pos;
+	unsigned long long gameKeys[MAX_GAME_PLY_MACRO];
+	int gameKeyCount = 0;
+	HANDLE searchThread = NULL;
+	size_t hashMB = 16;
+	int threads = 1;
+	bool bStats = false;         /* Stats Option, Per Iteration info string Lines */
+	FILE* statsJSON = NULL;      /* --stats-json <path> */
+};
+
+
+CRITICAL_SECTION uciOutputLock; /* Initialized By uciMain() */
+
+
+void uciSend(const char* format, ...) { /* One Locked Write Per Line, Search And Input Threads Both Print */
+
+	va_list args;
+
+
+	EnterCriticalSection(&uciOutputLock);
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+	fflush(stdout);
+	LeaveCriticalSection(&uciOutputLock);
+}
+
+char* uciReadLine(char** line, size_t* capacity) { /* The Whole Line However Long, A Long Game's Move List Must Not Split Into Two Commands, NULL At End Of Input */
+
+	size_t length = 0;
+
+
+	while (true) {
+		if (*capacity - length < 2) {
+			char* grown = (char*)realloc(*line, *capacity * 2);
+			if (grown == NULL) { fputs("Memory error", stderr); exit(2); }
+			*line = grown;
+			*capacity *= 2;
+		}
+		if (fgets(*line + length, (int)(*capacity - length), stdin) == NULL) { return length ? *line : NULL; }
+		length += strlen(*line + length);
+		if (length > 0 && (*line)[length - 1] == '\n') { return *line; }
+	}
+}
+
+const char* uciNextToken(const char* p, char* token, int size) { /* Returns NULL When The Line Is Used Up */
+
+	int n = 0;
+
+
+	while (*p == ' ' || *p == '\t') { p++; }
+	if (*p == '\0') { token[0] = '\0'; return NULL; }
+	while (*p && *p != ' ' && *p != '\t') {
+		if (n < size - 1) { token[n++] = *p; }
+		p++;
+	}
+	token[n] = '\0';
+	return p;
+}
+
+void uciFormatScore(int score, char* str) {
+
+	if (score >= MATE_BOUND_SCORE)       { sprintf(str, "mate %d", (MATE_SCORE - score + 1) / 2); }
+	else if (score <= -MATE_BOUND_SCORE) { sprintf(str, "mate %d", -(MATE_SCORE + score) / 2); }
+	else                                 { sprintf(str, "cp %d", score); }
+}
+
+void uciInfoCallback(const searchInfo_s* info, void* user) {
+
+	char line[UCI_LINE_BUFFER_MACRO];
+	char score[32];
+	char move[6];
+	int len;
+
+
+	uciFormatScore(info->score, score);
+	len = sprintf(line, "info depth %d seldepth %d multipv %d score %s nodes %llu nps %llu hashfull %d time %u pv",
+		info->depth, info->seldepth, info->multipv, score, info->nodes, info->nps, info->hashfull, info->timeMs);
+
+	for (int i = 0; i < info->pvLength && len < UCI_LINE_BUFFER_MACRO - 8; i++) {
+		moveToUCI(info->pv[i], move);
+		len += sprintf(line + len, " %s", move);
+	}
+	uciSend("%s\n", line);
+}
+
+void uciIterationCallback(const searchDepthStats_s* stats, void* user) {
+
+	uciState_s* uci = (uciState_s*)user;
+	char line[1024];
+
+
+	if (!uci->bStats) { return; }
+	formatSearchStats(line, stats);
+	uciSend("info string stats %s\n", line);
+}
+
+DWORD WINAPI uciSearchThread(LPVOID param) {
+
+	uciState_s* uci = (uciState_s*)param;
+	searchLimits_s limits = uci->engine.limits;
+	char best[6];
+	char ponder[6];
+
+
+	searchRun(&uci->engine, &uci->pos, uci->gameKeys, uci->gameKeyCount, &limits);
+	if (uci->statsJSON != NULL) { writeSearchStatsJSON(uci->statsJSON, &uci->engine); }
+
+	moveToUCI(uci->engine.bestMove, best);
+	if (uci->engine.ponderMove) {
+		moveToUCI(uci->engine.ponderMove, ponder);
+		uciSend("bestmove %s ponder %s\n", best, ponder);
+	}
+	else {
+		uciSend("bestmove %s\n", best);
+	}
+	return 0;
+}
+
+void uciWaitForSearch(uciState_s* uci) {
+
+	if (uci->searchThread == NULL) { return; }
+	searchStop(&uci->engine);
+	WaitForSingleObject(uci->searchThread, INFINITE);
+	CloseHandle(uci->searchThread);
+	uci->searchThread = NULL;
+}
+
+void uciPosition(uciState_s* uci, const char* p) {
+
+	char token[128];
+	char fen[MAX_FEN_MACRO * 2];
+	position_s next;
+
+
+	p = uciNextToken(p, token, sizeof(token));
+	if (p == NULL) { return; }
+
+	if (!strcmp(token, "startpos")) {
+		parseFEN(&uci->pos, startFEN);
+	}
+	else if (!strcmp(token, "fen")) {
+		int len = 0;
+		fen[0] = '\0';
+		/* FEN Runs Until The moves Keyword */
+		while (p != NULL) {
+			const char* before = p;
+			p = uciNextToken(p, token, sizeof(token));
+			if (p == NULL || !strcmp(token, "moves")) { p = before; break; }
+			if (len + strlen(token) + 2 > sizeof(fen)) { continue; } /* Junk After A Full FEN, Skip It */
+			len += sprintf(fen + len, "%s%s", len ? " " : "", token);
+		}
+		if (len == 0 || parseFEN(&uci->pos, fen) == 1) { uciSend("info string invalid fen\n"); parseFEN(&uci->pos, startFEN); }
+	}
+	else { return; }
+
+	uci->gameKeyCount = 0;
+
+	p = p ? uciNextToken(p, token, sizeof(token)) : NULL;
+	if (p == NULL || strcmp(token, "moves")) { return; }
+
+	while ((p = uciNextToken(p, token, sizeof(token))) != NULL) {
+		move_t m = parseUCIMove(&uci->pos, token);
+		if (m == 0) { uciSend("info string illegal move %s\n", token); break; }
+
+		if (uci->gameKeyCount < MAX_GAME_PLY_MACRO) { uci->gameKeys[uci->gameKeyCount++] = uci->pos.key; }
+		else { /* Shift Out The Oldest Key */
+			memmove(uci->gameKeys, uci->gameKeys + 1, sizeof(unsigned long long) * (MAX_GAME_PLY_MACRO - 1));
+			uci->gameKeys[MAX_GAME_PLY_MACRO - 1] = uci->pos.key;
+		}
+		makeMove(&uci->pos, &next, m);
+		uci->pos = next;
+	}
+}
+
+void uciGo(uciState_s* uci, const char* p) {
+
+	char token[64];
+	searchLimits_s limits;
+
+
+	while ((p = uciNextToken(p, token, sizeof(token))) != NULL) {
+		char value[64];
+
+		if (!strcmp(token, "infinite")) { limits.infinite = true; continue; }
+		if (!strcmp(token, "ponder"))   { limits.infinite = true; continue; }
+		if (uciNextToken(p, value, sizeof(value)) == NULL) { break; }
+
+		if      (!strcmp(token, "depth"))     { limits.depth = atoi(value); }
+		else if (!strcmp(token, "nodes"))     { limits.nodes = strtoull(value, NULL, 10); }
+		else if (!strcmp(token, "movetime"))  { limits.movetime = atoi(value); }
+		else if (!strcmp(token, "wtime"))     { limits.time[0] = atoi(value); }
+		else if (!strcmp(token, "btime"))     { limits.time[1] = atoi(value); }
+		else if (!strcmp(token, "winc"))      { limits.inc[0] = atoi(value); }
+		else if (!strcmp(token, "binc"))      { limits.inc[1] = atoi(value); }
+		else if (!strcmp(token, "movestogo")) { limits.movestogo = atoi(value); }
+		else if (!strcmp(token, "perft")) {
+			DWORD start = timeGetTime();
+			unsigned long long total = 0;
+			move_t list[MAX_MOVES_MACRO];
+			position_s next;
+			char move[6];
+			int depth = atoi(value);
+			int n = generateLegalMoves(&uci->pos, list);
+
+			for (int i = 0; i < n; i++) {
+				unsigned long long count = depth > 1 ? (makeMove(&uci->pos, &next, list[i]), perft(&next, depth - 1)) : 1;
+				moveToUCI(list[i], move);
+				uciSend("%s: %llu\n", move, count);
+				total += count;
+			}
+			uciSend("\nNodes searched: %llu (%u ms)\n\n", total, timeGetTime() - start);
+			return;
+		}
+		else { continue; }
+		p = uciNextToken(p, value, sizeof(value));
+	}
+
+	uci->engine.limits = limits;
+	uci->searchThread = CreateThread(NULL, 0, uciSearchThread, uci, 0, NULL);
+}
+
+void uciSetOption(uciState_s* uci, const char* p) {
+
+	char token[64];
+	char name[64] = "";
+	char value[64] = "";
+
+
+	/* setoption name <id> value <x> */
+	p = uciNextToken(p, token, sizeof(token));
+	if (p == NULL || strcmp(token, "name")) { return; }
+	p = uciNextToken(p, name, sizeof(name));
+	if (p != NULL) { p = uciNextToken(p, token, sizeof(token)); }
+	if (p != NULL && !strcmp(token, "value")) { uciNextToken(p, value, sizeof(value)); }
+
+	if (!_stricmp(name, "Stats")) {
+		uci->bStats = !_stricmp(value, "true");
+	}
+	else if (!searchSetOption(&uci->engine, name, value)) {
+		uciSend("info string unknown option %s\n", name);
+	}
+}
+
+int uciMain(const char* statsPath) { /* jonochess --uci [--stats-json <path>], No Window, No GL, Just stdin/stdout */
+
+	static uciState_s uci; /* Too Big For The Stack */
+	size_t lineCapacity = UCI_LINE_BUFFER_MACRO;
+	char* line = (char*)malloc(lineCapacity);
+	char token[64];
+
+
+	if (line == NULL) { fputs("Memory error", stderr); exit(2); }
+	InitializeCriticalSection(&uciOutputLock);
+	initEngine();
+	searchInit(&uci.engine, NULL, uci.hashMB, uci.threads);
+	uci.engine.onInfo = uciInfoCallback;
+	uci.engine.onInfoUser = &uci;
+	uci.engine.onIteration = uciIterationCallback;
+	uci.engine.onIterationUser = &uci;
+
+	if (statsPath != NULL) {
+		fopen_s(&uci.statsJSON, statsPath, "a");
+		if (uci.statsJSON == NULL) { fputs("File error", stderr); exit(1); }
+	}
+	parseFEN(&uci.pos, startFEN);
+
+	while (uciReadLine(&line, &lineCapacity) != NULL) {
+
+		const char* p;
+
+		line[strcspn(line, "\r\n")] = '\0';
+		p = uciNextToken(line, token, sizeof(token));
+		if (p == NULL) { continue; }
+
+		if (!strcmp(token, "uci")) {
+			uciSend("id name jonochess\n");
+			uciSend("id author jono\n");
+			uciSend("option name Hash type spin default 16 min 1 max 65536\n");
+			uciSend("option name Threads type spin default 1 min 1 max 256\n");
+			uciSend("option name MultiPV type spin default 1 min 1 max %d\n", MAX_MULTIPV_MACRO);
+			uciSend("option name Stats type check default false\n");
+			uciSend("option name NullMove type check default true\n");
+			uciSend("option name LMR type check default true\n");
+			uciSend("option name Futility type check default true\n");
+			uciSend("option name Razoring type check default true\n");
+			uciSend("option name CheckExtension type check default true\n");
+			uciSend("option name Aspiration type check default true\n");
+			uciSend("uciok\n");
+		}
+		else if (!strcmp(token, "isready"))    { uciSend("readyok\n"); }
+		else if (!strcmp(token, "d"))          { char fen[MAX_FEN_MACRO]; positionToFEN(&uci.pos, fen); uciSend("Fen: %s\n", fen); }
+		else if (!strcmp(token, "ucinewgame")) { uciWaitForSearch(&uci); searchClearHistory(&uci.engine); }
+		else if (!strcmp(token, "setoption"))  { uciWaitForSearch(&uci); uciSetOption(&uci, p); }
+		else if (!strcmp(token, "position"))   { uciWaitForSearch(&uci); uciPosition(&uci, p); }
+		else if (!strcmp(token, "go"))         { uciWaitForSearch(&uci); uciGo(&uci, p); }
+		else if (!strcmp(token, "stop"))       { uciWaitForSearch(&uci); }
+		else if (!strcmp(token, "ponderhit"))  { uciWaitForSearch(&uci); } /* Ponder Isn't Advertised, Just Answer Straight Away */
+		else if (!strcmp(token, "quit"))       { break; }
+	}
+
+	uciWaitForSearch(&uci);
+	searchFree(&uci.engine);
+	if (uci.statsJSON != NULL) { fclose(uci.statsJSON); }
+	DeleteCriticalSection(&uciOutputLock);
+	free(line);
+
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            PGN Reader                                                                                                      *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define PGN_MAX_TAGS_MACRO 32
+#define PGN_CHUNK_MACRO (4 << 20)      /* Bytes Of PGN Handed To A Worker At Once */
+#define PGN_MAX_THREADS_MACRO 64
+
+struct stringView_s { /* Points Into The Mapped File, Never Owns Or Terminates Anything */
+
+	const char* data;
+	size_t length;
+};
+
+struct pgnTag_s {
+
+	stringView_s name;
+	stringView_s value;  /* Without The Quotes, Escapes Left As They Are */
+};
+
+struct pgnGame_s {
+
+	stringView_s text;   /* The Whole Game, Tags Included */
+	pgnTag_s tags[PGN_MAX_TAGS_MACRO];
+	int tagCount;
+	stringView_s result;
+	position_s start;    /* From The FEN Tag, Otherwise The Standard Position */
+	position_s pos;      /* After The Last Move That Could Be Replayed */
+	move_t moves[MAX_GAME_PLY_MACRO];
+	int moveCount;
+	bool bError;         /* A Move Did Not Decode, moves Stops Before It */
+	size_t offset;       /* Of The Game In The File, Lets Parallel Callers Restore File Order */
+};
+
+typedef void (*pgnGameCallback_t)(const pgnGame_s* game, int worker, void* user); /* worker Is 0 To threads - 1, For Per Thread State */
+
+struct pgnStats_s {
+
+	unsigned long long games;
+	unsigned long long moves;
+	unsigned long long errors;   /* Games With A Move That Did Not Decode */
+	unsigned long long bytes;
+	unsigned int timeMs;
+};
+
+struct pgnReader_s { /* Shared By The Worker Threads Of One pgnReadFile() Call */
+
+	const char* data;
+	size_t size;
+	int chunkCount;
+	volatile LONG nextChunk;
+	pgnGameCallback_t onGame;
+	void* user;
+	pgnStats_s workerStats[PGN_MAX_THREADS_MACRO];
+	volatile LONG nextWorker;
+};
+
+
+inline bool viewEquals(stringView_s view, const char* str) {
+
+	size_t n = strlen(str);
+	return view.length == n && !memcmp(view.data, str, n);
+}
+
+const pgnTag_s* pgnFindTag(const pgnGame_s* game, const char* name) {
+
+	for (int i = 0; i < game->tagCount; i++) {
+		if (viewEquals(game->tags[i].name, name)) { return &game->tags[i]; }
+	}
+	return NULL;
+}
+
+inline bool isLineStart(const char* data, const char* p) { return p == data || p[-1] == '\n'; }
+
+const char* pgnSkipLine(const char* p, const char* end) {
+
+	const char* eol = (const char*)memchr(p, '\n', end - p);
+	return eol ? eol + 1 : end;
+}
+
+const char* pgnParseGame(const char* data, const char* p, const char* end, pgnGame_s* game) { /* Returns Where The Next Game Starts */
+
+	position_s next;
+	int depth = 0; /* Variation Nesting, Moves Inside ( ) Are Skipped */
+	bool bMovetext = false;
+
+
+	game->text.data = p;
+	game->offset = (size_t)(p - data);
+	game->tagCount = 0;
+	game->moveCount = 0;
+	game->bError = false;
+	game->result.data = NULL; game->result.length = 0;
+	parseFEN(&game->start, startFEN);
+
+	while (p < end) {
+		char c = *p;
+
+		if (c == '[' && isLineStart(data, p) && depth == 0) {
+			if (bMovetext) { break; } /* Tags After Movetext Start The Next Game */
+
+			/* [Name "Value"] */
+			const char* q = p + 1;
+			const char* eol = (const char*)memchr(q, '\n', end - q);
+			if (eol == NULL) { eol = end; }
+			if (game->tagCount < PGN_MAX_TAGS_MACRO) {
+				pgnTag_s* tag = &game->tags[game->tagCount];
+				tag->name.data = q;
+				while (q < eol && *q != ' ' && *q != '"') { q++; }
+				tag->name.length = q - tag->name.data;
+				const char* open = (const char*)memchr(q, '"', eol - q);
+				if (open != NULL) {
+					const char* close = open + 1;
+					while (close < eol && (*close != '"' || close[-1] == '\\')) { close++; }
+					tag->value.data = open + 1;
+					tag->value.length = close - open - 1;
+					game->tagCount++;
+				}
+			}
+			p = eol < end ? eol + 1 : end;
+			continue;
+		}
+
+		if (!bMovetext && c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+			/* First Movetext Token, Set Up The Start Position */
+			bMovetext = true;
+			const pgnTag_s* fen = pgnFindTag(game, "FEN");
+			if (fen != NULL && parseFENLength(&game->start, fen->value.data, fen->value.length) == 1) {
+				parseFEN(&game->start, startFEN);
+				game->bError = true;
+			}
+			game->pos = game->start;
+		}
+
+		switch (c) {
+		case(' '): case('\t'): case('\r'): case('\n'): p++; continue;
+		case('{'): { const char* close = (const char*)memchr(p, '}', end - p); p = close ? close + 1 : end; continue; }
+		case(';'): p = pgnSkipLine(p, end); continue;
+		case('%'): if (isLineStart(data, p)) { p = pgnSkipLine(p, end); continue; } break;
+		case('('): depth++; p++; continue;
+		case(')'): if (depth > 0) { depth--; } p++; continue;
+		}
+
+		/* Whitespace Delimited Token */
+		const char* start = p;
+		while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' && *p != '{' && *p != '(' && *p != ')' && *p != ';') { p++; }
+		stringView_s token = { start, (size_t)(p - start) };
+
+		if (depth > 0 || token.data[0] == '$' || token.data[0] == '!' || token.data[0] == '?') { continue; } /* Variations, NAGs And Loose Annotations */
+
+		if (viewEquals(token, "1-0") || viewEquals(token, "0-1") || viewEquals(token, "1/2-1/2") || viewEquals(token, "*")) {
+			game->result = token;
+			continue;
+		}
+
+		/* Move Numbers, "12." Or "12..." Possibly Glued To The Move */
+		const char* q = token.data;
+		const char* tokenEnd = token.data + token.length;
+		while (q < tokenEnd && *q >= '0' && *q <= '9') { q++; }
+		if (q < tokenEnd && *q == '.' && q > token.data) {
+			while (q < tokenEnd && *q == '.') { q++; }
+			token.length = tokenEnd - q;
+			token.data = q;
+			if (token.length == 0) { continue; }
+		}
+
+		if (game->bError || game->moveCount >= MAX_GAME_PLY_MACRO) { continue; }
+		move_t m = parseSAN(&game->pos, token.data, token.length);
+		if (m == 0) { game->bError = true; continue; }
+		makeMove(&game->pos, &next, m);
+		game->pos = next;
+		game->moves[game->moveCount++] = m;
+	}
+
+	if (!bMovetext) { game->pos = game->start; }
+	game->text.length = p - game->text.data;
+	return p;
+}
+
+bool isPGNGameStart(const char* data, const char* p, const char* end) { /* p Starts A Line With The First Tag Of A Game, Decided From The Text Around p Alone */
+
+	if (!isLineStart(data, p) || p == end || *p != '[') { return false; }
+	if (end - p >= 7 && !memcmp(p, "[Event ", 7)) { return true; }
+
+	/* Games That Open With Another Tag: A Blank Line Above, And Movetext Rather Than Another Tag Above That */
+	bool bBlank = false;
+	while (p > data) {
+		const char* eol = p - 1;
+		const char* line = eol;
+		while (line > data && line[-1] != '\n') { line--; }
+		const char* c = line;
+		while (c < eol && (*c == ' ' || *c == '\t' || *c == '\r')) { c++; }
+		if (c != eol) { return bBlank && *c != '['; }
+		bBlank = true;
+		p = line;
+	}
+	return false; /* Only Whitespace Before It, The First Chunk Starts At The Top Anyway */
+}
+
+const char* pgnAlignToGame(const char* data, const char* p, const char* end) { /* First Game Start At Or After p, Where Chunks May Start */
+
+	while (p < end) {
+		if (isPGNGameStart(data, p, end)) { return p; }
+		const char* eol = (const char*)memchr(p, '\n', end - p);
+		if (eol == NULL) { return end; }
+		p = eol + 1;
+	}
+	return end;
+}
+
+DWORD WINAPI pgnWorkerThread(LPVOID param) {
+
+	pgnReader_s* reader = (pgnReader_s*)param;
+	int worker = InterlockedIncrement(&reader->nextWorker) - 1;
+	pgnStats_s* stats = &reader->workerStats[worker];
+	pgnGame_s* game = (pgnGame_s*)malloc(sizeof(pgnGame_s)); /* Too Big For Helper Thread Stacks */
+	const char* fileEnd = reader->data + reader->size;
+
+
+	if (game == NULL) { fputs("Memory error", stderr); exit(2); }
+
+	while (true) {
+		LONG chunk = InterlockedIncrement(&reader->nextChunk) - 1;
+		if (chunk >= reader->chunkCount) { break; }
+
+		/* Both Ends Snap To The Next Game Start, So Neighbouring Chunks Agree On Who Owns Each Game */
+		const char* p = chunk == 0 ? reader->data : pgnAlignToGame(reader->data, reader->data + (size_t)chunk * PGN_CHUNK_MACRO, fileEnd);
+		const char* stop = chunk + 1 == reader->chunkCount ? fileEnd : pgnAlignToGame(reader->data, reader->data + (size_t)(chunk + 1) * PGN_CHUNK_MACRO, fileEnd);
+
+		while (p < stop) {
+			const char* before = p;
+			p = pgnParseGame(reader->data, p, stop, game);
+			if (p == before) { break; }
+			if (game->tagCount == 0 && game->moveCount == 0 && !game->bError && game->result.length == 0) { continue; } /* Trailing Whitespace */
+
+			stats->games++;
+			stats->moves += game->moveCount;
+			if (game->bError) { stats->errors++; }
+			if (reader->onGame != NULL) { reader->onGame(game, worker, reader->user); }
+		}
+	}
+
+	free(game);
+	return 0;
+}
+
+int pgnReadFile(const char* filepath, int threads, pgnGameCallback_t onGame, void* user, pgnStats_s* stats) { /* Returns 1 For Error, onGame Runs On The Worker Threads */
+
+	pgnReader_s reader; /* Per Call, So Readers Can Run Side By Side */
+	mappedFile_s mf;
+	HANDLE handles[PGN_MAX_THREADS_MACRO];
+	DWORD start = timeGetTime();
+
+
+	memset(stats, 0, sizeof(pgnStats_s));
+	if (mapFile(filepath, &mf)) { return 1; }
+
+	if (threads < 1) { threads = 1; }
+	if (threads > PGN_MAX_THREADS_MACRO) { threads = PGN_MAX_THREADS_MACRO; }
+
+	memset(&reader, 0, sizeof(pgnReader_s));
+	reader.data = mf.data;
+	reader.size = mf.size;
+	reader.chunkCount = (int)((mf.size + PGN_CHUNK_MACRO - 1) / PGN_CHUNK_MACRO);
+	reader.onGame = onGame;
+	reader.user = user;
+
+	if (threads == 1 || reader.chunkCount <= 1) { pgnWorkerThread(&reader); } /* In File Order, On The Calling Thread */
+	else {
+		for (int i = 0; i < threads; i++) { handles[i] = CreateThread(NULL, 0, pgnWorkerThread, &reader, 0, NULL); }
+		WaitForMultipleObjects(threads, handles, TRUE, INFINITE);
+		for (int i = 0; i < threads; i++) { CloseHandle(handles[i]); }
+	}
+
+	for (int i = 0; i < PGN_MAX_THREADS_MACRO; i++) {
+		stats->games += reader.workerStats[i].games;
+		stats->moves += reader.workerStats[i].moves;
+		stats->errors += reader.workerStats[i].errors;
+	}
+	stats->bytes = mf.size;
+	stats->timeMs = timeGetTime() - start;
+
+	unmapFile(&mf);
+	return 0;
+}
+
+int pgnMain(int argc, char** argv) { /* jonochess --pgn <file> [threads], Replays Every Game And Reports Throughput */
+
+	pgnStats_s stats;
+	SYSTEM_INFO sysInfo;
+
+
+	if (argc < 3) { fputs("usage: jonochess --pgn <file.pgn> [threads]\n", stderr); return 1; }
+
+	GetSystemInfo(&sysInfo);
+	int threads = argc > 3 ? atoi(argv[3]) : (int)sysInfo.dwNumberOfProcessors;
+
+	initEngine();
+	if (pgnReadFile(argv[2], threads, NULL, NULL, &stats)) { fputs("File error", stderr); return 1; }
+
+	unsigned int ms = stats.timeMs ? stats.timeMs : 1;
+	fprintf(stdout, "Games: %llu (%llu with errors)\nMoves: %llu\nThreads: %d\nTime (ms): %u\nGames/second: %llu\nMoves/second: %llu\nMB/second: %.1f\n",
+		stats.games, stats.errors, stats.moves, threads, stats.timeMs, stats.games * 1000 / ms, stats.moves * 1000 / ms, stats.bytes / 1048576.0 * 1000.0 / ms);
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            PGN Writer                                                                                                      *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define PGN_MAX_TEXT_MACRO (MAX_GAME_PLY_MACRO * 12 + 1024) /* One Formatted Game, Tags Included */
+#define PGN_LINE_MACRO 80
+
+struct pgnRecord_s { /* What formatPGN() Needs To Know About A Finished Game */
+
+	const char* event = "?";
+	const char* white = "?";
+	const char* black = "?";
+	int round = 1;
+	const char* result = "*";    /* "1-0", "0-1", "1/2-1/2" Or "*" */
+	unsigned int date = 0;       /* yyyymmdd, 0 For Today */
+	int whiteElo = 0;            /* 0 Leaves The Tag Out */
+	int blackElo = 0;
+	const position_s* start;
+	const move_t* moves;
+	int moveCount;
+	const pgnTag_s* tags = NULL;         /* Written As They Are Instead Of The Tags Above, FEN Included, str Must Make Room */
+	int tagCount = 0;
+	const unsigned char* nags = NULL;    /* Per Ply, 0 For None */
+	const char* const* comments = NULL;  /* Per Ply, NULL For None, Also Needs Room In str */
+};
+
+struct pgnWriter_s { /* Games Are Queued From Any Thread And Written Out In Batches By One Background Thread */
+
+	FILE* file;
+	HANDLE thread;
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE wake;
+	char* pending;               /* Filled By pgnWriterSubmit() */
+	size_t pendingSize;
+	size_t pendingCapacity;
+	char* writing;               /* Swapped With pending, Only Touched By The Writer Thread */
+	size_t writingCapacity;
+	volatile LONG bClosing;
+	volatile LONG bError;
+	unsigned long long games;
+	unsigned long long batches;
+};
+
+
+void breakPGNLine(char* str, int* len, int* column, int tokenLength) { /* Space Or Newline Before The Next Token */
+
+	/* Wrap Before The Line Gets Too Long, Export Format Asks For Under 80 */
+	if (*column && *column + 1 + tokenLength >= PGN_LINE_MACRO) { str[(*len)++] = '\n'; *column = 0; }
+	else if (*column) { str[(*len)++] = ' '; (*column)++; }
+	*column += tokenLength;
+}
+
+void appendPGNToken(char* str, int* len, int* column, const char* token, int tokenLength) {
+
+	breakPGNLine(str, len, column, tokenLength);
+	memcpy(str + *len, token, tokenLength);
+	*len += tokenLength;
+}
+
+size_t pgnTextSize(const pgnRecord_s* record) { /* Room formatPGN() Needs For record, Moves Fit In PGN_MAX_TEXT_MACRO, Everything The Caller Supplies Is Added */
+
+	size_t size = PGN_MAX_TEXT_MACRO + strlen(record->event) + strlen(record->white) + strlen(record->black) + strlen(record->result);
+
+
+	for (int i = 0; i < record->tagCount; i++) { size += record->tags[i].name.length + record->tags[i].value.length + 6; } /* [name "value"] And Newline */
+	if (record->nags) { size += (size_t)record->moveCount * 5; }                                                              /* " $255" */
+	if (record->comments) {
+		for (int i = 0; i < record->moveCount; i++) {
+			if (record->comments[i]) { size += strlen(record->comments[i]) + 4 + 8; } /* Braces And Separators, Then The "N... " The Next Move Gets */
+		}
+	}
+	return size;
+}
+
+int formatPGN(const pgnRecord_s* record, char* str) { /* str Needs pgnTextSize(record) Chars, Returns The Length */
+
+	SYSTEMTIME now;
+	position_s pos = *record->start;
+	position_s next;
+	char fen[MAX_FEN_MACRO];
+	char token[24];
+	int len = 0;
+	int column = 0;
+
+
+	if (record->tagCount > 0) {
+		for (int i = 0; i < record->tagCount; i++) {
+			const pgnTag_s* tag = &record->tags[i];
+			len += sprintf(str + len, "[%.*s \"%.*s\"]\n", (int)tag->name.length, tag->name.data, (int)tag->value.length, tag->value.data);
+		}
+	}
+	else {
+		GetLocalTime(&now);
+		unsigned int date = record->date ? record->date : now.wYear * 10000 + now.wMonth * 100 + now.wDay;
+		len = sprintf(str, "[Event \"%s\"]\n[Site \"?\"]\n[Date \"%04u.%02u.%02u\"]\n[Round \"%d\"]\n[White \"%s\"]\n[Black \"%s\"]\n[Result \"%s\"]\n",
+			record->event, date / 10000, date / 100 % 100, date % 100, record->round, record->white, record->black, record->result);
+		if (record->whiteElo) { len += sprintf(str + len, "[WhiteElo \"%d\"]\n", record->whiteElo); }
+		if (record->blackElo) { len += sprintf(str + len, "[BlackElo \"%d\"]\n", record->blackElo); }
+
+		/* Only Games That Did Not Start From The Standard Position Need Their FEN */
+		if (pos.key != startPosition.key) {
+			positionToFEN(&pos, fen);
+			len += sprintf(str + len, "[SetUp \"1\"]\n[FEN \"%s\"]\n", fen);
+		}
+	}
+	str[len++] = '\n';
+
+	for (int i = 0; i < record->moveCount; i++) {
+		int tokenLength = 0;
+
+		if (pos.sideToMove == 0) { tokenLength = sprintf(token, "%d. ", pos.fullmoveNumber); }
+		else if (i == 0 || (record->comments && record->comments[i - 1])) { tokenLength = sprintf(token, "%d... ", pos.fullmoveNumber); }
+		tokenLength += moveToSAN(&pos, record->moves[i], token + tokenLength);
+		if (!makeMove(&pos, &next, record->moves[i])) { break; } /* Callers Only Record Legal Moves */
+		pos = next;
+		appendPGNToken(str, &len, &column, token, tokenLength);
+
+		if (record->nags && record->nags[i]) {
+			tokenLength = sprintf(token, "$%d", record->nags[i]);
+			appendPGNToken(str, &len, &column, token, tokenLength);
+		}
+		if (record->comments && record->comments[i]) {
+			breakPGNLine(str, &len, &column, (int)strlen(record->comments[i]) + 2); /* Comments Are Short, Never Worth Splitting */
+			len += sprintf(str + len, "{%s}", record->comments[i]);
+		}
+	}
+	appendPGNToken(str, &len, &column, record->result, (int)strlen(record->result));
+	len += sprintf(str + len, "\n\n");
+	return len;
+}
+
+DWORD WINAPI pgnWriterThread(LPVOID param) {
+
+	pgnWriter_s* writer = (pgnWriter_s*)param;
+
+
+	EnterCriticalSection(&writer->lock);
+	for (;;) {
+		while (writer->pendingSize == 0 && !writer->bClosing) { SleepConditionVariableCS(&writer->wake, &writer->lock, INFINITE); }
+		if (writer->pendingSize == 0) { break; } /* Closing And Nothing Left */
+
+		/* Swap Buffers So Submitters Only Wait For A Pointer Swap, Never For The Disk */
+		char* batch = writer->pending;
+		size_t size = writer->pendingSize;
+		size_t capacity = writer->pendingCapacity;
+		writer->pending = writer->writing;
+		writer->pendingCapacity = writer->writingCapacity;
+		writer->pendingSize = 0;
+		writer->writing = batch;
+		writer->writingCapacity = capacity;
+		LeaveCriticalSection(&writer->lock);
+
+		if (fwrite(batch, 1, size, writer->file) != size || fflush(writer->file)) { InterlockedExchange(&writer->bError, 1); }
+		writer->batches++;
+
+		EnterCriticalSection(&writer->lock);
+	}
+	LeaveCriticalSection(&writer->lock);
+	return 0;
+}
+
+int pgnWriterOpen(pgnWriter_s* writer, const char* path) { /* Appends, The File Stays Open Until pgnWriterClose(), Returns 1 For Error */
+
+	memset(writer, 0, sizeof(pgnWriter_s));
+	if (fopen_s(&writer->file, path, "ab") != 0) { return 1; }
+
+	InitializeCriticalSection(&writer->lock);
+	InitializeConditionVariable(&writer->wake);
+	writer->thread = CreateThread(NULL, 0, pgnWriterThread, writer, 0, NULL);
+	return 0;
+}
+
+void pgnWriterSubmit(pgnWriter_s* writer, const char* text, size_t length) { /* Only Copies Into The Queue, Safe From Any Thread */
+
+	EnterCriticalSection(&writer->lock);
+	if (writer->pendingSize + length > writer->pendingCapacity) {
+		size_t capacity = writer->pendingCapacity ? writer->pendingCapacity : PGN_MAX_TEXT_MACRO * 4;
+		while (capacity < writer->pendingSize + length) { capacity *= 2; }
+		char* grown = (char*)realloc(writer->pending, capacity);
+		if (grown == NULL) { fputs("Memory error", stderr); exit(2); }
+		writer->pending = grown;
+		writer->pendingCapacity = capacity;
+	}
+	memcpy(writer->pending + writer->pendingSize, text, length);
+	writer->pendingSize += length;
+	writer->games++;
+	WakeConditionVariable(&writer->wake);
+	LeaveCriticalSection(&writer->lock);
+}
+
+void pgnWriterSubmitGame(pgnWriter_s* writer, const pgnRecord_s* record) {
+
+	char* text = (char*)malloc(pgnTextSize(record)); /* Tags And Comments Can Make It Any Size */
+
+
+	if (text == NULL) { fputs("Memory error", stderr); exit(2); }
+	pgnWriterSubmit(writer, text, formatPGN(record, text));
+	free(text);
+}
+
+int pgnWriterClose(pgnWriter_s* writer) { /* Writes Whatever Is Still Queued, Returns 1 If Anything Failed To Reach The File */
+
+	if (writer->file == NULL) { return 0; }
+
+	EnterCriticalSection(&writer->lock);
+	InterlockedExchange(&writer->bClosing, 1);
+	WakeConditionVariable(&writer->wake);
+	LeaveCriticalSection(&writer->lock);
+
+	WaitForSingleObject(writer->thread, INFINITE);
+	CloseHandle(writer->thread);
+	DeleteCriticalSection(&writer->lock);
+
+	if (fclose(writer->file)) { writer->bError = 1; }
+	free(writer->pending);
+	free(writer->writing);
+	writer->file = NULL;
+	return writer->bError ? 1 : 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Self-Play Match                                                                                                 *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define MATCH_MAX_THREADS_MACRO 64
+
+enum gameOutcome_e {
+
+	GAME_ONGOING,
+	GAME_WHITE_WINS,
+	GAME_BLACK_WINS,
+	GAME_DRAWN
+};
+
+struct matchConfig_s {
+
+	const char* openingsPath = NULL;
+	int games = 20000;            /* Upper Bound, SPRT Usually Stops Much Earlier */
+	int concurrency = 1;          /* Games Played At Once, Each Engine Searches Single Threaded Unless Told Otherwise */
+	searchLimits_s limits;        /* Per Move Limits, Ignored When baseMs Is Set */
+	int baseMs = 0;               /* --tc base+inc Clock In Milliseconds */
+	int incMs = 0;
+	int hashMB = 16;
+	int maxPlies = 400;           /* Longer Games Are Adjudicated As Draws */
+	double elo0 = 0.0;
+	double elo1 = 5.0;
+	double alpha = 0.05;
+	double beta = 0.05;
+	const char* optionsA = "";    /* Name=Value,Name=Value Applied With searchSetOption() */
+	const char* optionsB = "";
+	const char* pgnPath = NULL;   /* --pgnout, Every Game Is Appended There */
+};
+
+struct matchState_s {
+
+	matchConfig_s config;
+	position_s* openings;
+	int openingCount;
+	int openingCapacity;
+	volatile LONG nextGame;
+	volatile LONG nextSlot;
+	volatile LONG bDone;
+	CRITICAL_SECTION lock;
+	int wins;                     /* Always From Engine A's Point Of View */
+	int losses;
+	int draws;
+	volatile LONG timeLosses;
+	double llr;
+	DWORD startTime;
+	pgnWriter_s writer;
+	searchEngine_s engines[MATCH_MAX_THREADS_MACRO][2]; /* Engine A And B For Each Thread */
+};
+
+
+int gameOutcome(const position_s* pos, const unsigned long long* keys, int keyCount, const char** reason) { /* Same Rules The Search Knows, keys Are The Positions Before pos */
+
+	move_t list[MAX_MOVES_MACRO];
+	int repeats = 0;
+
+
+	if (generateLegalMoves(pos, list) == 0) {
+		if (inCheck(pos)) { *reason = "checkmate"; return pos->sideToMove ? GAME_WHITE_WINS : GAME_BLACK_WINS; }
+		*reason = "stalemate"; return GAME_DRAWN;
+	}
+	if (pos->halfmoveClock >= 100)     { *reason = "fifty moves"; return GAME_DRAWN; }
+	if (isInsufficientMaterial(pos))   { *reason = "insufficient material"; return GAME_DRAWN; }
+
+	for (int i = keyCount - 2; i >= 0 && i >= keyCount - pos->halfmoveClock; i -= 2) {
+		if (keys[i] == pos->key && ++repeats == 2) { *reason = "threefold repetition"; return GAME_DRAWN; }
+	}
+	return GAME_ONGOING;
+}
+
+const char* outcomeToResult(int outcome) { /* PGN Result Tag */
+
+	switch (outcome) {
+	case(GAME_WHITE_WINS): return "1-0";
+	case(GAME_BLACK_WINS): return "0-1";
+	case(GAME_DRAWN):      return "1/2-1/2";
+	}
+	return "*";
+}
+
+void applyEngineOptions(searchEngine_s* engine, const char* options) { /* "LMR=false,Hash=32" */
+
+	char name[64];
+	char value[64];
+
+
+	while (*options) {
+		int n = 0;
+		while (*options && *options != '=' && *options != ',' && n < (int)sizeof(name) - 1) { name[n++] = *options++; }
+		name[n] = 0;
+		n = 0;
+		if (*options == '=') { options++; }
+		while (*options && *options != ',' && n < (int)sizeof(value) - 1) { value[n++] = *options++; }
+		value[n] = 0;
+		if (*options == ',') { options++; }
+
+		if (name[0] && !searchSetOption(engine, name, value)) { fprintf(stderr, "Unknown engine option %s\n", name); exit(1); }
+	}
+}
+
+void addMatchOpening(const position_s* pos, const char* line, size_t length, void* user) {
+
+	matchState_s* match = (matchState_s*)user;
+
+
+	if (match->openingCount == match->openingCapacity) {
+		match->openingCapacity = match->openingCapacity ? match->openingCapacity * 2 : 256;
+		match->openings = (position_s*)realloc(match->openings, sizeof(position_s) * match->openingCapacity);
+		if (match->openings == NULL) { fputs("Memory error", stderr); exit(2); }
+	}
+	match->openings[match->openingCount++] = *pos;
+}
+
+void addMatchPGNOpening(const pgnGame_s* game, int worker, void* user) { /* The Position At The End Of Each Game Is The Opening */
+
+	if (game->bError) { return; }
+	addMatchOpening(&game->pos, game->text.data, game->text.length, user);
+}
+
+void loadMatchOpenings(matchState_s* match) { /* .pgn Files By Game, Anything Else As One EPD Or FEN Per Line, What Does Not Parse Is Skipped */
+
+	const char* path = match->config.openingsPath;
+	size_t length = strlen(path);
+
+
+	if (length > 4 && !_stricmp(path + length - 4, ".pgn")) {
+		pgnStats_s stats;
+		if (pgnReadFile(path, 1, addMatchPGNOpening, match, &stats)) { fputs("File error", stderr); exit(1); } /* One Thread Keeps File Order */
+	}
+	else {
+		fenFileStats_s stats;
+		if (forEachFEN(path, addMatchOpening, match, &stats)) { fputs("File error", stderr); exit(1); }
+	}
+	if (match->openingCount == 0) { fputs("No openings in file", stderr); exit(1); }
+}
+
+double sprtScoreFromElo(double elo) { return 1.0 / (1.0 + pow(10.0, -elo / 400.0)); }
+
+double sprtLLR(int wins, int losses, int draws, double elo0, double elo1) { /* Trinomial GSPRT, Normal Approximation Of The Log Likelihood Ratio */
+
+	double n = wins + losses + draws;
+
+
+	if (n == 0) { return 0.0; }
+
+	double score = (wins + draws * 0.5) / n;
+	double variance = (wins * (1.0 - score) * (1.0 - score) + draws * (0.5 - score) * (0.5 - score) + losses * score * score) / n;
+	if (variance <= 0.0) { return 0.0; } /* One Kind Of Result So Far, Any Two Give A Usable Estimate */
+
+	double s0 = sprtScoreFromElo(elo0);
+	double s1 = sprtScoreFromElo(elo1);
+
+	return (s1 - s0) * (2.0 * score - s0 - s1) / (2.0 * variance / n);
+}
+
+void printMatchStatus(const matchState_s* match) {
+
+	int n = match->wins + match->losses + match->draws;
+	double score = n ? (match->wins + match->draws * 0.5) / n : 0.5;
+	double elo = 0.0;
+	double margin = 0.0;
+	double lower = log(match->config.beta / (1.0 - match->config.alpha));
+	double upper = log((1.0 - match->config.beta) / match->config.alpha);
+
+
+	if (n > 0 && score > 0.0 && score < 1.0) {
+		double variance = (match->wins * (1.0 - score) * (1.0 - score) + match->draws * (0.5 - score) * (0.5 - score) + match->losses * score * score) / n;
+		double deviation = sqrt(variance / n);
+		double high = score + 1.96 * deviation < 0.999 ? score + 1.96 * deviation : 0.999;
+		double low = score - 1.96 * deviation > 0.001 ? score - 1.96 * deviation : 0.001;
+		elo = -400.0 * log10(1.0 / score - 1.0);
+		margin = (-400.0 * log10(1.0 / high - 1.0) + 400.0 * log10(1.0 / low - 1.0)) / 2.0;
+	}
+
+	fprintf(stdout, "Games %d: %d - %d - %d [%.3f] Elo %+.1f +/- %.1f LLR %.2f (%.2f, %.2f) %us\n",
+		n, match->wins, match->losses, match->draws, score, elo, margin, match->llr, lower, upper, (timeGetTime() - match->startTime) / 1000);
+	fflush(stdout);
+}
+
+int playMatchGame(matchState_s* match, searchEngine_s* engineA, searchEngine_s* engineB, int gameIndex) { /* Returns Engine A's Points Times Two */
+
+	const matchConfig_s* config = &match->config;
+	position_s pos = match->openings[(gameIndex / 2) % match->openingCount];
+	position_s next;
+	unsigned long long keys[MAX_GAME_PLY_MACRO];
+	move_t moves[MAX_GAME_PLY_MACRO];
+	int keyCount = 0;
+	int clock[2] = { config->baseMs, config->baseMs };
+	bool bAWhite = (gameIndex & 1) == 0; /* Both Games Of A Pair Start From The Same Opening With Colours Swapped */
+	const char* reason = "";
+	int outcome;
+
+
+	searchClearHistory(engineA);
+	searchClearHistory(engineB);
+
+	while ((outcome = gameOutcome(&pos, keys, keyCount, &reason)) == GAME_ONGOING) {
+		searchEngine_s* engine = (pos.sideToMove == 0) == bAWhite ? engineA : engineB;
+		searchLimits_s limits = config->limits;
+		int us = pos.sideToMove;
+
+		if (keyCount >= config->maxPlies || keyCount >= MAX_GAME_PLY_MACRO - 1) { outcome = GAME_DRAWN; reason = "move limit"; break; }
+
+		if (config->baseMs > 0) {
+			memset(&limits, 0, sizeof(searchLimits_s));
+			limits.time[0] = clock[0]; limits.time[1] = clock[1];
+			limits.inc[0] = limits.inc[1] = config->incMs;
+		}
+
+		DWORD start = timeGetTime();
+		move_t m = searchRun(engine, &pos, keys, keyCount, &limits);
+
+		if (config->baseMs > 0) {
+			clock[us] -= (int)(timeGetTime() - start);
+			if (clock[us] < 0) {
+				outcome = us ? GAME_WHITE_WINS : GAME_BLACK_WINS;
+				reason = "time forfeit";
+				InterlockedIncrement(&match->timeLosses);
+				break;
+			}
+			clock[us] += config->incMs;
+		}
+
+		if (m == 0 || !makeMove(&pos, &next, m)) { fputs("Engine returned an illegal move", stderr); exit(1); }
+		moves[keyCount] = m;
+		keys[keyCount++] = pos.key;
+		pos = next;
+	}
+
+	if (config->pgnPath) {
+		pgnRecord_s record;
+		record.event = "jonochess match";
+		record.white = bAWhite ? "A" : "B";
+		record.black = bAWhite ? "B" : "A";
+		record.round = gameIndex + 1;
+		record.result = outcomeToResult(outcome);
+		record.start = &match->openings[(gameIndex / 2) % match->openingCount];
+		record.moves = moves;
+		record.moveCount = keyCount;
+		pgnWriterSubmitGame(&match->writer, &record);
+	}
+
+	if (outcome == GAME_DRAWN) { return 1; }
+	return (outcome == GAME_WHITE_WINS) == bAWhite ? 2 : 0;
+}
+
+DWORD WINAPI matchThread(LPVOID param) {
+
+	matchState_s* match = (matchState_s*)param;
+	searchEngine_s* engines = match->engines[InterlockedIncrement(&match->nextSlot) - 1];
+
+
+	for (int i = 0; i < 2; i++) {
+		searchInit(&engines[i], NULL, match->config.hashMB, 1);
+		applyEngineOptions(&engines[i], i ? match->config.optionsB : match->config.optionsA);
+	}
+
+	while (!match->bDone) {
+		int game = InterlockedIncrement(&match->nextGame) - 1;
+		if (game >= match->config.games) { break; }
+
+		int points = playMatchGame(match, &engines[0], &engines[1], game);
+
+		EnterCriticalSection(&match->lock);
+		if (points == 2) { match->wins++; }
+		else if (points == 0) { match->losses++; }
+		else { match->draws++; }
+
+		match->llr = sprtLLR(match->wins, match->losses, match->draws, match->config.elo0, match->config.elo1);
+		int played = match->wins + match->losses + match->draws;
+		bool bDecided = match->llr <= log(match->config.beta / (1.0 - match->config.alpha)) || match->llr >= log((1.0 - match->config.beta) / match->config.alpha);
+
+		if (!match->bDone && played % 10 == 0) { printMatchStatus(match); }
+		if (bDecided) { InterlockedExchange(&match->bDone, 1); }
+		LeaveCriticalSection(&match->lock);
+	}
+
+	for (int i = 0; i < 2; i++) { searchFree(&engines[i]); }
+	return 0;
+}
+
+int matchMain(int argc, char** argv) { /* jonochess --match <openings.epd|openings.pgn> [options], Engine A Is The Candidate, B The Baseline */
+
+	static matchState_s matchState; /* Too Big For The Stack */
+	matchState_s* match = &matchState;
+	matchConfig_s* config = &match->config;
+	HANDLE threads[MATCH_MAX_THREADS_MACRO];
+
+
+	for (int i = 2; i < argc; i++) {
+		bool bValue = i + 1 < argc;
+		if (argv[i][0] != '-')                                     { config->openingsPath = argv[i]; }
+		else if (bValue && !strcmp(argv[i], "--games"))            { config->games = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--concurrency"))      { config->concurrency = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--nodes"))            { config->limits.nodes = strtoull(argv[++i], NULL, 10); }
+		else if (bValue && !strcmp(argv[i], "--depth"))            { config->limits.depth = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--movetime"))         { config->limits.movetime = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--tc"))               { sscanf_s(argv[++i], "%d+%d", &config->baseMs, &config->incMs); }
+		else if (bValue && !strcmp(argv[i], "--hash"))             { config->hashMB = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--maxplies"))         { config->maxPlies = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--elo0"))             { config->elo0 = atof(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--elo1"))             { config->elo1 = atof(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--alpha"))            { config->alpha = atof(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--beta"))             { config->beta = atof(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--a"))                { config->optionsA = argv[++i]; }
+		else if (bValue && !strcmp(argv[i], "--b"))                { config->optionsB = argv[++i]; }
+		else if (bValue && !strcmp(argv[i], "--pgnout"))           { config->pgnPath = argv[++i]; }
+		else { fprintf(stderr, "Unknown match argument %s\n", argv[i]); return 1; }
+	}
+
+	if (config->openingsPath == NULL) {
+		fputs("usage: jonochess --match <openings.epd|openings.pgn> [--games N] [--concurrency N] [--nodes N | --depth N | --movetime ms | --tc ms+ms] "
+			"[--hash MB] [--maxplies N] [--elo0 E] [--elo1 E] [--alpha A] [--beta B] [--a Name=Value,...] [--b Name=Value,...] [--pgnout games.pgn]\n", stderr);
+		return 1;
+	}
+	if (config->concurrency < 1) { config->concurrency = 1; }
+	if (config->concurrency > MATCH_MAX_THREADS_MACRO) { config->concurrency = MATCH_MAX_THREADS_MACRO; }
+	if (config->games < 1) { config->games = 1; }
+	if (config->baseMs == 0 && config->limits.nodes == 0 && config->limits.depth == 0 && config->limits.movetime == 0) { config->limits.nodes = 20000; }
+
+	initEngine();
+	loadMatchOpenings(match);
+	if (config->pgnPath && pgnWriterOpen(&match->writer, config->pgnPath) == 1) { fputs("File error", stderr); exit(1); }
+	InitializeCriticalSection(&match->lock);
+	match->startTime = timeGetTime();
+
+	fprintf(stdout, "Match: %d openings, up to %d games, concurrency %d, A \"%s\" vs B \"%s\", SPRT elo0 %.1f elo1 %.1f alpha %.3f beta %.3f\n",
+		match->openingCount, config->games, config->concurrency, config->optionsA, config->optionsB, config->elo0, config->elo1, config->alpha, config->beta);
+
+	for (int i = 0; i < config->concurrency; i++) { threads[i] = CreateThread(NULL, 0, matchThread, match, 0, NULL); }
+	WaitForMultipleObjects(config->concurrency, threads, TRUE, INFINITE);
+	for (int i = 0; i < config->concurrency; i++) { CloseHandle(threads[i]); }
+
+	printMatchStatus(match);
+	if (match->timeLosses) { fprintf(stdout, "Time forfeits: %ld\n", match->timeLosses); }
+
+	int result = 0;
+	if (match->llr >= log((1.0 - config->beta) / config->alpha))       { fputs("SPRT: H1 accepted, A is stronger\n", stdout); }
+	else if (match->llr <= log(config->beta / (1.0 - config->alpha)))  { fputs("SPRT: H0 accepted, A is not stronger\n", stdout); result = 1; }
+	else { fputs("SPRT: inconclusive\n", stdout); result = 2; }
+
+	if (config->pgnPath) {
+		if (pgnWriterClose(&match->writer) == 1) { fputs("File error", stderr); exit(1); }
+		fprintf(stdout, "Saved %llu games to %s in %llu writes\n", match->writer.games, config->pgnPath, match->writer.batches);
+	}
+
+	DeleteCriticalSection(&match->lock);
+	free(match->openings);
+	return result;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Game Database                                                                                                   *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define GAMEDB_MAGIC_MACRO 0x4244434A   /* "JCDB" In A Little Endian File */
+#define GAMEDB_VERSION_MACRO 1         /* Bump Whenever generateMoves() Changes Its Move Order, Moves Are Stored As Indices Into It */
+#define GAMEDB_FEN_FLAG 1               /* Game Data Starts With A Length Prefixed FEN */
+#define GAMEDB_TRUNCATED_FLAG 2         /* The PGN Had A Move That Did Not Decode, plies Stops Before It */
+
+struct gameDBHeader_s {
+
+	unsigned int magic;
+	unsigned int version;
+	unsigned int gameCount;
+	unsigned int entrySize;              /* sizeof(gameDBEntry_s), Catches Files From A Different Build */
+	unsigned long long dataOffset;       /* Move Data Follows The Entry Table */
+	unsigned long long dataSize;
+};
+
+struct gameDBEntry_s { /* Fixed Size, So Game N Is entries[N] */
+
+	unsigned long long offset;           /* Of The Game's Data From The Start Of The File */
+	unsigned int date;                   /* yyyymmdd, Unknown Parts Are 0 */
+	unsigned short whiteElo;             /* 0 Where Unknown */
+	unsigned short blackElo;
+	unsigned short plies;                /* One Byte Each In The Game's Data */
+	unsigned char result;                /* gameOutcome_e, GAME_ONGOING For "*" */
+	unsigned char flags;
+	unsigned int reserved;
+};
+
+struct gameDB_s { /* Read Only, Straight From The Mapped File */
+
+	mappedFile_s file;
+	const gameDBHeader_s* header;
+	const gameDBEntry_s* entries;
+	unsigned int count;
+};
+
+struct gameDBPending_s { /* One Imported Game Before The File Is Laid Out */
+
+	size_t source;                       /* Offset In The PGN, Restores File Order After The Parallel Import */
+	gameDBEntry_s entry;                 /* offset Points Into gameDBBuilder_s.data Until Written */
+	unsigned int size;
+};
+
+struct gameDBBuilder_s { /* Shared By The PGN Worker Threads */
+
+	CRITICAL_SECTION lock;
+	gameDBPending_s* games;
+	int count;
+	int capacity;
+	unsigned char* data;
+	size_t dataSize;
+	size_t dataCapacity;
+	unsigned long long truncated;
+};
+
+
+int gameDBEncodeMove(const position_s* pos, move_t m) { /* Index In generateLegalMoves() Order, -1 If m Is Not Legal */
+
+	move_t list[MAX_MOVES_MACRO];
+
+
+	int n = generateLegalMoves(pos, list);
+	for (int i = 0; i < n; i++) {
+		if (list[i] == m) { return i; }
+	}
+	return -1;
+}
+
+move_t gameDBDecodeMove(const position_s* pos, int index) { /* Returns 0 If index Is Out Of Range */
+
+	move_t list[MAX_MOVES_MACRO];
+
+
+	int n = generateLegalMoves(pos, list);
+	return index >= 0 && index < n ? list[index] : 0;
+}
+
+int viewToInt(stringView_s view) { /* Leading Digits Only, 0 If There Are None */
+
+	int value = 0;
+
+
+	for (size_t i = 0; i < view.length && view.data[i] >= '0' && view.data[i] <= '9'; i++) { value = value * 10 + view.data[i] - '0'; }
+	return value;
+}
+
+void gameDBAddGame(const pgnGame_s* game, int worker, void* user) { /* pgnGameCallback_t, Runs On The PGN Worker Threads */
+
+	gameDBBuilder_s* builder = (gameDBBuilder_s*)user;
+	unsigned char data[1 + MAX_FEN_MACRO + MAX_GAME_PLY_MACRO];
+	gameDBPending_s pending;
+	position_s pos = game->start;
+	position_s next;
+	const pgnTag_s* tag;
+	unsigned int size = 0;
+
+
+	memset(&pending, 0, sizeof(gameDBPending_s));
+	pending.source = game->offset;
+
+	/* Games That Do Not Start From The Standard Position Carry Their FEN */
+	if (game->start.key != startPosition.key) {
+		char fen[MAX_FEN_MACRO];
+		int length = positionToFEN(&game->start, fen);
+		data[size++] = (unsigned char)length;
+		memcpy(data + size, fen, length);
+		size += length;
+		pending.entry.flags |= GAMEDB_FEN_FLAG;
+	}
+
+	/* Encoded Outside The Lock, That Is Where The Time Goes */
+	for (int i = 0; i < game->moveCount; i++) {
+		data[size++] = (unsigned char)gameDBEncodeMove(&pos, game->moves[i]);
+		makeMove(&pos, &next, game->moves[i]);
+		pos = next;
+	}
+	if (game->bError) { pending.entry.flags |= GAMEDB_TRUNCATED_FLAG; }
+
+	pending.entry.plies = (unsigned short)game->moveCount;
+	pending.entry.result = viewEquals(game->result, "1-0") ? GAME_WHITE_WINS : viewEquals(game->result, "0-1") ? GAME_BLACK_WINS :
+		viewEquals(game->result, "1/2-1/2") ? GAME_DRAWN : GAME_ONGOING;
+	if ((tag = pgnFindTag(game, "WhiteElo")) != NULL) { pending.entry.whiteElo = (unsigned short)viewToInt(tag->value); }
+	if ((tag = pgnFindTag(game, "BlackElo")) != NULL) { pending.entry.blackElo = (unsigned short)viewToInt(tag->value); }
+	if ((tag = pgnFindTag(game, "Date")) != NULL && tag->value.length >= 10) { /* yyyy.mm.dd, ?? Parts Read As 0 */
+		stringView_s part = tag->value;
+		unsigned int year = viewToInt(part);
+		part.data += 5; part.length -= 5;
+		unsigned int month = viewToInt(part);
+		part.data += 3; part.length -= 3;
+		pending.entry.date = year * 10000 + month * 100 + viewToInt(part);
+	}
+	pending.size = size;
+
+	EnterCriticalSection(&builder->lock);
+	if (builder->count == builder->capacity) {
+		builder->capacity = builder->capacity ? builder->capacity * 2 : 4096;
+		builder->games = (gameDBPending_s*)realloc(builder->games, builder->capacity * sizeof(gameDBPending_s));
+		if (builder->games == NULL) { fputs("Memory error", stderr); exit(2); }
+	}
+	if (builder->dataSize + size > builder->dataCapacity) {
+		builder->dataCapacity = builder->dataCapacity ? builder->dataCapacity * 2 : 1 << 20;
+		builder->data = (unsigned char*)realloc(builder->data, builder->dataCapacity);
+		if (builder->data == NULL) { fputs("Memory error", stderr); exit(2); }
+	}
+	pending.entry.offset = builder->dataSize;
+	memcpy(builder->data + builder->dataSize, data, size);
+	builder->dataSize += size;
+	builder->games[builder->count++] = pending;
+	if (game->bError) { builder->truncated++; }
+	LeaveCriticalSection(&builder->lock);
+}
+
+int compareGameDBPending(const void* a, const void* b) {
+
+	size_t x = ((const gameDBPending_s*)a)->source;
+	size_t y = ((const gameDBPending_s*)b)->source;
+	return x < y ? -1 : x > y ? 1 : 0;
+}
+
+int writeGameDB(const char* filepath, gameDBBuilder_s* builder) { /* Returns 1 For Error, Games Come Out In PGN File Order */
+
+	gameDBHeader_s header;
+	FILE* file;
+	unsigned long long offset;
+
+
+	qsort(builder->games, builder->count, sizeof(gameDBPending_s), compareGameDBPending);
+
+	memset(&header, 0, sizeof(gameDBHeader_s));
+	header.magic = GAMEDB_MAGIC_MACRO;
+	header.version = GAMEDB_VERSION_MACRO;
+	header.gameCount = builder->count;
+	header.entrySize = sizeof(gameDBEntry_s);
+	header.dataOffset = sizeof(gameDBHeader_s) + (unsigned long long)builder->count * sizeof(gameDBEntry_s);
+	header.dataSize = builder->dataSize;
+
+	if (fopen_s(&file, filepath, "wb") != 0) { return 1; }
+	bool bOk = fwrite(&header, sizeof(gameDBHeader_s), 1, file) == 1;
+
+	offset = header.dataOffset;
+	for (int i = 0; i < builder->count && bOk; i++) {
+		gameDBEntry_s entry = builder->games[i].entry;
+		entry.offset = offset;
+		offset += builder->games[i].size;
+		bOk = fwrite(&entry, sizeof(gameDBEntry_s), 1, file) == 1;
+	}
+	for (int i = 0; i < builder->count && bOk; i++) {
+		const gameDBPending_s* game = &builder->games[i];
+		bOk = game->size == 0 || fwrite(builder->data + game->entry.offset, game->size, 1, file) == 1;
+	}
+
+	if (fclose(file) != 0) { bOk = false; }
+	return bOk ? 0 : 1;
+}
+
+int openGameDB(const char* filepath, gameDB_s* db) { /* Returns 1 For Error, Including Files That Do Not Look Like A Game Database */
+
+	memset(db, 0, sizeof(gameDB_s));
+	if (mapFile(filepath, &db->file)) { return 1; }
+
+	db->header = (const gameDBHeader_s*)db->file.data;
+	if (db->file.size < sizeof(gameDBHeader_s) || db->header->magic != GAMEDB_MAGIC_MACRO || db->header->version != GAMEDB_VERSION_MACRO ||
+		db->header->entrySize != sizeof(gameDBEntry_s) || db->header->dataOffset + db->header->dataSize > db->file.size ||
+		sizeof(gameDBHeader_s) + (unsigned long long)db->header->gameCount * sizeof(gameDBEntry_s) > db->header->dataOffset) {
+		unmapFile(&db->file);
+		return 1;
+	}
+
+	db->entries = (const gameDBEntry_s*)(db->file.data + sizeof(gameDBHeader_s));
+	db->count = db->header->gameCount;
+	return 0;
+}
+
+void closeGameDB(gameDB_s* db) {
+
+	unmapFile(&db->file);
+	memset(db, 0, sizeof(gameDB_s));
+}
+
+int readGameDB(const gameDB_s* db, unsigned int index, position_s* start, move_t* moves) { /* Returns The Ply Count, -1 If index Or The Game Is Bad */
+
+	position_s pos;
+	position_s next;
+
+
+	if (index >= db->count) { return -1; }
+	const gameDBEntry_s* entry = &db->entries[index];
+	const unsigned char* p = (const unsigned char*)db->file.data + entry->offset;
+	const unsigned char* end = (const unsigned char*)db->file.data + db->header->dataOffset + db->header->dataSize;
+
+	if (entry->offset < db->header->dataOffset || entry->offset > db->header->dataOffset + db->header->dataSize) { return -1; }
+	if (entry->flags & GAMEDB_FEN_FLAG) {
+		if (p >= end || p + 1 + *p > end || parseFENLength(start, (const char*)p + 1, *p) == 1) { return -1; }
+		p += 1 + *p;
+	}
+	else { *start = startPosition; }
+	if (p + entry->plies > end || entry->plies > MAX_GAME_PLY_MACRO) { return -1; }
+
+	pos = *start;
+	for (int i = 0; i < entry->plies; i++) {
+		moves[i] = gameDBDecodeMove(&pos, p[i]);
+		if (moves[i] == 0 || !makeMove(&pos, &next, moves[i])) { return -1; }
+		pos = next;
+	}
+	return entry->plies;
+}
+
+int pgnToGameDBMain(int argc, char** argv) { /* jonochess --pgn2db <file.pgn> <file.jcdb> [threads] */
+
+	static gameDBBuilder_s builder;
+	pgnStats_s stats;
+	SYSTEM_INFO sysInfo;
+
+
+	if (argc < 4) { fputs("usage: jonochess --pgn2db <file.pgn> <file.jcdb> [threads]\n", stderr); return 1; }
+
+	GetSystemInfo(&sysInfo);
+	int threads = argc > 4 ? atoi(argv[4]) : (int)sysInfo.dwNumberOfProcessors;
+
+	initEngine();
+	InitializeCriticalSection(&builder.lock);
+	if (pgnReadFile(argv[2], threads, gameDBAddGame, &builder, &stats)) { fputs("File error", stderr); return 1; }
+
+	DWORD start = timeGetTime();
+	if (writeGameDB(argv[3], &builder)) { fputs("File error", stderr); return 1; }
+	DWORD writeMs = timeGetTime() - start;
+
+	unsigned long long dbSize = sizeof(gameDBHeader_s) + (unsigned long long)builder.count * sizeof(gameDBEntry_s) + builder.dataSize;
+	fprintf(stdout, "Games: %d (%llu truncated)\nPlies: %llu\nThreads: %d\nImport time (ms): %u\nWrite time (ms): %u\nPGN size: %llu bytes\nDatabase size: %llu bytes (%.1fx smaller, %.2f bytes/ply)\n",
+		builder.count, builder.truncated, stats.moves, threads, stats.timeMs, writeMs, stats.bytes, dbSize,
+		(double)stats.bytes / (dbSize ? dbSize : 1), stats.moves ? (double)dbSize / stats.moves : 0.0);
+
+	DeleteCriticalSection(&builder.lock);
+	free(builder.games);
+	free(builder.data);
+	return 0;
+}
+
+int gameDBMain(int argc, char** argv) { /* jonochess --db <file.jcdb> [game], Replays Everything Or Prints Game N As PGN */
+
+	static move_t moves[MAX_GAME_PLY_MACRO];
+	static char text[PGN_MAX_TEXT_MACRO];
+	gameDB_s db;
+	position_s start;
+	unsigned long long plies = 0;
+	int errors = 0;
+
+
+	if (argc < 3) { fputs("usage: jonochess --db <file.jcdb> [game number]\n", stderr); return 1; }
+
+	initEngine();
+	if (openGameDB(argv[2], &db)) { fputs("File error", stderr); return 1; }
+
+	/* Random Access, Straight To The Entry */
+	if (argc > 3) {
+		unsigned int index = (unsigned int)strtoul(argv[3], NULL, 10) - 1;
+		int n = readGameDB(&db, index, &start, moves);
+		if (n < 0) { fprintf(stderr, "No game %s in %s\n", argv[3], argv[2]); closeGameDB(&db); return 1; }
+
+		pgnRecord_s record;
+		record.round = index + 1;
+		record.result = outcomeToResult(db.entries[index].result);
+		record.date = db.entries[index].date;
+		record.whiteElo = db.entries[index].whiteElo;
+		record.blackElo = db.entries[index].blackElo;
+		record.start = &start;
+		record.moves = moves;
+		record.moveCount = n;
+		fwrite(text, 1, formatPGN(&record, text), stdout);
+		closeGameDB(&db);
+		return 0;
+	}
+
+	DWORD begin = timeGetTime();
+	for (unsigned int i = 0; i < db.count; i++) {
+		int n = readGameDB(&db, i, &start, moves);
+		if (n < 0) { errors++; }
+		else { plies += n; }
+	}
+	DWORD ms = timeGetTime() - begin;
+	if (ms == 0) { ms = 1; }
+
+	fprintf(stdout, "Games: %u (%d unreadable)\nPlies: %llu\nTime (ms): %u\nGames/second: %llu\nPlies/second: %llu\n",
+		db.count, errors, plies, ms, (unsigned long long)db.count * 1000 / ms, plies * 1000 / ms);
+	closeGameDB(&db);
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Position Index                                                                                                  *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define POSINDEX_MAGIC_MACRO 0x5850434A   /* "JCPX" In A Little Endian File */
+#define POSINDEX_VERSION_MACRO 1
+#define POSINDEX_BLOCK_MACRO 4096         /* Entries Per Sorted Block, One Fence Key Each */
+#define POSINDEX_RUN_MACRO (4 << 20)      /* Entries A Worker Sorts In Memory Before Spilling A Run, 64 MB */
+#define POSINDEX_MAX_RUNS_MACRO 4096
+#define POSINDEX_PATH_MACRO 280           /* Index Path Plus ".runNNNN" */
+
+struct positionIndexHeader_s {
+
+	unsigned int magic;
+	unsigned int version;
+	unsigned int blockEntries;
+	unsigned int blockCount;
+	unsigned long long entryCount;
+	unsigned long long fenceOffset;      /* First Key Of Every Block, After The Entries */
+};
+
+struct positionIndexEntry_s { /* Sorted By key, Then game, Then ply */
+
+	unsigned long long key;
+	unsigned int game;                   /* 0 Based Index Into The Game Database */
+	unsigned short ply;                  /* Position After This Many Plies, 0 Is The Start */
+	unsigned short reserved;
+};
+
+struct positionIndex_s {
+
+	mappedFile_s file;
+	const positionIndexHeader_s* header;
+	const positionIndexEntry_s* entries;
+	unsigned long long* fences;          /* Copied Out Of The File So Lookups Only Touch The Mapping For One Block */
+};
+
+struct positionIndexBuilder_s { /* Shared By The Build Threads */
+
+	const gameDB_s* db;
+	const char* path;
+	int threads;
+	volatile LONG nextWorker;
+	CRITICAL_SECTION lock;
+	char runPaths[POSINDEX_MAX_RUNS_MACRO][POSINDEX_PATH_MACRO];
+	int runCount;
+};
+
+struct positionIndexRun_s { /* One Sorted Run Being Merged */
+
+	mappedFile_s file;
+	const positionIndexEntry_s* next;
+	const positionIndexEntry_s* end;
+};
+
+
+inline bool positionIndexLess(const positionIndexEntry_s* a, const positionIndexEntry_s* b) {
+
+	if (a->key != b->key) { return a->key < b->key; }
+	if (a->game != b->game) { return a->game < b->game; }
+	return a->ply < b->ply;
+}
+
+int comparePositionIndexEntry(const void* a, const void* b) {
+
+	if (positionIndexLess((const positionIndexEntry_s*)a, (const positionIndexEntry_s*)b)) { return -1; }
+	if (positionIndexLess((const positionIndexEntry_s*)b, (const positionIndexEntry_s*)a)) { return 1; }
+	return 0;
+}
+
+void spillPositionRun(positionIndexBuilder_s* builder, positionIndexEntry_s* entries, size_t count) { /* Sorts And Writes One Run File */
+
+	char path[POSINDEX_PATH_MACRO];
+	FILE* file;
+
+
+	qsort(entries, count, sizeof(positionIndexEntry_s), comparePositionIndexEntry);
+
+	EnterCriticalSection(&builder->lock);
+	if (builder->runCount == POSINDEX_MAX_RUNS_MACRO) { fputs("Too many index runs", stderr); exit(2); }
+	int run = builder->runCount++;
+	sprintf(builder->runPaths[run], "%s.run%d", builder->path, run);
+	strcpy(path, builder->runPaths[run]);
+	LeaveCriticalSection(&builder->lock);
+
+	if (fopen_s(&file, path, "wb") != 0) { fputs("File error", stderr); exit(1); }
+	if (fwrite(entries, sizeof(positionIndexEntry_s), count, file) != count || fclose(file) != 0) { fputs("File error", stderr); exit(1); }
+}
+
+DWORD WINAPI positionIndexThread(LPVOID param) { /* Every Position Of A Contiguous Slice Of Games, Spilled As Sorted Runs */
+
+	positionIndexBuilder_s* builder = (positionIndexBuilder_s*)param;
+	int worker = InterlockedIncrement(&builder->nextWorker) - 1;
+	unsigned int first = (unsigned int)((unsigned long long)builder->db->count * worker / builder->threads);
+	unsigned int last = (unsigned int)((unsigned long long)builder->db->count * (worker + 1) / builder->threads);
+	positionIndexEntry_s* entries = (positionIndexEntry_s*)malloc(POSINDEX_RUN_MACRO * sizeof(positionIndexEntry_s));
+	move_t* moves = (move_t*)malloc(MAX_GAME_PLY_MACRO * sizeof(move_t));
+	size_t count = 0;
+	position_s pos;
+	position_s next;
+
+
+	if (entries == NULL || moves == NULL) { fputs("Memory error", stderr); exit(2); }
+
+	for (unsigned int game = first; game < last; game++) {
+		int n = readGameDB(builder->db, game, &pos, moves);
+		if (n < 0) { continue; }
+
+		if (count + n + 1 > POSINDEX_RUN_MACRO) { spillPositionRun(builder, entries, count); count = 0; }
+		for (int ply = 0; ply <= n; ply++) {
+			entries[count].key = pos.key;
+			entries[count].game = game;
+			entries[count].ply = (unsigned short)ply;
+			entries[count].reserved = 0;
+			count++;
+			if (ply < n) { makeMove(&pos, &next, moves[ply]); pos = next; }
+		}
+	}
+	if (count) { spillPositionRun(builder, entries, count); }
+
+	free(entries);
+	free(moves);
+	return 0;
+}
+
+void siftPositionRuns(positionIndexRun_s** heap, int count, int i) { /* Min Heap On Each Run's Next Entry */
+
+	while (true) {
+		int smallest = i;
+		int left = 2 * i + 1;
+		int right = left + 1;
+		if (left < count && positionIndexLess(heap[left]->next, heap[smallest]->next))   { smallest = left; }
+		if (right < count && positionIndexLess(heap[right]->next, heap[smallest]->next)) { smallest = right; }
+		if (smallest == i) { return; }
+		positionIndexRun_s* swap = heap[i]; heap[i] = heap[smallest]; heap[smallest] = swap;
+		i = smallest;
+	}
+}
+
+int mergePositionRuns(positionIndexBuilder_s* builder) { /* Returns 1 For Error, Writes The Final Index From The Sorted Runs */
+
+	static positionIndexRun_s runs[POSINDEX_MAX_RUNS_MACRO];
+	static positionIndexRun_s* heap[POSINDEX_MAX_RUNS_MACRO];
+	positionIndexHeader_s header;
+	unsigned long long* fences = NULL;
+	int fenceCapacity = 0;
+	int heapCount = 0;
+	FILE* file;
+
+
+	memset(&header, 0, sizeof(positionIndexHeader_s));
+	header.magic = POSINDEX_MAGIC_MACRO;
+	header.version = POSINDEX_VERSION_MACRO;
+	header.blockEntries = POSINDEX_BLOCK_MACRO;
+
+	for (int i = 0; i < builder->runCount; i++) {
+		if (mapFile(builder->runPaths[i], &runs[i].file)) { return 1; }
+		runs[i].next = (const positionIndexEntry_s*)runs[i].file.data;
+		runs[i].end = runs[i].next + runs[i].file.size / sizeof(positionIndexEntry_s);
+		if (runs[i].next < runs[i].end) { heap[heapCount++] = &runs[i]; }
+	}
+	for (int i = heapCount / 2 - 1; i >= 0; i--) { siftPositionRuns(heap, heapCount, i); }
+
+	if (fopen_s(&file, builder->path, "wb") != 0) { return 1; }
+	setvbuf(file, NULL, _IOFBF, 1 << 20);
+	bool bOk = fwrite(&header, sizeof(positionIndexHeader_s), 1, file) == 1;
+
+	while (heapCount && bOk) {
+		positionIndexRun_s* run = heap[0];
+		if (header.entryCount % POSINDEX_BLOCK_MACRO == 0) { /* New Block, Remember Its First Key */
+			if ((int)header.blockCount == fenceCapacity) {
+				fenceCapacity = fenceCapacity ? fenceCapacity * 2 : 1024;
+				fences = (unsigned long long*)realloc(fences, fenceCapacity * sizeof(unsigned long long));
+				if (fences == NULL) { fputs("Memory error", stderr); exit(2); }
+			}
+			fences[header.blockCount++] = run->next->key;
+		}
+		bOk = fwrite(run->next, sizeof(positionIndexEntry_s), 1, file) == 1;
+		header.entryCount++;
+
+		if (++run->next == run->end) { heap[0] = heap[--heapCount]; }
+		siftPositionRuns(heap, heapCount, 0);
+	}
+
+	header.fenceOffset = sizeof(positionIndexHeader_s) + header.entryCount * sizeof(positionIndexEntry_s);
+	if (bOk && header.blockCount) { bOk = fwrite(fences, sizeof(unsigned long long), header.blockCount, file) == header.blockCount; }
+	if (bOk) { bOk = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(positionIndexHeader_s), 1, file) == 1; }
+	if (fclose(file) != 0) { bOk = false; }
+
+	for (int i = 0; i < builder->runCount; i++) {
+		unmapFile(&runs[i].file);
+		remove(builder->runPaths[i]);
+	}
+	free(fences);
+	return bOk ? 0 : 1;
+}
+
+int buildPositionIndex(const gameDB_s* db, const char* filepath, int threads) { /* Returns 1 For Error */
+
+	static positionIndexBuilder_s builder;
+	HANDLE handles[MATCH_MAX_THREADS_MACRO];
+
+
+	if (strlen(filepath) + 16 > POSINDEX_PATH_MACRO) { return 1; }
+	if (threads < 1) { threads = 1; }
+	if (threads > MATCH_MAX_THREADS_MACRO) { threads = MATCH_MAX_THREADS_MACRO; }
+
+	memset(&builder, 0, sizeof(positionIndexBuilder_s));
+	builder.db = db;
+	builder.path = filepath;
+	builder.threads = threads;
+	InitializeCriticalSection(&builder.lock);
+
+	if (threads == 1) { positionIndexThread(&builder); }
+	else {
+		for (int i = 0; i < threads; i++) { handles[i] = CreateThread(NULL, 0, positionIndexThread, &builder, 0, NULL); }
+		WaitForMultipleObjects(threads, handles, TRUE, INFINITE);
+		for (int i = 0; i < threads; i++) { CloseHandle(handles[i]); }
+	}
+
+	int result = mergePositionRuns(&builder);
+	DeleteCriticalSection(&builder.lock);
+	return result;
+}
+
+int openPositionIndex(const char* filepath, positionIndex_s* index) { /* Returns 1 For Error */
+
+	memset(index, 0, sizeof(positionIndex_s));
+	if (mapFile(filepath, &index->file)) { return 1; }
+
+	index->header = (const positionIndexHeader_s*)index->file.data;
+	if (index->file.size < sizeof(positionIndexHeader_s) || index->header->magic != POSINDEX_MAGIC_MACRO || index->header->version != POSINDEX_VERSION_MACRO ||
+		index->header->blockEntries == 0 || index->header->fenceOffset != sizeof(positionIndexHeader_s) + index->header->entryCount * sizeof(positionIndexEntry_s) ||
+		index->header->fenceOffset + index->header->blockCount * sizeof(unsigned long long) > index->file.size ||
+		index->header->blockCount != (index->header->entryCount + index->header->blockEntries - 1) / index->header->blockEntries) {
+		unmapFile(&index->file);
+		return 1;
+	}
+
+	index->entries = (const positionIndexEntry_s*)(index->file.data + sizeof(positionIndexHeader_s));
+	index->fences = (unsigned long long*)malloc(index->header->blockCount * sizeof(unsigned long long) + 1);
+	if (index->fences == NULL) { fputs("Memory error", stderr); exit(2); }
+	memcpy(index->fences, index->file.data + index->header->fenceOffset, index->header->blockCount * sizeof(unsigned long long));
+	return 0;
+}
+
+void closePositionIndex(positionIndex_s* index) {
+
+	unmapFile(&index->file);
+	free(index->fences);
+	memset(index, 0, sizeof(positionIndex_s));
+}
+
+unsigned long long positionIndexBound(const positionIndex_s* index, unsigned long long key, bool bUpper) { /* First Entry With A Key >= key, Or > key For bUpper */
+
+	unsigned int lowBlock = 0;
+	unsigned int highBlock = index->header->blockCount;
+
+
+	/* The Fences Pick The Block, Only That Block Of The Mapping Is Read */
+	while (lowBlock < highBlock) {
+		unsigned int mid = (lowBlock + highBlock) / 2;
+		if (bUpper ? index->fences[mid] <= key : index->fences[mid] < key) { lowBlock = mid + 1; }
+		else { highBlock = mid; }
+	}
+	if (lowBlock == 0) { return 0; }
+
+	unsigned long long low = (unsigned long long)(lowBlock - 1) * index->header->blockEntries;
+	unsigned long long high = (unsigned long long)lowBlock * index->header->blockEntries;
+	if (high > index->header->entryCount) { high = index->header->entryCount; }
+	while (low < high) {
+		unsigned long long mid = (low + high) / 2;
+		if (bUpper ? index->entries[mid].key <= key : index->entries[mid].key < key) { low = mid + 1; }
+		else { high = mid; }
+	}
+	return low;
+}
+
+unsigned long long findPosition(const positionIndex_s* index, unsigned long long key, const positionIndexEntry_s** first) { /* Returns How Many Entries Match */
+
+	unsigned long long low = positionIndexBound(index, key, false);
+	unsigned long long high = positionIndexBound(index, key, true);
+
+
+	*first = index->entries + low;
+	return high - low;
+}
+
+int positionIndexMain(int argc, char** argv) { /* jonochess --index <file.jcdb> <file.jcidx> [threads] */
+
+	gameDB_s db;
+	SYSTEM_INFO sysInfo;
+
+
+	if (argc < 4) { fputs("usage: jonochess --index <file.jcdb> <file.jcidx> [threads]\n", stderr); return 1; }
+
+	GetSystemInfo(&sysInfo);
+	int threads = argc > 4 ? atoi(argv[4]) : (int)sysInfo.dwNumberOfProcessors;
+
+	initEngine();
+	if (openGameDB(argv[2], &db)) { fputs("File error", stderr); return 1; }
+
+	DWORD start = timeGetTime();
+	if (buildPositionIndex(&db, argv[3], threads)) { fputs("File error", stderr); return 1; }
+	DWORD ms = timeGetTime() - start;
+	unsigned int games = db.count;
+	closeGameDB(&db);
+
+	positionIndex_s index;
+	if (openPositionIndex(argv[3], &index)) { fputs("File error", stderr); return 1; }
+	fprintf(stdout, "Games: %u\nPositions: %llu\nBlocks: %u\nThreads: %d\nTime (ms): %u\nIndex size: %llu bytes\n",
+		games, index.header->entryCount, index.header->blockCount, threads, ms, (unsigned long long)index.file.size);
+	closePositionIndex(&index);
+	return 0;
+}
+
+int findPositionMain(int argc, char** argv) { /* jonochess --find <file.jcidx> "<fen>" [max], Lists Games That Reached The Position */
+
+	positionIndex_s index;
+	position_s pos;
+	const positionIndexEntry_s* first;
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER begin;
+	LARGE_INTEGER end;
+
+
+	if (argc < 4) { fputs("usage: jonochess --find <file.jcidx> \"<fen>\" [max games listed]\n", stderr); return 1; }
+	int listed = argc > 4 ? atoi(argv[4]) : 20;
+
+	initEngine();
+	if (parseFEN(&pos, argv[3]) == 1) { fputs("Invalid FEN\n", stderr); return 1; }
+	if (openPositionIndex(argv[2], &index)) { fputs("File error", stderr); return 1; }
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&begin);
+	unsigned long long count = findPosition(&index, pos.key, &first);
+	QueryPerformanceCounter(&end);
+
+	for (unsigned long long i = 0; i < count && i < (unsigned long long)listed; i++) {
+		fprintf(stdout, "Game %u, ply %u\n", first[i].game + 1, first[i].ply); /* 1 Based Like --db */
+	}
+	fprintf(stdout, "Found %llu occurrences in %.3f ms\n", count, (end.QuadPart - begin.QuadPart) * 1000.0 / frequency.QuadPart);
+	closePositionIndex(&index);
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Opening Book                                                                                                    *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define BOOK_MAGIC_MACRO 0x4B42434A       /* "JCBK" In A Little Endian File */
+#define BOOK_VERSION_MACRO 1
+#define BOOK_PLIES_MACRO 24               /* Default Depth Of The Tree */
+
+struct bookHeader_s {
+
+	unsigned int magic;
+	unsigned int version;
+	unsigned int positionCount;
+	unsigned int moveCount;
+	unsigned int maxPlies;
+	unsigned int reserved;
+};
+
+struct bookPosition_s { /* Sorted By key, The Children Are Found By Making The Move And Looking Up The New Key */
+
+	unsigned long long key;
+	unsigned int firstMove;              /* Index Into The Move Table */
+	unsigned short moveCount;
+	unsigned short reserved;
+};
+
+struct bookMove_s { /* Most Played First */
+
+	move_t move;
+	unsigned short averageElo;           /* Of The Player Making The Move, 0 Where Nobody Had One */
+	unsigned int whiteWins;
+	unsigned int draws;
+	unsigned int blackWins;
+};
+
+struct openingBook_s {
+
+	mappedFile_s file;
+	const bookHeader_s* header;
+	const bookPosition_s* positions;
+	const bookMove_s* moves;
+};
+
+struct bookMapEntry_s { /* move == 0 Marks An Empty Slot */
+
+	unsigned long long key;
+	move_t move;
+	unsigned int results[3];             /* White Wins, Draws, Black Wins */
+	unsigned long long eloSum;
+	unsigned int eloCount;
+};
+
+struct bookMap_s { /* Open Addressing, One Per Build Thread So Counting Needs No Locks */
+
+	bookMapEntry_s* entries;
+	size_t capacity;                     /* Power Of Two */
+	size_t count;
+};
+
+struct bookBuilder_s {
+
+	int maxPlies;
+	int threads;
+	const gameDB_s* db;
+	volatile LONG nextWorker;
+	bookMap_s maps[MATCH_MAX_THREADS_MACRO];
+	unsigned long long games[MATCH_MAX_THREADS_MACRO];
+};
+
+
+inline size_t bookMapSlot(const bookMap_s* map, unsigned long long key, move_t m) {
+
+	return (size_t)((key ^ (m * 0x9E3779B97F4A7C15ULL)) & (map->capacity - 1));
+}
+
+bookMapEntry_s* bookMapFind(bookMap_s* map, unsigned long long key, move_t m) { /* Creates The Entry If It Is Missing */
+
+	if ((map->count + 1) * 10 > map->capacity * 7) { /* Keep The Load Under 70% */
+		bookMap_s grown;
+		grown.capacity = map->capacity ? map->capacity * 2 : 1 << 16;
+		grown.count = 0;
+		grown.entries = (bookMapEntry_s*)calloc(grown.capacity, sizeof(bookMapEntry_s));
+		if (grown.entries == NULL) { fputs("Memory error", stderr); exit(2); }
+
+		for (size_t i = 0; i < map->capacity; i++) {
+			if (map->entries[i].move == 0) { continue; }
+			size_t slot = bookMapSlot(&grown, map->entries[i].key, map->entries[i].move);
+			while (grown.entries[slot].move != 0) { slot = (slot + 1) & (grown.capacity - 1); }
+			grown.entries[slot] = map->entries[i];
+			grown.count++;
+		}
+		free(map->entries);
+		*map = grown;
+	}
+
+	size_t slot = bookMapSlot(map, key, m);
+	while (map->entries[slot].move != 0) {
+		if (map->entries[slot].key == key && map->entries[slot].move == m) { return &map->entries[slot]; }
+		slot = (slot + 1) & (map->capacity - 1);
+	}
+	map->entries[slot].key = key;
+	map->entries[slot].move = m;
+	map->count++;
+	return &map->entries[slot];
+}
+
+void bookAddGame(bookBuilder_s* builder, int worker, const position_s* start, const move_t* moves, int moveCount, int outcome, int whiteElo, int blackElo) {
+
+	position_s pos = *start;
+	position_s next;
+
+
+	if (outcome == GAME_ONGOING) { return; } /* Unfinished Games Say Nothing About A Move */
+	builder->games[worker]++;
+
+	for (int i = 0; i < moveCount && i < builder->maxPlies; i++) {
+		bookMapEntry_s* entry = bookMapFind(&builder->maps[worker], pos.key, moves[i]);
+		int elo = pos.sideToMove ? blackElo : whiteElo;
+
+		entry->results[outcome == GAME_WHITE_WINS ? 0 : outcome == GAME_DRAWN ? 1 : 2]++;
+		if (elo > 0) { entry->eloSum += elo; entry->eloCount++; }
+
+		if (!makeMove(&pos, &next, moves[i])) { return; }
+		pos = next;
+	}
+}
+
+void bookAddPGNGame(const pgnGame_s* game, int worker, void* user) { /* pgnGameCallback_t */
+
+	const pgnTag_s* white = pgnFindTag(game, "WhiteElo");
+	const pgnTag_s* black = pgnFindTag(game, "BlackElo");
+	int outcome = viewEquals(game->result, "1-0") ? GAME_WHITE_WINS : viewEquals(game->result, "0-1") ? GAME_BLACK_WINS :
+		viewEquals(game->result, "1/2-1/2") ? GAME_DRAWN : GAME_ONGOING;
+
+
+	bookAddGame((bookBuilder_s*)user, worker, &game->start, game->moves, game->moveCount, outcome,
+		white ? viewToInt(white->value) : 0, black ? viewToInt(black->value) : 0);
+}
+
+DWORD WINAPI bookDBThread(LPVOID param) { /* A Contiguous Slice Of The Game Database */
+
+	bookBuilder_s* builder = (bookBuilder_s*)param;
+	int worker = InterlockedIncrement(&builder->nextWorker) - 1;
+	unsigned int first = (unsigned int)((unsigned long long)builder->db->count * worker / builder->threads);
+	unsigned int last = (unsigned int)((unsigned long long)builder->db->count * (worker + 1) / builder->threads);
+	move_t* moves = (move_t*)malloc(MAX_GAME_PLY_MACRO * sizeof(move_t));
+	position_s start;
+
+
+	if (moves == NULL) { fputs("Memory error", stderr); exit(2); }
+
+	for (unsigned int game = first; game < last; game++) {
+		const gameDBEntry_s* entry = &builder->db->entries[game];
+		int n = readGameDB(builder->db, game, &start, moves);
+		if (n >= 0) { bookAddGame(builder, worker, &start, moves, n, entry->result, entry->whiteElo, entry->blackElo); }
+	}
+
+	free(moves);
+	return 0;
+}
+
+int compareBookEntries(const void* a, const void* b) { /* By Position, Then Most Played First */
+
+	const bookMapEntry_s* x = (const bookMapEntry_s*)a;
+	const bookMapEntry_s* y = (const bookMapEntry_s*)b;
+	unsigned int gamesX = x->results[0] + x->results[1] + x->results[2];
+	unsigned int gamesY = y->results[0] + y->results[1] + y->results[2];
+
+
+	if (x->key != y->key) { return x->key < y->key ? -1 : 1; }
+	if (gamesX != gamesY) { return gamesX > gamesY ? -1 : 1; }
+	return x->move < y->move ? -1 : x->move > y->move ? 1 : 0;
+}
+
+int writeOpeningBook(const char* filepath, bookBuilder_s* builder) { /* Returns 1 For Error, Merges Every Thread's Map Into The First */
+
+	bookHeader_s header;
+	bookMap_s* map = &builder->maps[0];
+	FILE* file;
+
+
+	for (int t = 1; t < builder->threads; t++) {
+		for (size_t i = 0; i < builder->maps[t].capacity; i++) {
+			const bookMapEntry_s* from = &builder->maps[t].entries[i];
+			if (from->move == 0) { continue; }
+
+			bookMapEntry_s* to = bookMapFind(map, from->key, from->move);
+			for (int r = 0; r < 3; r++) { to->results[r] += from->results[r]; }
+			to->eloSum += from->eloSum;
+			to->eloCount += from->eloCount;
+		}
+		free(builder->maps[t].entries);
+		memset(&builder->maps[t], 0, sizeof(bookMap_s));
+	}
+
+	/* Pack The Used Slots To The Front, Then Sort Them Into Position Order */
+	size_t count = 0;
+	for (size_t i = 0; i < map->capacity; i++) {
+		if (map->entries[i].move != 0) { map->entries[count++] = map->entries[i]; }
+	}
+	qsort(map->entries, count, sizeof(bookMapEntry_s), compareBookEntries);
+
+	memset(&header, 0, sizeof(bookHeader_s));
+	header.magic = BOOK_MAGIC_MACRO;
+	header.version = BOOK_VERSION_MACRO;
+	header.moveCount = (unsigned int)count;
+	header.maxPlies = builder->maxPlies;
+	for (size_t i = 0; i < count; i++) {
+		if (i == 0 || map->entries[i].key != map->entries[i - 1].key) { header.positionCount++; }
+	}
+
+	if (fopen_s(&file, filepath, "wb") != 0) { return 1; }
+	setvbuf(file, NULL, _IOFBF, 1 << 20);
+	bool bOk = fwrite(&header, sizeof(bookHeader_s), 1, file) == 1;
+
+	for (size_t i = 0; i < count && bOk; ) {
+		bookPosition_s position;
+		size_t j = i;
+		while (j < count && map->entries[j].key == map->entries[i].key) { j++; }
+		position.key = map->entries[i].key;
+		position.firstMove = (unsigned int)i;
+		position.moveCount = (unsigned short)(j - i); /* At Most 218, One Per Legal Move */
+		position.reserved = 0;
+		bOk = fwrite(&position, sizeof(bookPosition_s), 1, file) == 1;
+		i = j;
+	}
+	for (size_t i = 0; i < count && bOk; i++) {
+		const bookMapEntry_s* entry = &map->entries[i];
+		bookMove_s move;
+		move.move = entry->move;
+		move.averageElo = (unsigned short)(entry->eloCount ? entry->eloSum / entry->eloCount : 0);
+		move.whiteWins = entry->results[0];
+		move.draws = entry->results[1];
+		move.blackWins = entry->results[2];
+		bOk = fwrite(&move, sizeof(bookMove_s), 1, file) == 1;
+	}
+
+	if (fclose(file) != 0) { bOk = false; }
+	return bOk ? 0 : 1;
+}
+
+int buildOpeningBook(const char* source, const char* filepath, int maxPlies, int threads) { /* Returns 1 For Error, source Is A .pgn Or A .jcdb */
+
+	static bookBuilder_s builder;
+	HANDLE handles[MATCH_MAX_THREADS_MACRO];
+	gameDB_s db;
+	pgnStats_s stats;
+	unsigned long long games = 0;
+
+
+	if (threads < 1) { threads = 1; }
+	if (threads > MATCH_MAX_THREADS_MACRO) { threads = MATCH_MAX_THREADS_MACRO; }
+	if (threads > PGN_MAX_THREADS_MACRO) { threads = PGN_MAX_THREADS_MACRO; }
+
+	memset(&builder, 0, sizeof(bookBuilder_s));
+	builder.maxPlies = maxPlies;
+	builder.threads = threads;
+
+	if (openGameDB(source, &db) == 0) {
+		builder.db = &db;
+		if (threads == 1) { bookDBThread(&builder); }
+		else {
+			for (int i = 0; i < threads; i++) { handles[i] = CreateThread(NULL, 0, bookDBThread, &builder, 0, NULL); }
+			WaitForMultipleObjects(threads, handles, TRUE, INFINITE);
+			for (int i = 0; i < threads; i++) { CloseHandle(handles[i]); }
+		}
+		closeGameDB(&db);
+	}
+	else if (pgnReadFile(source, threads, bookAddPGNGame, &builder, &stats)) { return 1; } /* Not A Database, Try It As PGN */
+
+	for (int i = 0; i < threads; i++) { games += builder.games[i]; }
+	int result = writeOpeningBook(filepath, &builder);
+	fprintf(stdout, "Games: %llu\n", games);
+
+	for (int i = 0; i < threads; i++) { free(builder.maps[i].entries); }
+	return result;
+}
+
+int openOpeningBook(const char* filepath, openingBook_s* book) { /* Returns 1 For Error */
+
+	memset(book, 0, sizeof(openingBook_s));
+	if (mapFile(filepath, &book->file)) { return 1; }
+
+	book->header = (const bookHeader_s*)book->file.data;
+	if (book->file.size < sizeof(bookHeader_s) || book->header->magic != BOOK_MAGIC_MACRO || book->header->version != BOOK_VERSION_MACRO ||
+		book->file.size != sizeof(bookHeader_s) + (unsigned long long)book->header->positionCount * sizeof(bookPosition_s) + (unsigned long long)book->header->moveCount * sizeof(bookMove_s)) {
+		unmapFile(&book->file);
+		return 1;
+	}
+
+	book->positions = (const bookPosition_s*)(book->file.data + sizeof(bookHeader_s));
+	book->moves = (const bookMove_s*)(book->positions + book->header->positionCount);
+	return 0;
+}
+
+void closeOpeningBook(openingBook_s* book) {
+
+	unmapFile(&book->file);
+	memset(book, 0, sizeof(openingBook_s));
+}
+
+int findBookMoves(const openingBook_s* book, unsigned long long key, const bookMove_s** moves) { /* Returns How Many, Most Played First */
+
+	unsigned int low = 0;
+	unsigned int high;
+
+
+	if (book->header == NULL) { return 0; } /* No Book Loaded */
+	high = book->header->positionCount;
+	while (low < high) {
+		unsigned int mid = (low + high) / 2;
+		if (book->positions[mid].key < key) { low = mid + 1; }
+		else { high = mid; }
+	}
+	if (low == book->header->positionCount || book->positions[low].key != key) { return 0; }
+	if (book->positions[low].firstMove + book->positions[low].moveCount > book->header->moveCount) { return 0; }
+
+	*moves = book->moves + book->positions[low].firstMove;
+	return book->positions[low].moveCount;
+}
+
+int formatBookMoves(const openingBook_s* book, const position_s* pos, char* str, int maxMoves) { /* "e4 1203 (38/31/31) 2245, ...", Returns The Length */
+
+	const bookMove_s* moves;
+	char san[8];
+	int len = 0;
+
+
+	str[0] = '\0';
+	int n = findBookMoves(book, pos->key, &moves);
+	for (int i = 0; i < n && i < maxMoves; i++) {
+		unsigned int games = moves[i].whiteWins + moves[i].draws + moves[i].blackWins;
+		moveToSAN(pos, moves[i].move, san);
+		len += sprintf(str + len, "%s%s %u (%u/%u/%u)", i ? ", " : "", san, games,
+			moves[i].whiteWins * 100 / games, moves[i].draws * 100 / games, moves[i].blackWins * 100 / games);
+		if (moves[i].averageElo) { len += sprintf(str + len, " %u", moves[i].averageElo); }
+	}
+	return len;
+}
+
+int bookMain(int argc, char** argv) { /* jonochess --book <games.pgn|games.jcdb> <file.jcbook> [plies] [threads] */
+
+	openingBook_s book;
+	position_s pos;
+	SYSTEM_INFO sysInfo;
+	char text[1024];
+
+
+	if (argc < 4) { fputs("usage: jonochess --book <games.pgn|games.jcdb> <file.jcbook> [plies] [threads]\n", stderr); return 1; }
+
+	GetSystemInfo(&sysInfo);
+	int plies = argc > 4 ? atoi(argv[4]) : BOOK_PLIES_MACRO;
+	int threads = argc > 5 ? atoi(argv[5]) : (int)sysInfo.dwNumberOfProcessors;
+	if (plies < 1) { plies = BOOK_PLIES_MACRO; }
+
+	initEngine();
+	DWORD start = timeGetTime();
+	if (buildOpeningBook(argv[2], argv[3], plies, threads)) { fputs("File error", stderr); return 1; }
+	DWORD ms = timeGetTime() - start;
+
+	if (openOpeningBook(argv[3], &book)) { fputs("File error", stderr); return 1; }
+	formatBookMoves(&book, &startPosition, text, 5);
+	fprintf(stdout, "Positions: %u\nMoves: %u\nPlies: %d\nThreads: %d\nTime (ms): %u\nBook size: %llu bytes\nStart: %s\n",
+		book.header->positionCount, book.header->moveCount, plies, threads, ms, (unsigned long long)book.file.size, text);
+	closeOpeningBook(&book);
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Annotation                                                                                                      *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define ANNOTATE_MAX_THREADS_MACRO 64
+#define ANNOTATE_COMMENT_MACRO 64         /* One Comment, Braces Not Included */
+#define ANNOTATE_CLAMP_SCORE 1000         /* Beyond This The Game Is Decided, A Mate Found Late Is No Blunder */
+#define ANNOTATE_INACCURACY_SCORE 50      /* Centipawns Lost By The Played Move */
+#define ANNOTATE_MISTAKE_SCORE 100
+#define ANNOTATE_BLUNDER_SCORE 300
+
+struct annotateConfig_s {
+
+	const char* inPath = NULL;
+	const char* outPath = NULL;
+	int threads = 0;                      /* 0 For One Per Core */
+	int hashMB = 256;                     /* One Table, Shared By Every Thread */
+	searchLimits_s limits;                /* Per Position */
+	bool bResume = false;                 /* Skip The Games Already Complete In outPath And Append The Rest */
+};
+
+struct annotateGame_s {
+
+	stringView_s text;                    /* Of The Game In The Input */
+	char* output;                         /* Formatted PGN Once Annotated, Waits Here Until The Games Before It Are Written */
+	int length;
+};
+
+struct annotateScratch_s { /* Per Thread, Too Big For Helper Thread Stacks */
+
+	pgnGame_s game;
+	position_s positions[MAX_GAME_PLY_MACRO + 1];
+	unsigned long long keys[MAX_GAME_PLY_MACRO + 1];
+	int scores[MAX_GAME_PLY_MACRO + 1];     /* Side To Move's Point Of View */
+	move_t best[MAX_GAME_PLY_MACRO + 1];
+	unsigned char nags[MAX_GAME_PLY_MACRO];
+	const char* comments[MAX_GAME_PLY_MACRO];
+	char commentText[MAX_GAME_PLY_MACRO][ANNOTATE_COMMENT_MACRO];
+};
+
+struct annotateState_s {
+
+	annotateConfig_s config;
+	mappedFile_s input;
+	annotateGame_s* games;
+	int gameCount;
+	int firstGame;                        /* Games Before It Were Done By An Earlier Run */
+	volatile LONG nextGame;
+	volatile LONG nextSlot;
+	volatile LONG positions;
+	volatile LONG gamesDone;
+	volatile LONG badGames;               /* A Move Did Not Decode, Copied Through Unannotated */
+	volatile LONG nextWrite;              /* Only Touched With lock Held */
+	CRITICAL_SECTION lock;
+	FILE* out;
+	transTable_s tt;
+	searchEngine_s engines[ANNOTATE_MAX_THREADS_MACRO];
+	unsigned long long nodes[ANNOTATE_MAX_THREADS_MACRO];
+};
+
+
+void formatAnnotationScore(int score, char* str) { /* White's Point Of View, "+0.35" Or "#-3" */
+
+	if (score >= MATE_BOUND_SCORE)       { sprintf(str, "#%d", (MATE_SCORE - score + 1) / 2); }
+	else if (score <= -MATE_BOUND_SCORE) { sprintf(str, "#%d", -(MATE_SCORE + score) / 2); }
+	else                                 { sprintf(str, "%+.2f", score / 100.0); }
+}
+
+inline int clampAnnotationScore(int score) { return score > ANNOTATE_CLAMP_SCORE ? ANNOTATE_CLAMP_SCORE : score < -ANNOTATE_CLAMP_SCORE ? -ANNOTATE_CLAMP_SCORE : score; }
+
+int annotateGame(annotateState_s* state, searchEngine_s* engine, annotateScratch_s* scratch, int index, char** output) { /* Returns The Length Of The Formatted Game In output */
+
+	pgnGame_s* game = &scratch->game;
+	annotateGame_s* out = &state->games[index];
+	const char* text = out->text.data;
+	const char* reason;
+	char result[8] = "*";
+	char before[16];
+	char after[16];
+	char san[8];
+	pgnRecord_s record;
+	int n;
+
+
+	pgnParseGame(text, text, text + out->text.length, game);
+	n = game->moveCount;
+
+	/* Writing Only The Moves Before The Bad One Would Leave A Result That Does Not Follow, So The Game Goes Out As It Came In */
+	if (game->bError) {
+		size_t length = out->text.length;
+		while (length > 0 && (text[length - 1] == ' ' || text[length - 1] == '\r' || text[length - 1] == '\n' || text[length - 1] == '\t')) { length--; }
+		*output = (char*)malloc(length + 2);
+		if (*output == NULL) { fputs("Memory error", stderr); exit(2); }
+		memcpy(*output, text, length);
+		memcpy(*output + length, "\n\n", 2);
+		InterlockedIncrement(&state->badGames);
+		return (int)length + 2;
+	}
+
+	scratch->positions[0] = game->start;
+	for (int i = 0; i < n; i++) {
+		scratch->keys[i] = scratch->positions[i].key;
+		makeMove(&scratch->positions[i], &scratch->positions[i + 1], game->moves[i]);
+	}
+	scratch->keys[n] = scratch->positions[n].key;
+
+	/* Last Position First, Each Search Leaves The Shared Table Primed For The One Before It */
+	for (int i = n; i >= 0; i--) {
+		int outcome = gameOutcome(&scratch->positions[i], scratch->keys, i, &reason);
+		scratch->best[i] = 0;
+
+		if (outcome != GAME_ONGOING) { scratch->scores[i] = outcome == GAME_DRAWN ? DRAW_SCORE : -MATE_SCORE; continue; }
+
+		searchRun(engine, &scratch->positions[i], scratch->keys, i, &state->config.limits);
+		scratch->scores[i] = engine->bestScore;
+		scratch->best[i] = engine->bestMove;
+		state->nodes[engine - state->engines] += searchTotalNodes(engine);
+		InterlockedIncrement(&state->positions);
+	}
+
+	for (int i = 0; i < n; i++) {
+		int sign = scratch->positions[i].sideToMove ? -1 : 1;
+		int bestScore = scratch->scores[i];
+		int playedScore = -scratch->scores[i + 1];
+		int drop = clampAnnotationScore(bestScore) - clampAnnotationScore(playedScore);
+		const char* label = NULL;
+
+		scratch->nags[i] = 0;
+		scratch->comments[i] = NULL;
+		if (game->moves[i] == scratch->best[i]) { continue; } /* Deeper Search Of The Next Position Can Disagree, The Move Is Still Best */
+
+		if (drop >= ANNOTATE_BLUNDER_SCORE)         { label = "Blunder";    scratch->nags[i] = 4; }
+		else if (drop >= ANNOTATE_MISTAKE_SCORE)    { label = "Mistake";    scratch->nags[i] = 2; }
+		else if (drop >= ANNOTATE_INACCURACY_SCORE) { label = "Inaccuracy"; scratch->nags[i] = 6; }
+		if (label == NULL) { continue; }
+
+		formatAnnotationScore(sign * bestScore, before);
+		formatAnnotationScore(sign * playedScore, after);
+		moveToSAN(&scratch->positions[i], scratch->best[i], san);
+		sprintf(scratch->commentText[i], " %s. %s -> %s, best was %s ", label, before, after, san);
+		scratch->comments[i] = scratch->commentText[i];
+	}
+
+	if (game->result.length > 0 && game->result.length < sizeof(result)) { memcpy(result, game->result.data, game->result.length); result[game->result.length] = '\0'; }
+	record.result = result;
+	record.tags = game->tags;
+	record.tagCount = game->tagCount;
+	record.start = &game->start;
+	record.moves = game->moves;
+	record.moveCount = n;
+	record.nags = scratch->nags;
+	record.comments = scratch->comments;
+
+	*output = (char*)malloc(PGN_MAX_TEXT_MACRO + out->text.length + (size_t)n * (ANNOTATE_COMMENT_MACRO + 8));
+	if (*output == NULL) { fputs("Memory error", stderr); exit(2); }
+	return formatPGN(&record, *output);
+}
+
+void writeAnnotatedGames(annotateState_s* state, int index, char* output, int length) { /* Writes Whatever Is Ready At The Front, So The Output Keeps The Input's Order */
+
+	EnterCriticalSection(&state->lock);
+	state->games[index].output = output;
+	state->games[index].length = length;
+	while (state->nextWrite < state->gameCount && state->games[state->nextWrite].output != NULL) {
+		annotateGame_s* game = &state->games[state->nextWrite];
+
+		/* A Whole Game Per Write, An Interrupted Run Leaves At Most One Partial Game For --resume To Drop */
+		if (fwrite(game->output, 1, game->length, state->out) != (size_t)game->length || fflush(state->out)) { fputs("File error", stderr); exit(1); }
+		free(game->output);
+		game->output = NULL;
+		state->nextWrite++;
+	}
+	LeaveCriticalSection(&state->lock);
+}
+
+DWORD WINAPI annotateThread(LPVOID param) {
+
+	annotateState_s* state = (annotateState_s*)param;
+	searchEngine_s* engine = &state->engines[InterlockedIncrement(&state->nextSlot) - 1];
+	annotateScratch_s* scratch = (annotateScratch_s*)malloc(sizeof(annotateScratch_s));
+
+
+	if (scratch == NULL) { fputs("Memory error", stderr); exit(2); }
+
+	while (true) {
+		int index = InterlockedIncrement(&state->nextGame) - 1;
+		if (index >= state->gameCount) { break; }
+
+		/* Not searchClearHistory(), That Would Also Wipe The Table The Other Threads Are Using */
+		memset(engine->workers[0].history, 0, sizeof(engine->workers[0].history));
+
+		/* One Generation Per Game, So The Game's Earlier Plies Stay Current While Its Later Ones Are Searched */
+		EnterCriticalSection(&state->lock);
+		ttNewSearch(&state->tt);
+		LeaveCriticalSection(&state->lock);
+		char* output;
+		int length = annotateGame(state, engine, scratch, index, &output);
+		InterlockedIncrement(&state->gamesDone);
+		writeAnnotatedGames(state, index, output, length);
+	}
+
+	free(scratch);
+	return 0;
+}
+
+int countAnnotatedGames(const char* filepath) { /* Complete Games Already In filepath, Cutting Off A Partial One, -1 For Error */
+
+	mappedFile_s mf;
+	pgnGame_s* game;
+	FILE* file;
+	size_t keep = 0;
+	int count = 0;
+
+
+	if (fopen_s(&file, filepath, "rb") != 0) { return 0; } /* Nothing To Resume */
+	fclose(file);
+	game = (pgnGame_s*)malloc(sizeof(pgnGame_s));
+	if (game == NULL) { fputs("Memory error", stderr); exit(2); }
+	if (mapFile(filepath, &mf)) { free(game); return -1; }
+
+	const char* p = mf.data;
+	const char* end = mf.data + mf.size;
+	while (p < end) {
+		const char* before = p;
+		p = pgnParseGame(mf.data, p, end, game);
+		if (p == before) { break; }
+		if (game->result.length == 0) { break; } /* Ran Out Mid Game */
+		count++;
+		keep = (size_t)(p - mf.data);
+	}
+	bool bPartial = keep < mf.size;
+	unmapFile(&mf);
+	free(game);
+
+	if (bPartial) {
+		HANDLE handle = CreateFileA(filepath, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		LARGE_INTEGER size;
+		size.QuadPart = (LONGLONG)keep;
+		if (handle == INVALID_HANDLE_VALUE) { return -1; }
+		bool bCut = SetFilePointerEx(handle, size, NULL, FILE_BEGIN) && SetEndOfFile(handle);
+		CloseHandle(handle);
+		if (!bCut) { return -1; }
+	}
+	return count;
+}
+
+int annotateMain(int argc, char** argv) { /* jonochess --annotate <in.pgn> <out.pgn> [options] */
+
+	static annotateState_s annotateState; /* Too Big For The Stack */
+	annotateState_s* state = &annotateState;
+	annotateConfig_s* config = &state->config;
+	HANDLE threads[ANNOTATE_MAX_THREADS_MACRO];
+	SYSTEM_INFO sysInfo;
+	pgnGame_s* game;
+	int capacity = 0;
+
+
+	for (int i = 2; i < argc; i++) {
+		bool bValue = i + 1 < argc;
+		if (argv[i][0] != '-' && config->inPath == NULL)  { config->inPath = argv[i]; }
+		else if (argv[i][0] != '-')                       { config->outPath = argv[i]; }
+		else if (bValue && !strcmp(argv[i], "--threads")) { config->threads = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--hash"))    { config->hashMB = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--nodes"))   { config->limits.nodes = strtoull(argv[++i], NULL, 10); }
+		else if (bValue && !strcmp(argv[i], "--depth"))   { config->limits.depth = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--movetime")) { config->limits.movetime = atoi(argv[++i]); }
+		else if (!strcmp(argv[i], "--resume"))            { config->bResume = true; }
+		else { fprintf(stderr, "Unknown annotate argument %s\n", argv[i]); return 1; }
+	}
+
+	if (config->inPath == NULL || config->outPath == NULL) {
+		fputs("usage: jonochess --annotate <in.pgn> <out.pgn> [--threads N] [--hash MB] [--nodes N | --depth N | --movetime ms] [--resume]\n", stderr);
+		return 1;
+	}
+	GetSystemInfo(&sysInfo);
+	if (config->threads < 1) { config->threads = (int)sysInfo.dwNumberOfProcessors; }
+	if (config->threads > ANNOTATE_MAX_THREADS_MACRO) { config->threads = ANNOTATE_MAX_THREADS_MACRO; }
+	if (config->hashMB < 1) { config->hashMB = 256; }
+	if (config->limits.nodes == 0 && config->limits.depth == 0 && config->limits.movetime == 0) { config->limits.nodes = 100000; }
+
+	initEngine();
+	if (mapFile(config->inPath, &state->input)) { fputs("File error", stderr); return 1; }
+
+	/* Only The Game Boundaries Up Front, The Workers Parse Each Game Again When They Get To It */
+	game = (pgnGame_s*)malloc(sizeof(pgnGame_s));
+	if (game == NULL) { fputs("Memory error", stderr); exit(2); }
+	const char* p = state->input.data;
+	const char* end = state->input.data + state->input.size;
+	while (p < end) {
+		const char* before = p;
+		p = pgnParseGame(state->input.data, p, end, game);
+		if (p == before) { break; }
+		if (game->tagCount == 0 && game->moveCount == 0 && !game->bError && game->result.length == 0) { continue; } /* Trailing Whitespace */
+
+		if (state->gameCount == capacity) {
+			capacity = capacity ? capacity * 2 : 1024;
+			state->games = (annotateGame_s*)realloc(state->games, capacity * sizeof(annotateGame_s));
+			if (state->games == NULL) { fputs("Memory error", stderr); exit(2); }
+		}
+		state->games[state->gameCount].text = game->text;
+		state->games[state->gameCount].output = NULL;
+		state->gameCount++;
+	}
+	free(game);
+
+	if (config->bResume) {
+		state->firstGame = countAnnotatedGames(config->outPath);
+		if (state->firstGame < 0) { fputs("File error", stderr); return 1; }
+		if (state->firstGame > state->gameCount) { state->firstGame = state->gameCount; }
+	}
+	state->nextGame = state->nextWrite = state->firstGame;
+
+	if (fopen_s(&state->out, config->outPath, config->bResume ? "ab" : "wb")) { fputs("File error", stderr); return 1; }
+	InitializeCriticalSection(&state->lock);
+	ttResize(&state->tt, config->hashMB);
+	for (int i = 0; i < config->threads; i++) { searchInit(&state->engines[i], &state->tt, 0, 1); }
+
+	fprintf(stdout, "Annotate: %d games, %d already done, %d threads, %d MB hash\n", state->gameCount, state->firstGame, config->threads, config->hashMB);
+	fflush(stdout);
+
+	DWORD start = timeGetTime();
+	for (int i = 0; i < config->threads; i++) { threads[i] = CreateThread(NULL, 0, annotateThread, state, 0, NULL); }
+	while (WaitForMultipleObjects(config->threads, threads, TRUE, 2000) == WAIT_TIMEOUT) {
+		DWORD elapsed = timeGetTime() - start;
+		fprintf(stdout, "Games %d/%d, %ld positions/s\n", state->firstGame + state->gamesDone, state->gameCount, (long)(state->positions * 1000LL / (elapsed ? elapsed : 1)));
+		fflush(stdout);
+	}
+	for (int i = 0; i < config->threads; i++) { CloseHandle(threads[i]); }
+	DWORD elapsed = timeGetTime() - start;
+
+	unsigned long long nodes = 0;
+	for (int i = 0; i < config->threads; i++) { nodes += state->nodes[i]; searchFree(&state->engines[i]); }
+	fprintf(stdout, "Games: %d\nPositions: %ld\nTime (ms): %u\nPositions/second: %lld\nNodes/second: %llu\n",
+		state->gamesDone, state->positions, elapsed, state->positions * 1000LL / (elapsed ? elapsed : 1), nodes * 1000 / (elapsed ? elapsed : 1));
+
+	if (state->badGames) { fprintf(stderr, "Warning: %ld games with moves that did not decode were copied unannotated\n", state->badGames); }
+
+	int error = fclose(state->out);
+	ttFree(&state->tt);
+	DeleteCriticalSection(&state->lock);
+	free(state->games);
+	unmapFile(&state->input);
+	if (error) { fputs("File error", stderr); return 1; }
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Training Data                                                                                                   *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define TRAINING_MAGIC_MACRO 0x4454434A   /* "JCTD" */
+#define TRAINING_VERSION_MACRO 1
+#define TRAINING_MAX_THREADS_MACRO 64
+#define TRAINING_BUFFER_MACRO (1 << 16)    /* Records Per Thread Between Writes, 2 MB */
+#define TRAINING_OPENING_PLIES 8           /* Never Recorded, Played At Random In Self-Play */
+#define TRAINING_MAX_PLIES 400             /* Self-Play Games Are Drawn After This Many */
+#define TRAINING_ADJUDICATE_SCORE 2000     /* Self-Play Games Are Decided Once The Search Sees This Much */
+
+struct trainingHeader_s {
+
+	unsigned int magic;
+	unsigned int version;
+	unsigned int recordSize;               /* sizeof(trainingRecord_s) */
+	unsigned int reserved;
+	unsigned long long recordCount;        /* Filled In When The File Is Closed */
+};
+
+struct trainingRecord_s { /* One Labelled Position, 32 Bytes */
+
+	bitboard_t occupied;
+	unsigned char pieces[16];              /* chessPiece_e Per Set Bit Of occupied From a8 Up, Low Nibble First */
+	short score;                           /* Centipawns, Side To Move's Point Of View */
+	unsigned short ply;                    /* Since The Start Of The Game */
+	unsigned char result;                  /* gameOutcome_e */
+	unsigned char flags;                   /* Bit 0 Side To Move, Bits 1-4 castleRight_e */
+	signed char epSquare;
+	unsigned char halfmoveClock;
+};
+
+struct bloomFilter_s { /* Lock Free, Every Key Sets Four Bits Of One Word So A Single Atomic Or Both Tests And Inserts */
+
+	volatile LONGLONG* words;
+	unsigned long long mask;
+};
+
+struct trainingConfig_s {
+
+	const char* outPath = NULL;
+	const char* pgnPath = NULL;            /* Label Positions From These Games Instead Of Playing Them */
+	int games = 10000;                     /* Self-Play Only */
+	int threads = 0;                       /* 0 For One Per Core */
+	int hashMB = 16;                       /* Per Thread, Self-Play Only */
+	int bloomMB = 256;
+	int openingPlies = TRAINING_OPENING_PLIES;
+	unsigned long long seed = 1;
+	searchLimits_s limits;
+};
+
+struct trainingWorker_s {
+
+	trainingRecord_s buffer[TRAINING_BUFFER_MACRO];
+	int count;
+	trainingRecord_s game[MAX_GAME_PLY_MACRO]; /* Records Wait Here Until The Game's Result Is Known */
+	searchEngine_s engine;
+	unsigned long long random;
+};
+
+struct trainingState_s {
+
+	trainingConfig_s config;
+	FILE* file;
+	CRITICAL_SECTION lock;
+	bloomFilter_s bloom;
+	volatile LONG nextGame;
+	volatile LONG nextSlot;
+	volatile LONGLONG records;
+	volatile LONGLONG duplicates;
+	volatile LONG gamesDone;
+	trainingWorker_s* workers[TRAINING_MAX_THREADS_MACRO];
+};
+
+
+void bloomInit(bloomFilter_s* bloom, size_t sizeMB) {
+
+	unsigned long long count = 1;
+
+
+	while (count * 2 * sizeof(LONGLONG) <= (unsigned long long)sizeMB << 20) { count *= 2; }
+	bloom->words = (volatile LONGLONG*)calloc((size_t)count, sizeof(LONGLONG));
+	if (bloom->words == NULL) { fputs("Memory error", stderr); exit(2); }
+	bloom->mask = count - 1;
+}
+
+void bloomFree(bloomFilter_s* bloom) {
+
+	free((void*)bloom->words); bloom->words = NULL;
+}
+
+bool bloomTestAndSet(bloomFilter_s* bloom, unsigned long long key) { /* Returns true If key Was (Probably) Seen Before */
+
+	/* Low Bits Pick The Word, The Top 24 Bits Pick Four Bits In It, Zobrist Keys Are Random Enough For Both */
+	LONGLONG bits = (1LL << ((key >> 40) & 63)) | (1LL << ((key >> 46) & 63)) | (1LL << ((key >> 52) & 63)) | (1LL << ((key >> 58) & 63));
+	LONGLONG old = InterlockedOr64(&bloom->words[key & bloom->mask], bits);
+	return (old & bits) == bits;
+}
+
+void packTrainingRecord(const position_s* pos, int score, int ply, trainingRecord_s* record) {
+
+	bitboard_t occupied = pos->occupiedBB;
+	int i = 0;
+
+
+	memset(record, 0, sizeof(trainingRecord_s));
+	record->occupied = occupied;
+	while (occupied) {
+		int sq = popBit(&occupied);
+		record->pieces[i >> 1] |= pos->board[sq] << ((i & 1) * 4);
+		i++;
+	}
+	record->score = (short)score;
+	record->ply = (unsigned short)ply;
+	record->result = GAME_ONGOING;
+	record->flags = (unsigned char)(pos->sideToMove | (pos->castling << 1));
+	record->epSquare = pos->epSquare;
+	record->halfmoveClock = pos->halfmoveClock;
+}
+
+void unpackTrainingRecord(const trainingRecord_s* record, position_s* pos) {
+
+	bitboard_t occupied = record->occupied;
+	int i = 0;
+
+
+	memset(pos, 0, sizeof(position_s));
+	pos->epSquare = -1;
+	while (occupied) {
+		int sq = popBit(&occupied);
+		putPiece(pos, (record->pieces[i >> 1] >> ((i & 1) * 4)) & 15, sq);
+		i++;
+	}
+	pos->sideToMove = record->flags & 1;
+	if (pos->sideToMove) { pos->key ^= zobristSide; }
+	pos->castling = (record->flags >> 1) & 15;
+	pos->key ^= zobristCastle[pos->castling];
+	if (record->epSquare >= 0) { setEnPassantSquare(pos, record->epSquare); }
+	pos->halfmoveClock = record->halfmoveClock;
+	pos->fullmoveNumber = (unsigned short)(record->ply / 2 + 1);
+}
+
+void flushTrainingRecords(trainingState_s* state, trainingWorker_s* worker) {
+
+	if (worker->count == 0) { return; }
+
+	EnterCriticalSection(&state->lock);
+	if (fwrite(worker->buffer, sizeof(trainingRecord_s), worker->count, state->file) != (size_t)worker->count) { fputs("File error", stderr); exit(1); }
+	LeaveCriticalSection(&state->lock);
+
+	InterlockedExchangeAdd64(&state->records, worker->count);
+	worker->count = 0;
+}
+
+void addTrainingGame(trainingState_s* state, trainingWorker_s* worker, int count, int outcome) { /* Labels The Game's Records With Its Result And Queues Them */
+
+	for (int i = 0; i < count; i++) {
+		worker->game[i].result = (unsigned char)outcome;
+		worker->buffer[worker->count++] = worker->game[i];
+		if (worker->count == TRAINING_BUFFER_MACRO) { flushTrainingRecords(state, worker); }
+	}
+	InterlockedIncrement(&state->gamesDone);
+}
+
+bool keepTrainingPosition(trainingState_s* state, const position_s* pos, move_t next, int score) { /* Quiet Positions Only, Each Seen Once */
+
+	if (inCheck(pos) || isCaptureMove(next) || isPromotionMove(next)) { return false; }
+	if (bitCount(pos->occupiedBB) > 32) { return false; } /* trainingRecord_s Packs At Most 32 Pieces, Only Odd [FEN] Tags Have More */
+	if (score >= MATE_BOUND_SCORE || score <= -MATE_BOUND_SCORE) { return false; }
+	if (bloomTestAndSet(&state->bloom, pos->key)) { InterlockedIncrement64(&state->duplicates); return false; }
+	return true;
+}
+
+void addTrainingPGNGame(const pgnGame_s* game, int worker, void* user) { /* pgnGameCallback_t, Labelled With The Static Evaluation */
+
+	trainingState_s* state = (trainingState_s*)user;
+	trainingWorker_s* w = state->workers[worker];
+	position_s pos = game->start;
+	position_s next;
+	int outcome = GAME_ONGOING;
+	int count = 0;
+
+
+	if (viewEquals(game->result, "1-0")) { outcome = GAME_WHITE_WINS; }
+	else if (viewEquals(game->result, "0-1")) { outcome = GAME_BLACK_WINS; }
+	else if (viewEquals(game->result, "1/2-1/2")) { outcome = GAME_DRAWN; }
+	if (outcome == GAME_ONGOING) { return; } /* Nothing To Label With */
+
+	for (int i = 0; i < game->moveCount; i++) {
+		if (i >= state->config.openingPlies) {
+			int score = evaluate(&pos);
+			if (keepTrainingPosition(state, &pos, game->moves[i], score)) { packTrainingRecord(&pos, score, i, &w->game[count++]); }
+		}
+		makeMove(&pos, &next, game->moves[i]);
+		pos = next;
+	}
+	addTrainingGame(state, w, count, outcome);
+}
+
+void playTrainingGame(trainingState_s* state, trainingWorker_s* worker) {
+
+	const trainingConfig_s* config = &state->config;
+	move_t list[MAX_MOVES_MACRO];
+	unsigned long long keys[MAX_GAME_PLY_MACRO];
+	position_s pos;
+	position_s next;
+	const char* reason;
+	int keyCount = 0;
+	int count = 0;
+	int outcome;
+
+
+	/* Random Opening, Tried Again Until It Leaves A Game That Is Still Going */
+	do {
+		pos = startPosition;
+		keyCount = 0;
+		for (int i = 0; i < config->openingPlies; i++) {
+			int moveCount = generateLegalMoves(&pos, list);
+			if (moveCount == 0) { break; }
+			keys[keyCount++] = pos.key;
+			makeMove(&pos, &next, list[randomU64(&worker->random) % moveCount]);
+			pos = next;
+		}
+	} while (gameOutcome(&pos, keys, keyCount, &reason) != GAME_ONGOING);
+
+	searchClearHistory(&worker->engine);
+	while ((outcome = gameOutcome(&pos, keys, keyCount, &reason)) == GAME_ONGOING) {
+		if (keyCount >= TRAINING_MAX_PLIES || keyCount >= MAX_GAME_PLY_MACRO - 1) { outcome = GAME_DRAWN; break; }
+
+		move_t m = searchRun(&worker->engine, &pos, keys, keyCount, &config->limits);
+		int score = worker->engine.bestScore;
+
+		if (score >= TRAINING_ADJUDICATE_SCORE)  { outcome = pos.sideToMove ? GAME_BLACK_WINS : GAME_WHITE_WINS; break; }
+		if (score <= -TRAINING_ADJUDICATE_SCORE) { outcome = pos.sideToMove ? GAME_WHITE_WINS : GAME_BLACK_WINS; break; }
+		if (keepTrainingPosition(state, &pos, m, score)) { packTrainingRecord(&pos, score, keyCount, &worker->game[count++]); }
+
+		if (m == 0 || !makeMove(&pos, &next, m)) { fputs("Engine returned an illegal move", stderr); exit(1); }
+		keys[keyCount++] = pos.key;
+		pos = next;
+	}
+
+	addTrainingGame(state, worker, count, outcome);
+}
+
+DWORD WINAPI trainingThread(LPVOID param) {
+
+	trainingState_s* state = (trainingState_s*)param;
+	int slot = InterlockedIncrement(&state->nextSlot) - 1;
+	trainingWorker_s* worker = state->workers[slot];
+
+
+	worker->random = state->config.seed * 0x9E3779B97F4A7C15ULL + slot + 1; /* Never 0, xorshift Would Stay There */
+	searchInit(&worker->engine, NULL, state->config.hashMB, 1);
+
+	while (InterlockedIncrement(&state->nextGame) <= state->config.games) { playTrainingGame(state, worker); }
+
+	searchFree(&worker->engine);
+	return 0;
+}
+
+int trainingMain(int argc, char** argv) { /* jonochess --gendata <file.jctd> [options] */
+
+	static trainingState_s trainingState;
+	trainingState_s* state = &trainingState;
+	trainingConfig_s* config = &state->config;
+	trainingHeader_s header;
+	HANDLE threads[TRAINING_MAX_THREADS_MACRO];
+	SYSTEM_INFO sysInfo;
+	pgnStats_s stats;
+
+
+	for (int i = 2; i < argc; i++) {
+		bool bValue = i + 1 < argc;
+		if (argv[i][0] != '-')                             { config->outPath = argv[i]; }
+		else if (bValue && !strcmp(argv[i], "--pgn"))      { config->pgnPath = argv[++i]; }
+		else if (bValue && !strcmp(argv[i], "--games"))    { config->games = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--threads"))  { config->threads = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--hash"))     { config->hashMB = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--bloom"))    { config->bloomMB = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--opening"))  { config->openingPlies = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--seed"))     { config->seed = strtoull(argv[++i], NULL, 10); }
+		else if (bValue && !strcmp(argv[i], "--nodes"))    { config->limits.nodes = strtoull(argv[++i], NULL, 10); }
+		else if (bValue && !strcmp(argv[i], "--depth"))    { config->limits.depth = atoi(argv[++i]); }
+		else { fprintf(stderr, "Unknown gendata argument %s\n", argv[i]); return 1; }
+	}
+
+	if (config->outPath == NULL) {
+		fputs("usage: jonochess --gendata <file.jctd> [--pgn games.pgn] [--games N] [--nodes N | --depth N] [--threads N] [--hash MB] [--bloom MB] [--opening plies] [--seed N]\n", stderr);
+		return 1;
+	}
+	GetSystemInfo(&sysInfo);
+	if (config->threads < 1) { config->threads = (int)sysInfo.dwNumberOfProcessors; }
+	if (config->threads > TRAINING_MAX_THREADS_MACRO) { config->threads = TRAINING_MAX_THREADS_MACRO; }
+	if (config->bloomMB < 1) { config->bloomMB = 256; }
+	if (config->hashMB < 1) { config->hashMB = 16; }
+	if (config->openingPlies < 0) { config->openingPlies = 0; }
+	if (config->limits.nodes == 0 && config->limits.depth == 0) { config->limits.nodes = 5000; }
+
+	initEngine();
+	bloomInit(&state->bloom, config->bloomMB);
+	for (int i = 0; i < config->threads; i++) {
+		state->workers[i] = (trainingWorker_s*)calloc(1, sizeof(trainingWorker_s));
+		if (state->workers[i] == NULL) { fputs("Memory error", stderr); exit(2); }
+		state->workers[i]->engine = searchEngine_s(); /* calloc() Skips Its Defaults, Every Search Feature Would Be Off */
+	}
+
+	memset(&header, 0, sizeof(trainingHeader_s));
+	header.magic = TRAINING_MAGIC_MACRO;
+	header.version = TRAINING_VERSION_MACRO;
+	header.recordSize = sizeof(trainingRecord_s);
+	if (fopen_s(&state->file, config->outPath, "wb") != 0) { fputs("File error", stderr); return 1; }
+	if (setvbuf(state->file, NULL, _IONBF, 0) || fwrite(&header, sizeof(trainingHeader_s), 1, state->file) != 1) { fputs("File error", stderr); return 1; } /* Buffers Are Already Large */
+	InitializeCriticalSection(&state->lock);
+
+	DWORD start = timeGetTime();
+	if (config->pgnPath) {
+		if (pgnReadFile(config->pgnPath, config->threads, addTrainingPGNGame, state, &stats)) { fputs("File error", stderr); return 1; }
+	}
+	else {
+		for (int i = 0; i < config->threads; i++) { threads[i] = CreateThread(NULL, 0, trainingThread, state, 0, NULL); }
+		while (WaitForMultipleObjects(config->threads, threads, TRUE, 2000) == WAIT_TIMEOUT) {
+			DWORD elapsed = timeGetTime() - start;
+			LONGLONG records = state->records;
+			for (int i = 0; i < config->threads; i++) { records += state->workers[i]->count; } /* Still In The Buffers, Read Without Locking */
+			fprintf(stdout, "Games %ld/%d, %lld positions, %lld positions/s\n", state->gamesDone, config->games, records, records * 1000 / (elapsed ? elapsed : 1));
+			fflush(stdout);
+		}
+		for (int i = 0; i < config->threads; i++) { CloseHandle(threads[i]); }
+	}
+	for (int i = 0; i < config->threads; i++) { flushTrainingRecords(state, state->workers[i]); free(state->workers[i]); }
+	DWORD elapsed = timeGetTime() - start;
+
+	header.recordCount = (unsigned long long)state->records;
+	if (fseek(state->file, 0, SEEK_SET) || fwrite(&header, sizeof(trainingHeader_s), 1, state->file) != 1 || fclose(state->file)) { fputs("File error", stderr); return 1; }
+
+	fprintf(stdout, "Games: %ld\nPositions: %lld\nDuplicates: %lld\nTime (ms): %u\nPositions/second: %lld\n",
+		state->gamesDone, state->records, state->duplicates, elapsed, state->records * 1000 / (elapsed ? elapsed : 1));
+
+	DeleteCriticalSection(&state->lock);
+	bloomFree(&state->bloom);
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Tuner                                                                                                           *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define TUNE_MAX_THREADS_MACRO 64
+#define TUNE_CHUNK_MACRO 1024              /* Positions Evaluated Together, Keeps The Per Chunk Arrays In L1 */
+#define TUNE_FEATURES_MACRO 384            /* Piece Type x Square From White's Side, Black Pieces Use The Mirrored Square */
+#define TUNE_OUTPUT_PATH "evalweights.h"
+
+struct tuneData_s { /* Structure Of Arrays, Positions Are Only Ever Walked In Order */
+
+	int count;
+	unsigned int* featureStart;            /* count + 1 Entries, Position i Owns features[featureStart[i] .. featureStart[i + 1]) */
+	unsigned short* features;              /* White Pieces 0-383, Black Pieces 384-767 So Their Weights Can Be Stored Negated */
+	float* phase;                          /* Middlegame Share, 0 To 1 */
+	float* target;                         /* Game Result From White's Side, Optionally Blended With The Search Score */
+};
+
+struct tuneWorker_s {
+
+	const tuneData_s* data;
+	const float* weightsMG;                /* 768 Entries, The Second Half Negated */
+	const float* weightsEG;
+	float k;                               /* Sigmoid Scale, Already Multiplied By log2(10) / 400 */
+	bool bGradient;
+	int first;
+	int last;
+	double loss;
+	double gradMG[TUNE_FEATURES_MACRO * 2];
+	double gradEG[TUNE_FEATURES_MACRO * 2];
+};
+
+struct tuneState_s {
+
+	tuneData_s data;
+	int threads;
+	float weightsMG[TUNE_FEATURES_MACRO * 2];
+	float weightsEG[TUNE_FEATURES_MACRO * 2];
+	tuneWorker_s workers[TUNE_MAX_THREADS_MACRO];
+};
+
+
+int loadTuneData(const char* filepath, float lambda, tuneData_s* data) { /* Returns 1 For Error, Reads A --gendata File */
+
+	mappedFile_s mf;
+	const trainingHeader_s* header;
+	const trainingRecord_s* records;
+	size_t featureCount = 0;
+
+
+	if (mapFile(filepath, &mf)) { return 1; }
+	header = (const trainingHeader_s*)mf.data;
+	if (mf.size < sizeof(trainingHeader_s) || header->magic != TRAINING_MAGIC_MACRO || header->version != TRAINING_VERSION_MACRO || header->recordSize != sizeof(trainingRecord_s) ||
+		mf.size < sizeof(trainingHeader_s) + header->recordCount * sizeof(trainingRecord_s)) {
+		unmapFile(&mf);
+		return 1;
+	}
+	records = (const trainingRecord_s*)(mf.data + sizeof(trainingHeader_s));
+	data->count = (int)header->recordCount;
+
+	for (int i = 0; i < data->count; i++) { featureCount += bitCount(records[i].occupied); }
+
+	data->featureStart = (unsigned int*)malloc((data->count + 1) * sizeof(unsigned int));
+	data->features = (unsigned short*)malloc(featureCount * sizeof(unsigned short));
+	data->phase = (float*)malloc(data->count * sizeof(float));
+	data->target = (float*)malloc(data->count * sizeof(float));
+	if (!data->featureStart || !data->features || !data->phase || !data->target) { fputs("Memory error", stderr); exit(2); }
+
+	unsigned int n = 0;
+	for (int i = 0; i < data->count; i++) {
+		const trainingRecord_s* record = &records[i];
+		bitboard_t occupied = record->occupied;
+		int phase = 0;
+
+		data->featureStart[i] = n;
+		for (int j = 0; occupied; j++) {
+			int sq = popBit(&occupied);
+			int piece = (record->pieces[j >> 1] >> ((j & 1) * 4)) & 15;
+			int type = pieceType(piece);
+
+			if (pieceColor(piece) == 0) { data->features[n++] = (unsigned short)((type - 1) * 64 + sq); }
+			else { data->features[n++] = (unsigned short)(TUNE_FEATURES_MACRO + (type - 1) * 64 + (sq ^ 56)); }
+			phase += phaseWeight[type];
+		}
+		data->phase[i] = (phase > 24 ? 24 : phase) / 24.0f;
+
+		float result = record->result == GAME_WHITE_WINS ? 1.0f : record->result == GAME_BLACK_WINS ? 0.0f : 0.5f;
+		int score = record->flags & 1 ? -record->score : record->score;
+		data->target[i] = (1.0f - lambda) * result + lambda / (1.0f + powf(10.0f, -score / 400.0f));
+	}
+	data->featureStart[data->count] = n;
+
+	unmapFile(&mf);
+	return 0;
+}
+
+void freeTuneData(tuneData_s* data) {
+
+	free(data->featureStart);
+	free(data->features);
+	free(data->phase);
+	free(data->target);
+	memset(data, 0, sizeof(tuneData_s));
+}
+
+inline __m128 exp2Fast(__m128 x) { /* 2^x To About 1e-7, Four At Once With SSE2 */
+
+	x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(126.0f));
+
+	/* Split Into Integer And Fraction, Truncation Rounds Negative Numbers The Wrong Way */
+	__m128 whole = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+	whole = _mm_sub_ps(whole, _mm_and_ps(_mm_cmpgt_ps(whole, x), _mm_set1_ps(1.0f)));
+	__m128 f = _mm_sub_ps(x, whole);
+
+	__m128 p = _mm_set1_ps(0.0013333558f);
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(0.0096181291f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(0.0555041087f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(0.2402265070f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(0.6931471806f));
+	p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.0f));
+
+	/* Times 2^whole, Straight Into The Exponent Bits */
+	__m128i exponent = _mm_slli_epi32(_mm_cvttps_epi32(whole), 23);
+	return _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(p), exponent));
+}
+
+DWORD WINAPI tuneThread(LPVOID param) { /* Loss And Gradient Over positions [first, last) */
+
+	tuneWorker_s* w = (tuneWorker_s*)param;
+	const tuneData_s* data = w->data;
+	alignas(16) float mg[TUNE_CHUNK_MACRO];
+	alignas(16) float eg[TUNE_CHUNK_MACRO];
+	alignas(16) float phase[TUNE_CHUNK_MACRO];
+	alignas(16) float target[TUNE_CHUNK_MACRO];
+	alignas(16) float lanes[4];
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128 k = _mm_set1_ps(-w->k);
+
+
+	w->loss = 0.0;
+	memset(w->gradMG, 0, sizeof(w->gradMG));
+	memset(w->gradEG, 0, sizeof(w->gradEG));
+
+	for (int base = w->first; base < w->last; base += TUNE_CHUNK_MACRO) {
+		int n = w->last - base < TUNE_CHUNK_MACRO ? w->last - base : TUNE_CHUNK_MACRO;
+
+		/* Sparse Part, About 25 Table Lookups Per Position */
+		for (int j = 0; j < n; j++) {
+			float sumMG = 0.0f;
+			float sumEG = 0.0f;
+			for (unsigned int f = data->featureStart[base + j]; f < data->featureStart[base + j + 1]; f++) {
+				sumMG += w->weightsMG[data->features[f]];
+				sumEG += w->weightsEG[data->features[f]];
+			}
+			mg[j] = sumMG;
+			eg[j] = sumEG;
+		}
+		memcpy(phase, data->phase + base, n * sizeof(float));
+		memcpy(target, data->target + base, n * sizeof(float));
+
+		/* Padding Lanes Evaluate To 0 With A Target Of 0.5, Exactly No Error */
+		int padded = (n + 3) & ~3;
+		for (int j = n; j < padded; j++) { mg[j] = eg[j] = phase[j] = 0.0f; target[j] = 0.5f; }
+
+		/* Dense Part, Sigmoid And Error Four Positions At A Time */
+		__m128 loss = _mm_setzero_ps();
+		for (int j = 0; j < padded; j += 4) {
+			__m128 rho = _mm_load_ps(phase + j);
+			__m128 eval = _mm_add_ps(_mm_mul_ps(_mm_load_ps(mg + j), rho), _mm_mul_ps(_mm_load_ps(eg + j), _mm_sub_ps(one, rho)));
+			__m128 s = _mm_div_ps(one, _mm_add_ps(one, exp2Fast(_mm_mul_ps(k, eval))));
+			__m128 error = _mm_sub_ps(_mm_load_ps(target + j), s);
+			loss = _mm_add_ps(loss, _mm_mul_ps(error, error));
+
+			/* d Loss / d eval Up To A Constant, Split Between The Two Phases */
+			__m128 c = _mm_mul_ps(error, _mm_mul_ps(s, _mm_sub_ps(one, s)));
+			__m128 cMG = _mm_mul_ps(c, rho);
+			_mm_store_ps(mg + j, cMG);
+			_mm_store_ps(eg + j, _mm_sub_ps(c, cMG));
+		}
+		_mm_store_ps(lanes, loss);
+		w->loss += (double)lanes[0] + lanes[1] + lanes[2] + lanes[3]; /* Float Lanes Only Sum One Chunk, Millions Would Lose Precision */
+
+		if (!w->bGradient) { continue; }
+		for (int j = 0; j < n; j++) {
+			for (unsigned int f = data->featureStart[base + j]; f < data->featureStart[base + j + 1]; f++) {
+				w->gradMG[data->features[f]] += mg[j];
+				w->gradEG[data->features[f]] += eg[j];
+			}
+		}
+	}
+	return 0;
+}
+
+double runTunePass(tuneState_s* state, float k, bool bGradient) { /* Mean Squared Error Over Every Position, Gradients Left In The Workers */
+
+	HANDLE threads[TUNE_MAX_THREADS_MACRO];
+	double loss = 0.0;
+
+
+	for (int i = 0; i < state->threads; i++) {
+		tuneWorker_s* w = &state->workers[i];
+		w->data = &state->data;
+		w->weightsMG = state->weightsMG;
+		w->weightsEG = state->weightsEG;
+		w->k = k * 3.3219281f / 400.0f; /* 10^x = 2^(x log2(10)) */
+		w->bGradient = bGradient;
+		w->first = (int)((long long)state->data.count * i / state->threads);
+		w->last = (int)((long long)state->data.count * (i + 1) / state->threads);
+	}
+
+	if (state->threads == 1) { tuneThread(&state->workers[0]); }
+	else {
+		for (int i = 0; i < state->threads; i++) { threads[i] = CreateThread(NULL, 0, tuneThread, &state->workers[i], 0, NULL); }
+		WaitForMultipleObjects(state->threads, threads, TRUE, INFINITE);
+		for (int i = 0; i < state->threads; i++) { CloseHandle(threads[i]); }
+	}
+
+	for (int i = 0; i < state->threads; i++) { loss += state->workers[i].loss; }
+	return loss / (state->data.count ? state->data.count : 1);
+}
+
+void setTuneWeights(tuneState_s* state, const float* valueMG, const float* valueEG, const float* squareMG, const float* squareEG) {
+
+	for (int f = 0; f < TUNE_FEATURES_MACRO; f++) {
+		state->weightsMG[f] = valueMG[f / 64] + squareMG[f];
+		state->weightsEG[f] = valueEG[f / 64] + squareEG[f];
+		state->weightsMG[TUNE_FEATURES_MACRO + f] = -state->weightsMG[f];
+		state->weightsEG[TUNE_FEATURES_MACRO + f] = -state->weightsEG[f];
+	}
+}
+
+float fitTuneScale(tuneState_s* state) { /* Texel's K, The Scale That Best Explains The Results With The Current Weights */
+
+	float low = 0.1f;
+	float high = 3.0f;
+
+
+	for (int i = 0; i < 20; i++) {
+		float a = low + (high - low) / 3.0f;
+		float b = high - (high - low) / 3.0f;
+		if (runTunePass(state, a, false) < runTunePass(state, b, false)) { high = b; } else { low = a; }
+	}
+	return (low + high) / 2.0f;
+}
+
+int writeTuneHeader(const char* filepath, const float* valueMG, const float* valueEG, const float* squareMG, const float* squareEG, int count, double loss) { /* Returns 1 For Error */
+
+	const char* names[2] = { "pieceSquareMG", "pieceSquareEG" };
+	const float* tables[2] = { squareMG, squareEG };
+	FILE* file;
+
+
+	if (fopen_s(&file, filepath, "wb") != 0) { return 1; }
+
+	fprintf(file, "/* Generated By jonochess --tune From %d Positions, Loss %.6f */\n", count, loss);
+	fprintf(file, "/* Source.c Includes This In Place Of Its Own Tables When It Is Next To It, Same Layout: White's Side With Rank 8 On Top */\n\n");
+	fprintf(file, "constexpr int pieceValueMG[6] = { %d, %d, %d, %d, %d, 0 };\n", (int)lrintf(valueMG[0]), (int)lrintf(valueMG[1]), (int)lrintf(valueMG[2]), (int)lrintf(valueMG[3]), (int)lrintf(valueMG[4]));
+	fprintf(file, "constexpr int pieceValueEG[6] = { %d, %d, %d, %d, %d, 0 };\n", (int)lrintf(valueEG[0]), (int)lrintf(valueEG[1]), (int)lrintf(valueEG[2]), (int)lrintf(valueEG[3]), (int)lrintf(valueEG[4]));
+
+	for (int t = 0; t < 2; t++) {
+		fprintf(file, "\nconstexpr int %s[6][64] = {\n", names[t]);
+		for (int type = 0; type < 6; type++) {
+			for (int sq = 0; sq < 64; sq++) {
+				fprintf(file, "%s%4d%s", sq == 0 ? "\t{" : sq % 8 == 0 ? "\t " : "", (int)lrintf(tables[t][type * 64 + sq]), sq == 63 ? (type == 5 ? " }\n" : " },\n") : sq % 8 == 7 ? ",\n" : ",");
+			}
+		}
+		fprintf(file, "};\n");
+	}
+
+	return fclose(file) ? 1 : 0;
+}
+
+int tuneMain(int argc, char** argv) { /* jonochess --tune <data.jctd> [options], Adam Over The Material And Piece Square Tables */
+
+	static tuneState_s tuneState; /* Gradient Arrays Are Too Big For The Stack */
+	tuneState_s* state = &tuneState;
+	const char* dataPath = NULL;
+	const char* outPath = TUNE_OUTPUT_PATH;
+	int epochs = 200;
+	float rate = 1.0f;
+	float lambda = 0.0f;
+	float k = 0.0f;
+	SYSTEM_INFO sysInfo;
+
+	/* Parameters, Then Adam's Moment Estimates In The Same Layout */
+	float params[12 + TUNE_FEATURES_MACRO * 2];
+	float m[12 + TUNE_FEATURES_MACRO * 2] = { 0 };
+	float v[12 + TUNE_FEATURES_MACRO * 2] = { 0 };
+	float grad[12 + TUNE_FEATURES_MACRO * 2];
+	float* valueMG = params;
+	float* valueEG = params + 6;
+	float* squareMG = params + 12;
+	float* squareEG = params + 12 + TUNE_FEATURES_MACRO;
+
+
+	GetSystemInfo(&sysInfo);
+	state->threads = (int)sysInfo.dwNumberOfProcessors;
+
+	for (int i = 2; i < argc; i++) {
+		bool bValue = i + 1 < argc;
+		if (argv[i][0] != '-')                            { dataPath = argv[i]; }
+		else if (bValue && !strcmp(argv[i], "--out"))     { outPath = argv[++i]; }
+		else if (bValue && !strcmp(argv[i], "--epochs"))  { epochs = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--lr"))      { rate = (float)atof(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--lambda"))  { lambda = (float)atof(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--k"))       { k = (float)atof(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--threads")) { state->threads = atoi(argv[++i]); }
+		else { fprintf(stderr, "Unknown tune argument %s\n", argv[i]); return 1; }
+	}
+
+	if (dataPath == NULL) {
+		fputs("usage: jonochess --tune <data.jctd> [--out evalweights.h] [--epochs N] [--lr R] [--lambda L] [--k K] [--threads N]\n", stderr);
+		return 1;
+	}
+	if (state->threads < 1) { state->threads = 1; }
+	if (state->threads > TUNE_MAX_THREADS_MACRO) { state->threads = TUNE_MAX_THREADS_MACRO; }
+
+	initEngine();
+	DWORD start = timeGetTime();
+	if (loadTuneData(dataPath, lambda, &state->data)) { fputs("File error", stderr); return 1; }
+	fprintf(stdout, "Loaded %d positions in %u ms\n", state->data.count, timeGetTime() - start);
+
+	/* Start From The Current Tables */
+	for (int type = 0; type < 6; type++) {
+		valueMG[type] = (float)pieceValueMG[type];
+		valueEG[type] = (float)pieceValueEG[type];
+		for (int sq = 0; sq < 64; sq++) {
+			squareMG[type * 64 + sq] = (float)pieceSquareMG[type][sq];
+			squareEG[type * 64 + sq] = (float)pieceSquareEG[type][sq];
+		}
+	}
+	setTuneWeights(state, valueMG, valueEG, squareMG, squareEG);
+
+	if (k <= 0.0f) { k = fitTuneScale(state); }
+	double loss = runTunePass(state, k, false);
+	fprintf(stdout, "K %.4f, starting loss %.6f\n", k, loss);
+	fflush(stdout);
+
+	start = timeGetTime();
+	for (int epoch = 1; epoch <= epochs; epoch++) {
+		loss = runTunePass(state, k, true);
+
+		/* Black Halves Carry Negated Weights, So Their Gradient Counts Against The Shared Parameter */
+		memset(grad, 0, sizeof(grad));
+		for (int i = 0; i < state->threads; i++) {
+			const tuneWorker_s* w = &state->workers[i];
+			for (int f = 0; f < TUNE_FEATURES_MACRO; f++) {
+				grad[12 + f] -= (float)(w->gradMG[f] - w->gradMG[TUNE_FEATURES_MACRO + f]);
+				grad[12 + TUNE_FEATURES_MACRO + f] -= (float)(w->gradEG[f] - w->gradEG[TUNE_FEATURES_MACRO + f]);
+			}
+		}
+		for (int f = 0; f < TUNE_FEATURES_MACRO; f++) {
+			grad[f / 64] += grad[12 + f];
+			grad[6 + f / 64] += grad[12 + TUNE_FEATURES_MACRO + f];
+		}
+		grad[5] = grad[11] = 0.0f; /* Kings Are Always On The Board, Their Value Cancels Out */
+
+		/* Adam, The Constant Factor Of The Gradient Cancels In m / sqrt(v) */
+		float correction1 = 1.0f - powf(0.9f, (float)epoch);
+		float correction2 = 1.0f - powf(0.999f, (float)epoch);
+		for (int i = 0; i < 12 + TUNE_FEATURES_MACRO * 2; i++) {
+			m[i] = 0.9f * m[i] + 0.1f * grad[i];
+			v[i] = 0.999f * v[i] + 0.001f * grad[i] * grad[i];
+			params[i] -= rate * (m[i] / correction1) / (sqrtf(v[i] / correction2) + 1e-8f);
+		}
+		setTuneWeights(state, valueMG, valueEG, squareMG, squareEG);
+
+		if (epoch % 10 == 0 || epoch == epochs) {
+			DWORD elapsed = timeGetTime() - start;
+			fprintf(stdout, "Epoch %d, loss %.6f, %u ms per pass, %lld positions/s\n",
+				epoch, loss, elapsed / epoch, (long long)state->data.count * epoch * 1000 / (elapsed ? elapsed : 1));
+			fflush(stdout);
+		}
+	}
+
+	loss = runTunePass(state, k, false);
+	if (writeTuneHeader(outPath, valueMG, valueEG, squareMG, squareEG, state->data.count, loss)) { fputs("File error", stderr); return 1; }
+	fprintf(stdout, "Final loss %.6f, weights written to %s\n", loss, outPath);
+
+	freeTuneData(&state->data);
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            EPD Suite                                                                                                       *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define EPD_MAX_THREADS_MACRO 64
+#define EPD_MAX_MOVES_MACRO 8
+#define EPD_ID_MACRO 64
+#define EPD_WRONG_MS 0xFFFFFFFF            /* epdProgress_s.correctSince While The Best Move Is Wrong */
+
+struct epdPosition_s {
+
+	position_s pos;
+	move_t best[EPD_MAX_MOVES_MACRO];     /* bm, Any Of Them Solves It */
+	int bestCount;
+	move_t avoid[EPD_MAX_MOVES_MACRO];    /* am, None Of Them May Be Played */
+	int avoidCount;
+	char id[EPD_ID_MACRO];
+	move_t found;                         /* Filled In By The Worker */
+	bool bSolved;
+	unsigned int solveMs;                 /* When The Best Move Turned Correct For Good */
+	unsigned long long nodes;
+};
+
+struct epdConfig_s {
+
+	const char* path = NULL;
+	int threads = 0;                      /* 0 For One Per Core, Each Position Gets One Thread */
+	int hashMB = 16;                      /* Per Thread */
+	searchLimits_s limits;
+};
+
+struct epdSuite_s {
+
+	epdConfig_s config;
+	epdPosition_s* positions;
+	int count;
+	int capacity;
+	int parsed;                           /* Valid FEN Lines, Numbers Positions Without An id */
+	int skipped;                          /* Lines Without bm Or am, Or With A Move That Does Not Parse */
+	volatile LONG next;
+	volatile LONG nextSlot;
+	searchEngine_s engines[EPD_MAX_THREADS_MACRO];
+};
+
+struct epdProgress_s { /* Watches The Main Line Of One Search */
+
+	const epdPosition_s* epd;
+	unsigned int correctSince;            /* EPD_WRONG_MS Until The Best Move Is Correct */
+};
+
+
+bool isEPDSolution(const epdPosition_s* epd, move_t m) {
+
+	if (m == 0) { return false; }
+	for (int i = 0; i < epd->avoidCount; i++) { if (epd->avoid[i] == m) { return false; } }
+	if (epd->bestCount == 0) { return true; }
+	for (int i = 0; i < epd->bestCount; i++) { if (epd->best[i] == m) { return true; } }
+	return false;
+}
+
+int parseEPDMoves(const position_s* pos, const char* p, const char* end, move_t* moves) { /* SAN Or UCI Operands Up To The ';', Returns How Many, -1 If One Does Not Parse */
+
+	char uci[8];
+	int count = 0;
+
+
+	while (p < end) {
+		while (p < end && *p == ' ') { p++; }
+		const char* start = p;
+		while (p < end && *p != ' ') { p++; }
+		if (p == start) { break; }
+
+		move_t m = parseSAN(pos, start, p - start);
+		if (m == 0 && p - start < (int)sizeof(uci)) {
+			memcpy(uci, start, p - start);
+			uci[p - start] = '\0';
+			m = parseUCIMove(pos, uci);
+		}
+		if (m == 0) { return -1; }
+		if (count < EPD_MAX_MOVES_MACRO) { moves[count++] = m; }
+	}
+	return count;
+}
+
+void addEPDPosition(const position_s* pos, const char* line, size_t length, void* user) { /* fenCallback_t, Reads The bm, am And id Operations */
+
+	epdSuite_s* suite = (epdSuite_s*)user;
+	const char* p = line;
+	const char* end = line + length;
+	epdPosition_s epd;
+
+
+	memset(&epd, 0, sizeof(epdPosition_s));
+	epd.pos = *pos;
+	sprintf(epd.id, "position %d", ++suite->parsed);
+
+	/* Operations Start After Board, Side, Castling And En Passant */
+	for (int field = 0; field < 4 && p < end; field++) {
+		while (p < end && *p == ' ') { p++; }
+		while (p < end && *p != ' ') { p++; }
+	}
+
+	while (p < end) {
+		while (p < end && (*p == ' ' || *p == ';')) { p++; }
+		const char* opcode = p;
+		while (p < end && *p != ' ' && *p != ';') { p++; }
+		size_t opcodeLength = p - opcode;
+
+		/* Operands Run To The ';' Unless It Is Inside A Quoted String */
+		const char* operands = p;
+		bool bQuoted = false;
+		while (p < end && (*p != ';' || bQuoted)) { if (*p == '"') { bQuoted = !bQuoted; } p++; }
+		const char* operandsEnd = p;
+
+		if (opcodeLength == 2 && !memcmp(opcode, "bm", 2)) {
+			epd.bestCount = parseEPDMoves(&epd.pos, operands, operandsEnd, epd.best);
+			if (epd.bestCount < 0) { suite->skipped++; return; }
+		}
+		else if (opcodeLength == 2 && !memcmp(opcode, "am", 2)) {
+			epd.avoidCount = parseEPDMoves(&epd.pos, operands, operandsEnd, epd.avoid);
+			if (epd.avoidCount < 0) { suite->skipped++; return; }
+		}
+		else if (opcodeLength == 2 && !memcmp(opcode, "id", 2)) {
+			const char* open = (const char*)memchr(operands, '"', operandsEnd - operands);
+			const char* close = open ? (const char*)memchr(open + 1, '"', operandsEnd - open - 1) : NULL;
+			if (close != NULL && close - open - 1 < EPD_ID_MACRO) { memcpy(epd.id, open + 1, close - open - 1); epd.id[close - open - 1] = '\0'; }
+		}
+	}
+
+	if (epd.bestCount == 0 && epd.avoidCount == 0) { suite->skipped++; return; } /* Nothing To Check Against */
+
+	if (suite->count == suite->capacity) {
+		suite->capacity = suite->capacity ? suite->capacity * 2 : 256;
+		suite->positions = (epdPosition_s*)realloc(suite->positions, sizeof(epdPosition_s) * suite->capacity);
+		if (suite->positions == NULL) { fputs("Memory error", stderr); exit(2); }
+	}
+	suite->positions[suite->count++] = epd;
+}
+
+void epdInfoCallback(const searchInfo_s* info, void* user) { /* Runs On The Position's Worker Thread */
+
+	epdProgress_s* progress = (epdProgress_s*)user;
+
+
+	if (info->multipv != 1 || info->pvLength == 0) { return; }
+	if (!isEPDSolution(progress->epd, info->pv[0])) { progress->correctSince = EPD_WRONG_MS; }
+	else if (progress->correctSince == EPD_WRONG_MS) { progress->correctSince = info->timeMs; }
+}
+
+DWORD WINAPI epdThread(LPVOID param) {
+
+	epdSuite_s* suite = (epdSuite_s*)param;
+	searchEngine_s* engine = &suite->engines[InterlockedIncrement(&suite->nextSlot) - 1];
+	epdProgress_s progress;
+
+
+	searchInit(engine, NULL, suite->config.hashMB, 1);
+	engine->onInfo = epdInfoCallback;
+	engine->onInfoUser = &progress;
+
+	while (true) {
+		int index = InterlockedIncrement(&suite->next) - 1;
+		if (index >= suite->count) { break; }
+
+		epdPosition_s* epd = &suite->positions[index];
+		progress.epd = epd;
+		progress.correctSince = EPD_WRONG_MS;
+
+		searchClearHistory(engine); /* Every Position Starts Cold, Results Do Not Depend On Which Thread Ran What */
+		epd->found = searchRun(engine, &epd->pos, NULL, 0, &suite->config.limits);
+		epd->nodes = searchTotalNodes(engine);
+		epd->bSolved = isEPDSolution(epd, epd->found);
+		epd->solveMs = progress.correctSince != EPD_WRONG_MS ? progress.correctSince : timeGetTime() - engine->startTime;
+	}
+
+	searchFree(engine);
+	return 0;
+}
+
+int epdMain(int argc, char** argv) { /* jonochess --epd <suite.epd> [--time ms] [options] */
+
+	static epdSuite_s epdSuite; /* Too Big For The Stack */
+	epdSuite_s* suite = &epdSuite;
+	epdConfig_s* config = &suite->config;
+	HANDLE threads[EPD_MAX_THREADS_MACRO];
+	SYSTEM_INFO sysInfo;
+	fenFileStats_s stats;
+	char san[8];
+	unsigned long long nodes = 0;
+	int solved = 0;
+
+
+	for (int i = 2; i < argc; i++) {
+		bool bValue = i + 1 < argc;
+		if (argv[i][0] != '-')                            { config->path = argv[i]; }
+		else if (bValue && !strcmp(argv[i], "--time"))    { config->limits.movetime = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--depth"))   { config->limits.depth = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--nodes"))   { config->limits.nodes = strtoull(argv[++i], NULL, 10); }
+		else if (bValue && !strcmp(argv[i], "--threads")) { config->threads = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--hash"))    { config->hashMB = atoi(argv[++i]); }
+		else { fprintf(stderr, "Unknown epd argument %s\n", argv[i]); return 1; }
+	}
+
+	if (config->path == NULL) { fputs("usage: jonochess --epd <suite.epd> [--time ms | --depth N | --nodes N] [--threads N] [--hash MB]\n", stderr); return 1; }
+	GetSystemInfo(&sysInfo);
+	if (config->threads < 1) { config->threads = (int)sysInfo.dwNumberOfProcessors; }
+	if (config->threads > EPD_MAX_THREADS_MACRO) { config->threads = EPD_MAX_THREADS_MACRO; }
+	if (config->hashMB < 1) { config->hashMB = 16; }
+	if (config->limits.movetime == 0 && config->limits.depth == 0 && config->limits.nodes == 0) { config->limits.movetime = 1000; }
+
+	initEngine();
+	if (forEachFEN(config->path, addEPDPosition, suite, &stats)) { fputs("File error", stderr); return 1; }
+	suite->skipped += (int)stats.skipped;
+	if (suite->count == 0) { fputs("No bm or am positions in file", stderr); return 1; }
+	if (config->threads > suite->count) { config->threads = suite->count; }
+
+	fprintf(stdout, "EPD: %d positions (%d skipped), %d threads\n", suite->count, suite->skipped, config->threads);
+	fflush(stdout);
+
+	DWORD start = timeGetTime();
+	for (int i = 0; i < config->threads; i++) { threads[i] = CreateThread(NULL, 0, epdThread, suite, 0, NULL); }
+	WaitForMultipleObjects(config->threads, threads, TRUE, INFINITE);
+	for (int i = 0; i < config->threads; i++) { CloseHandle(threads[i]); }
+	DWORD elapsed = timeGetTime() - start;
+
+	/* Failures In File Order, Then The Summary */
+	for (int i = 0; i < suite->count; i++) {
+		const epdPosition_s* epd = &suite->positions[i];
+		nodes += epd->nodes;
+		if (epd->bSolved) { solved++; continue; }
+
+		moveToSAN(&epd->pos, epd->found, san);
+		fprintf(stdout, "Failed %s: played %s, %s", epd->id, san, epd->bestCount ? "bm" : "am");
+		for (int j = 0; j < (epd->bestCount ? epd->bestCount : epd->avoidCount); j++) {
+			moveToSAN(&epd->pos, epd->bestCount ? epd->best[j] : epd->avoid[j], san);
+			fprintf(stdout, " %s", san);
+		}
+		fputc('\n', stdout);
+	}
+
+	fprintf(stdout, "\nSolved: %d/%d (%.1f%%)\n", solved, suite->count, solved * 100.0 / suite->count);
+
+	/* Cumulative, A Fixed Time Limit Splits Into Fractions Of It, Otherwise Powers Of Ten */
+	unsigned int buckets[6];
+	for (int b = 0; b < 6; b++) { buckets[b] = config->limits.movetime ? config->limits.movetime >> (5 - b) : (unsigned int)pow(10.0, b + 1); }
+	fputs("Time to solve:", stdout);
+	for (int b = 0; b < 6; b++) {
+		int within = 0;
+		for (int i = 0; i < suite->count; i++) { if (suite->positions[i].bSolved && suite->positions[i].solveMs <= buckets[b]) { within++; } }
+		fprintf(stdout, " <=%ums %d%s", buckets[b], within, b < 5 ? "," : "\n");
+	}
+
+	fprintf(stdout, "Nodes: %llu\nTime (ms): %u\nNodes/second: %llu\n", nodes, elapsed, nodes * 1000 / (elapsed ? elapsed : 1));
+
+	free(suite->positions);
+	return solved == suite->count ? 0 : 1;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Mate Solver                                                                                                     *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define MATE_MAX_THREADS_MACRO 64
+#define MATE_BUCKET_MACRO 4               /* Entries Per Bucket, The Least Searched One Makes Room */
+#define MATE_TREE_MACRO 4096              /* Nodes Kept Of The Proof Tree, Longer Trees Are Cut Off */
+#define MATE_INFINITE 0x7FFFFFFF          /* Proof And Disproof Numbers Saturate Here */
+#define MATE_GC_PERCENT 90                /* Garbage Collect Once The Table Is This Full */
+
+struct mateEntry_s {
+
+	unsigned long long key;               /* 0 For An Empty Slot */
+	unsigned int pn;                      /* 0 Is A Proof, MATE_INFINITE A Disproof */
+	unsigned int dn;
+	unsigned int amount;                  /* Nodes Searched Below, Decides What Garbage Collection Throws Away */
+	int depth;                            /* Plies Left When Stored, Proofs Also Hold With More And Disproofs With Fewer */
+};
+
+struct mateBucket_s {
+
+	volatile LONG lock;                   /* Spin Lock, Held For A Few Instructions At A Time */
+	mateEntry_s entries[MATE_BUCKET_MACRO];
+};
+
+struct mateTable_s { /* Bounded, Never Grows Past What Was Asked For */
+
+	mateBucket_s* buckets;
+	unsigned long long mask;
+	volatile LONG used;
+	LONG limit;                           /* Entries Before Garbage Collection */
+	int collections;
+};
+
+struct mateTreeNode_s { /* First Child, Next Sibling, Defences Are The Children Of Each Attacking Move */
+
+	move_t move;
+	char san[8];
+	unsigned short fullmove;
+	unsigned char side;
+	short child;
+	short sibling;
+};
+
+struct mateTree_s {
+
+	mateTreeNode_s nodes[MATE_TREE_MACRO];
+	int count;
+	bool bTruncated;
+};
+
+struct mateSolver_s {
+
+	mateTable_s table;
+	int threads;
+	volatile LONG bStop;
+	volatile LONG nextRoot;
+	position_s root;
+	int depth;                            /* Plies Of The Current Iteration, 2N - 1 For Mate In N */
+	move_t rootMoves[MAX_MOVES_MACRO];
+	int rootCount;
+	volatile LONG found;                  /* Root Move Proven By A Helper, 0 While None */
+	unsigned long long nodes[MATE_MAX_THREADS_MACRO];
+};
+
+struct mateWorker_s {
+
+	mateSolver_s* solver;
+	int id;
+};
+
+
+inline unsigned int addProofNumbers(unsigned int a, unsigned int b) { return a + b >= MATE_INFINITE ? MATE_INFINITE : a + b; }
+
+void mateTableInit(mateTable_s* table, size_t sizeMB) {
+
+	unsigned long long count = 1;
+
+
+	while (count * 2 * sizeof(mateBucket_s) <= (unsigned long long)sizeMB << 20) { count *= 2; }
+	table->buckets = (mateBucket_s*)calloc((size_t)count, sizeof(mateBucket_s));
+	if (table->buckets == NULL) { fputs("Memory error", stderr); exit(2); }
+	table->mask = count - 1;
+	table->used = 0;
+	table->limit = (LONG)(count * MATE_BUCKET_MACRO * MATE_GC_PERCENT / 100);
+	table->collections = 0;
+}
+
+void mateTableFree(mateTable_s* table) {
+
+	free(table->buckets); table->buckets = NULL;
+}
+
+inline void lockMateBucket(mateBucket_s* bucket) {
+
+	while (InterlockedCompareExchange(&bucket->lock, 1, 0) != 0) { YieldProcessor(); }
+}
+
+inline void unlockMateBucket(mateBucket_s* bucket) {
+
+	InterlockedExchange(&bucket->lock, 0);
+}
+
+bool mateLookup(mateTable_s* table, unsigned long long key, int depth, unsigned int* pn, unsigned int* dn) { /* false Leaves pn And dn At Their Starting Values */
+
+	mateBucket_s* bucket = &table->buckets[key & table->mask];
+	bool bFound = false;
+
+
+	lockMateBucket(bucket);
+	for (int i = 0; i < MATE_BUCKET_MACRO; i++) {
+		const mateEntry_s* entry = &bucket->entries[i];
+		if (entry->key != key) { continue; }
+
+		if (entry->pn == 0 && entry->depth <= depth)      { *pn = 0; *dn = MATE_INFINITE; bFound = true; }
+		else if (entry->dn == 0 && entry->depth >= depth) { *pn = MATE_INFINITE; *dn = 0; bFound = true; }
+		else if (entry->depth == depth)                   { *pn = entry->pn; *dn = entry->dn; bFound = true; }
+		break;
+	}
+	unlockMateBucket(bucket);
+	return bFound;
+}
+
+void mateStore(mateTable_s* table, unsigned long long key, int depth, unsigned int pn, unsigned int dn, unsigned int amount) {
+
+	mateBucket_s* bucket = &table->buckets[key & table->mask];
+	mateEntry_s* slot = NULL;
+
+
+	lockMateBucket(bucket);
+	for (int i = 0; i < MATE_BUCKET_MACRO; i++) {
+		mateEntry_s* entry = &bucket->entries[i];
+		if (entry->key == key) { slot = entry; break; }
+		if (entry->key == 0) { if (slot == NULL || slot->key != 0) { slot = entry; } continue; }
+		if (slot == NULL || (slot->key != 0 && entry->amount < slot->amount)) { slot = entry; }
+	}
+
+	/* A Full Bucket Only Gives Up Something Cheaper Than What Is Coming In */
+	if (slot->key == 0) { InterlockedIncrement(&table->used); }
+	if (slot->key == 0 || slot->key == key || slot->amount <= amount) {
+		slot->key = key;
+		slot->pn = pn;
+		slot->dn = dn;
+		slot->amount = amount;
+		slot->depth = depth;
+	}
+	unlockMateBucket(bucket);
+}
+
+inline int mateAmountClass(unsigned int amount) { return amount ? bitScanReverse(amount) + 1 : 0; } /* Log2 Buckets For Garbage Collection */
+
+void collectMateGarbage(mateTable_s* table) { /* Only While No Search Is Running, Drops The Cheaper Half Of What Is Not A Proof */
+
+	unsigned int histogram[33] = { 0 };
+	mateEntry_s* entries;
+	unsigned int seen = 0;
+	int cutoff = 0;
+
+
+	for (unsigned long long b = 0; b <= table->mask; b++) {
+		entries = table->buckets[b].entries;
+		for (int i = 0; i < MATE_BUCKET_MACRO; i++) {
+			if (entries[i].key != 0 && entries[i].pn != 0) { histogram[mateAmountClass(entries[i].amount)]++; }
+		}
+	}
+	while (cutoff < 32 && (seen += histogram[cutoff]) < (unsigned int)table->used / 2) { cutoff++; }
+
+	for (unsigned long long b = 0; b <= table->mask; b++) {
+		entries = table->buckets[b].entries;
+		for (int i = 0; i < MATE_BUCKET_MACRO; i++) {
+			if (entries[i].key == 0 || entries[i].pn == 0) { continue; }
+			if (mateAmountClass(entries[i].amount) <= cutoff) { memset(&entries[i], 0, sizeof(mateEntry_s)); table->used--; }
+		}
+	}
+	table->collections++;
+}
+
+unsigned int mateMID(mateWorker_s* worker, const position_s* pos, int depth, bool bOr, unsigned int thresholdPN, unsigned int thresholdDN, unsigned int* pnOut, unsigned int* dnOut) { /* Depth Limited df-pn, Returns The Nodes Searched */
+
+	mateSolver_s* solver = worker->solver;
+	move_t moves[MAX_MOVES_MACRO];
+	unsigned long long keys[MAX_MOVES_MACRO];
+	unsigned int childPN[MAX_MOVES_MACRO];
+	unsigned int childDN[MAX_MOVES_MACRO];
+	position_s child;
+	unsigned int pn = 1;
+	unsigned int dn = 1;
+	unsigned int amount = 1;
+	int count;
+
+
+	solver->nodes[worker->id]++;
+
+	/* Out Of Moves For The Attacker, Only An Immediate Mate Counts */
+	if (depth == 0) {
+		bool bMated = !bOr && inCheck(pos) && !hasLegalMove(pos);
+		pn = bMated ? 0 : MATE_INFINITE;
+		dn = bMated ? MATE_INFINITE : 0;
+		mateStore(&solver->table, pos->key, depth, pn, dn, amount);
+		*pnOut = pn; *dnOut = dn;
+		return amount;
+	}
+
+	count = generateLegalMoves(pos, moves);
+	if (count == 0) { /* Mate Proves An AND Node, Stalemate Disproves Either */
+		bool bMated = !bOr && inCheck(pos);
+		pn = bMated ? 0 : MATE_INFINITE;
+		dn = bMated ? MATE_INFINITE : 0;
+		mateStore(&solver->table, pos->key, depth, pn, dn, amount);
+		*pnOut = pn; *dnOut = dn;
+		return amount;
+	}
+
+	/* Checks First For The Attacker, The Order Breaks Ties Between Equal Proof Numbers */
+	int checks = 0;
+	for (int i = 0; i < count; i++) {
+		makeMove(pos, &child, moves[i]);
+		if (bOr && inCheck(&child)) {
+			move_t m = moves[i]; moves[i] = moves[checks]; moves[checks] = m;
+			keys[i] = keys[checks]; keys[checks] = child.key;
+			checks++;
+		}
+		else { keys[i] = child.key; }
+		childPN[i] = childDN[i] = 1;
+	}
+	for (int i = 0; i < count; i++) { mateLookup(&solver->table, keys[i], depth - 1, &childPN[i], &childDN[i]); }
+
+	while (!solver->bStop) {
+		int best = 0;
+		unsigned int second = MATE_INFINITE;
+
+		if (bOr) { /* Proof Is The Easiest Child's, Disproof Needs Every Child */
+			pn = MATE_INFINITE; dn = 0;
+			for (int i = 0; i < count; i++) {
+				dn = addProofNumbers(dn, childDN[i]);
+				if (childPN[i] < pn) { second = pn; pn = childPN[i]; best = i; }
+				else if (childPN[i] < second) { second = childPN[i]; }
+			}
+		}
+		else {
+			pn = 0; dn = MATE_INFINITE;
+			for (int i = 0; i < count; i++) {
+				pn = addProofNumbers(pn, childPN[i]);
+				if (childDN[i] < dn) { second = dn; dn = childDN[i]; best = i; }
+				else if (childDN[i] < second) { second = childDN[i]; }
+			}
+		}
+		if (pn >= thresholdPN || dn >= thresholdDN) { break; }
+
+		/* The Child Gets What Is Left Of Our Budget, Capped Where Its Sibling Would Overtake It */
+		unsigned int nextPN;
+		unsigned int nextDN;
+		if (bOr) {
+			nextPN = thresholdPN < addProofNumbers(second, 1) ? thresholdPN : addProofNumbers(second, 1);
+			nextDN = thresholdDN == MATE_INFINITE ? MATE_INFINITE : addProofNumbers(thresholdDN - dn, childDN[best]);
+		}
+		else {
+			nextDN = thresholdDN < addProofNumbers(second, 1) ? thresholdDN : addProofNumbers(second, 1);
+			nextPN = thresholdPN == MATE_INFINITE ? MATE_INFINITE : addProofNumbers(thresholdPN - pn, childPN[best]);
+		}
+
+		makeMove(pos, &child, moves[best]);
+		amount += mateMID(worker, &child, depth - 1, !bOr, nextPN, nextDN, &childPN[best], &childDN[best]);
+	}
+
+	mateStore(&solver->table, pos->key, depth, pn, dn, amount);
+	if (solver->threads == 1 && solver->table.used >= solver->table.limit) { collectMateGarbage(&solver->table); } /* Children Are Cached Above, Safe Mid Search */
+	*pnOut = pn; *dnOut = dn;
+	return amount;
+}
+
+DWORD WINAPI mateRootThread(LPVOID param) { /* Helpers Split The Root Moves, Each Proves Or Disproves Its Own */
+
+	mateWorker_s* worker = (mateWorker_s*)param;
+	mateSolver_s* solver = worker->solver;
+	position_s child;
+	unsigned int pn;
+	unsigned int dn;
+
+
+	while (!solver->bStop) {
+		int index = InterlockedIncrement(&solver->nextRoot) - 1;
+		if (index >= solver->rootCount) { break; }
+
+		makeMove(&solver->root, &child, solver->rootMoves[index]);
+		mateMID(worker, &child, solver->depth - 1, false, MATE_INFINITE, MATE_INFINITE, &pn, &dn);
+		if (pn == 0) {
+			InterlockedCompareExchange(&solver->found, solver->rootMoves[index], 0);
+			InterlockedExchange(&solver->bStop, 1);
+		}
+	}
+	return 0;
+}
+
+bool proveMate(mateSolver_s* solver, const position_s* pos, int depth, bool bOr) { /* Straight From The Table When It Knows, Searched Again When Garbage Collection Took It */
+
+	mateWorker_s worker = { solver, 0 };
+	unsigned int pn = 1;
+	unsigned int dn = 1;
+
+
+	if (!mateLookup(&solver->table, pos->key, depth, &pn, &dn) || (pn != 0 && dn != 0)) {
+		mateMID(&worker, pos, depth, bOr, MATE_INFINITE, MATE_INFINITE, &pn, &dn);
+	}
+	return pn == 0;
+}
+
+int addMateTreeNode(mateTree_s* tree, const position_s* pos, move_t m, short* link) { /* Returns The Node, -1 Once The Tree Is Full */
+
+	if (tree->count == MATE_TREE_MACRO) { tree->bTruncated = true; return -1; }
+
+	mateTreeNode_s* node = &tree->nodes[tree->count];
+	node->move = m;
+	moveToSAN(pos, m, node->san);
+	node->fullmove = pos->fullmoveNumber;
+	node->side = pos->sideToMove;
+	node->child = node->sibling = -1;
+	*link = (short)tree->count;
+	return tree->count++;
+}
+
+void extractMateTree(mateSolver_s* solver, mateTree_s* tree, const position_s* pos, int depth, short* link) { /* Fastest Mate Against Every Defence */
+
+	move_t moves[MAX_MOVES_MACRO];
+	position_s child;
+	int count = generateLegalMoves(pos, moves);
+
+
+	if (depth == 0 || count == 0) { return; }
+
+	if (pos->sideToMove == solver->root.sideToMove) {
+		/* Shortest First, Any Move That Mates In k Plies Is Part Of A Minimal Tree */
+		for (int k = 1; k <= depth; k += 2) {
+			for (int i = 0; i < count; i++) {
+				makeMove(pos, &child, moves[i]);
+				if (!proveMate(solver, &child, k - 1, false)) { continue; }
+
+				int node = addMateTreeNode(tree, pos, moves[i], link);
+				if (node >= 0) { extractMateTree(solver, tree, &child, k - 1, &tree->nodes[node].child); }
+				return;
+			}
+		}
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		makeMove(pos, &child, moves[i]);
+		int node = addMateTreeNode(tree, pos, moves[i], link);
+		if (node < 0) { return; }
+		extractMateTree(solver, tree, &child, depth - 1, &tree->nodes[node].child);
+		link = &tree->nodes[node].sibling;
+	}
+}
+
+int solveMate(const position_s* pos, int maxMoves, int threads, size_t hashMB, mateTree_s* tree, unsigned long long* nodes) { /* Returns N For The Shortest Mate In N, 0 If There Is None Within maxMoves */
+
+	static mateSolver_s solver; /* Shared With The Helper Threads */
+	mateWorker_s workers[MATE_MAX_THREADS_MACRO];
+	HANDLE handles[MATE_MAX_THREADS_MACRO];
+	unsigned int pn;
+	unsigned int dn;
+	int mate = 0;
+
+
+	if (threads < 1) { threads = 1; }
+	if (threads > MATE_MAX_THREADS_MACRO) { threads = MATE_MAX_THREADS_MACRO; }
+
+	memset(solver.nodes, 0, sizeof(solver.nodes));
+	mateTableInit(&solver.table, hashMB);
+	solver.threads = threads;
+	solver.root = *pos;
+	solver.rootCount = generateLegalMoves(pos, solver.rootMoves);
+	tree->count = 0;
+	tree->bTruncated = false;
+
+	/* Iterative Deepening On The Mate Length, The First Length That Proves Is The Shortest */
+	for (int n = 1; n <= maxMoves && mate == 0; n++) {
+		solver.depth = 2 * n - 1;
+		solver.bStop = 0;
+		solver.found = 0;
+
+		if (threads == 1) {
+			workers[0].solver = &solver;
+			workers[0].id = 0;
+			mateMID(&workers[0], pos, solver.depth, true, MATE_INFINITE, MATE_INFINITE, &pn, &dn);
+			if (pn == 0) { mate = n; }
+		}
+		else {
+			solver.nextRoot = 0;
+			for (int i = 0; i < threads; i++) {
+				workers[i].solver = &solver;
+				workers[i].id = i;
+				handles[i] = CreateThread(NULL, 0, mateRootThread, &workers[i], 0, NULL);
+			}
+			WaitForMultipleObjects(threads, handles, TRUE, INFINITE);
+			for (int i = 0; i < threads; i++) { CloseHandle(handles[i]); }
+			if (solver.found) { mate = n; }
+		}
+
+		if (solver.table.used >= solver.table.limit) { collectMateGarbage(&solver.table); }
+	}
+
+	*nodes = 0;
+	for (int i = 0; i < threads; i++) { *nodes += solver.nodes[i]; }
+
+	if (mate) {
+		solver.threads = 1; /* Extraction Runs On This Thread Alone */
+		solver.bStop = 0;
+		short root = -1;
+		extractMateTree(&solver, tree, pos, solver.depth, &root);
+	}
+	mateTableFree(&solver.table);
+	return mate;
+}
+
+int appendMateMove(const mateTreeNode_s* node, bool bNumber, char* str) {
+
+	if (node->side == 0) { return sprintf(str, "%d. %s", node->fullmove, node->san); }
+	if (bNumber) { return sprintf(str, "%d... %s", node->fullmove, node->san); }
+	return sprintf(str, "%s", node->san);
+}
+
+int formatMateLine(const mateTree_s* tree, int node, bool bNumber, char* str) { /* PGN Style With Other Defences As Variations, Returns The Length */
+
+	int len = 0;
+
+
+	while (node >= 0) {
+		const mateTreeNode_s* attack = &tree->nodes[node];
+		if (len) { str[len++] = ' '; }
+		len += appendMateMove(attack, bNumber, str + len);
+		if (attack->child < 0) { break; }
+
+		/* The First Defence Carries On The Line, The Rest Follow It As Variations */
+		const mateTreeNode_s* defence = &tree->nodes[attack->child];
+		str[len++] = ' ';
+		len += appendMateMove(defence, false, str + len);
+
+		for (int other = defence->sibling; other >= 0; other = tree->nodes[other].sibling) {
+			len += sprintf(str + len, " (");
+			len += appendMateMove(&tree->nodes[other], true, str + len);
+			if (tree->nodes[other].child >= 0) { str[len++] = ' '; len += formatMateLine(tree, tree->nodes[other].child, false, str + len); }
+			str[len++] = ')';
+		}
+
+		bNumber = defence->sibling >= 0;
+		node = defence->child;
+	}
+	str[len] = '\0';
+	return len;
+}
+
+struct mateSuite_s {
+
+	position_s* positions;
+	int count;
+	int capacity;
+};
+
+void addMatePosition(const position_s* pos, const char* line, size_t length, void* user) { /* fenCallback_t */
+
+	mateSuite_s* suite = (mateSuite_s*)user;
+
+
+	if (suite->count == suite->capacity) {
+		suite->capacity = suite->capacity ? suite->capacity * 2 : 256;
+		suite->positions = (position_s*)realloc(suite->positions, sizeof(position_s) * suite->capacity);
+		if (suite->positions == NULL) { fputs("Memory error", stderr); exit(2); }
+	}
+	suite->positions[suite->count++] = *pos;
+}
+
+int mateMain(int argc, char** argv) { /* jonochess --mate "<fen>" | <puzzles.epd> [--moves N] [options] */
+
+	static mateTree_s tree; /* Too Big For The Stack */
+	mateSuite_s suite = { NULL, 0, 0 };
+	const char* source = NULL;
+	SYSTEM_INFO sysInfo;
+	fenFileStats_s stats;
+	position_s single;
+	int maxMoves = 5;
+	int threads = 1;
+	int hashMB = 256;
+	int solved = 0;
+	unsigned long long totalNodes = 0;
+
+
+	for (int i = 2; i < argc; i++) {
+		bool bValue = i + 1 < argc;
+		if (argv[i][0] != '-')                            { source = argv[i]; }
+		else if (bValue && !strcmp(argv[i], "--moves"))   { maxMoves = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--threads")) { threads = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--hash"))    { hashMB = atoi(argv[++i]); }
+		else { fprintf(stderr, "Unknown mate argument %s\n", argv[i]); return 1; }
+	}
+
+	if (source == NULL) { fputs("usage: jonochess --mate \"<fen>\" | <puzzles.epd> [--moves N] [--threads N] [--hash MB]\n", stderr); return 1; }
+	GetSystemInfo(&sysInfo);
+	if (threads < 1) { threads = (int)sysInfo.dwNumberOfProcessors; }
+	if (maxMoves < 1) { maxMoves = 5; }
+	if (hashMB < 1) { hashMB = 256; }
+
+	/* A FEN On The Command Line, Otherwise A File Of Them */
+	initEngine();
+	if (parseFEN(&single, source) == 0) { addMatePosition(&single, source, strlen(source), &suite); }
+	else if (forEachFEN(source, addMatePosition, &suite, &stats)) { fputs("File error", stderr); return 1; }
+	if (suite.count == 0) { fputs("No positions in file", stderr); return 1; }
+
+	DWORD start = timeGetTime();
+	for (int i = 0; i < suite.count; i++) {
+		unsigned long long nodes;
+		DWORD positionStart = timeGetTime();
+		int mate = solveMate(&suite.positions[i], maxMoves, threads, hashMB, &tree, &nodes);
+		DWORD elapsed = timeGetTime() - positionStart;
+		totalNodes += nodes;
+
+		if (mate == 0) { fprintf(stdout, "%d: no mate in %d (%llu nodes, %u ms)\n", i + 1, maxMoves, nodes, elapsed); continue; }
+
+		/* A Move Number, SAN And Brackets Per Node Stay Well Under 32 Chars */
+		char* line = (char*)malloc((size_t)tree.count * 32 + 64);
+		if (line == NULL) { fputs("Memory error", stderr); exit(2); }
+		formatMateLine(&tree, 0, true, line);
+		fprintf(stdout, "%d: mate in %d (%llu nodes, %u ms)%s\n%s\n", i + 1, mate, nodes, elapsed, tree.bTruncated ? ", tree truncated" : "", line);
+		free(line);
+		solved++;
+	}
+	DWORD elapsed = timeGetTime() - start;
+
+	fprintf(stdout, "\nSolved: %d/%d\nNodes: %llu\nTime (ms): %u\nNodes/second: %llu\n", solved, suite.count, totalNodes, elapsed, totalNodes * 1000 / (elapsed ? elapsed : 1));
+	free(suite.positions);
+	return solved == suite.count ? 0 : 1;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Puzzle Extraction                                                                                               *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define PUZZLE_MAX_THREADS_MACRO 64
+#define PUZZLE_QUEUE_MACRO 256                /* Items Per Stage, The Stage Before Waits Once It Is Full */
+#define PUZZLE_SEEN_MACRO (1 << 20)           /* Direct Mapped Position Keys, Openings Repeated Across Games Are Searched Once */
+#define PUZZLE_MAX_MOVES_MACRO 8              /* Solver Moves In One Solution Line */
+#define PUZZLE_WIN_SCORE 200                  /* Only The Solution May Reach It, Every Other Move Stays Below */
+#define PUZZLE_TEXT_MACRO 640
+
+struct boundedQueue_s { /* Fixed Ring Of Items, Push Waits While It Is Full And Pop While It Is Empty, So Memory Never Grows */
+
+	CRITICAL_SECTION lock;
+	CONDITION_VARIABLE notEmpty;
+	CONDITION_VARIABLE notFull;
+	unsigned char* items;
+	size_t itemSize;
+	int capacity;
+	int head;
+	int count;
+	bool bClosed;                             /* No More Pushes, Pop Drains What Is Left */
+};
+
+struct puzzleCandidate_s {
+
+	position_s pos;
+	unsigned int game;                        /* 1 Based Like --db */
+	unsigned short ply;                       /* Plies Played Before pos */
+};
+
+struct puzzleText_s {
+
+	char text[PUZZLE_TEXT_MACRO];
+};
+
+struct puzzleConfig_s {
+
+	const char* source = NULL;
+	const char* output = NULL;
+	int threads = 0;                          /* 0 For One Per Core, Split Between The Shallow And Deep Stages */
+	int hashMB = 16;                          /* Per Thread */
+	int minPly = 16;                          /* Openings Are Not Puzzles */
+	int margin = 300;                         /* Centipawns Between The Solution And The Next Best Move */
+	int maxMoves = 4;                         /* Solver Moves, The Line Ends Earlier Once The Best Move Is No Longer Unique */
+	unsigned long long shallowNodes = 20000;
+	unsigned long long deepNodes = 1000000;
+};
+
+struct puzzleState_s {
+
+	puzzleConfig_s config;
+	gameDB_s db;
+	bool bDB;
+	boundedQueue_s candidates;                /* Reader -> Shallow */
+	boundedQueue_s verified;                  /* Shallow -> Deep */
+	boundedQueue_s puzzles;                   /* Deep -> Writer */
+	unsigned long long* seen;
+	int shallowThreads;
+	int deepThreads;
+	volatile LONG shallowLive;                /* The Last One Out Closes The Next Queue */
+	volatile LONG deepLive;
+	volatile LONG nextSlot;
+	unsigned long long games;                 /* Only The Reader Writes These */
+	unsigned long long positions;
+	volatile LONG shallowDone;
+	volatile LONG shallowPassed;
+	volatile LONG deepDone;
+	searchEngine_s engines[PUZZLE_MAX_THREADS_MACRO];
+};
+
+
+void queueInit(boundedQueue_s* queue, size_t itemSize, int capacity) {
+
+	queue->items = (unsigned char*)malloc(itemSize * capacity);
+	if (queue->items == NULL) { fputs("Memory error", stderr); exit(2); }
+	queue->itemSize = itemSize;
+	queue->capacity = capacity;
+	queue->head = 0;
+	queue->count = 0;
+	queue->bClosed = false;
+	InitializeCriticalSection(&queue->lock);
+	InitializeConditionVariable(&queue->notEmpty);
+	InitializeConditionVariable(&queue->notFull);
+}
+
+void queueFree(boundedQueue_s* queue) {
+
+	DeleteCriticalSection(&queue->lock);
+	free(queue->items);
+	queue->items = NULL;
+}
+
+void queuePush(boundedQueue_s* queue, const void* item) { /* Blocks While Full, That Is What Keeps A Fast Stage From Running Ahead */
+
+	EnterCriticalSection(&queue->lock);
+	while (queue->count == queue->capacity) { SleepConditionVariableCS(&queue->notFull, &queue->lock, INFINITE); }
+	memcpy(queue->items + (size_t)((queue->head + queue->count) % queue->capacity) * queue->itemSize, item, queue->itemSize);
+	queue->count++;
+	WakeConditionVariable(&queue->notEmpty);
+	LeaveCriticalSection(&queue->lock);
+}
+
+int queuePop(boundedQueue_s* queue, void* item, DWORD timeoutMs) { /* Returns 1 For An Item, 0 On Timeout, -1 Once Closed And Empty */
+
+	int result = 1;
+
+
+	EnterCriticalSection(&queue->lock);
+	while (queue->count == 0 && !queue->bClosed) {
+		if (!SleepConditionVariableCS(&queue->notEmpty, &queue->lock, timeoutMs) && queue->count == 0 && !queue->bClosed) { result = 0; break; }
+	}
+	if (result == 1 && queue->count == 0) { result = -1; }
+	if (result == 1) {
+		memcpy(item, queue->items + (size_t)queue->head * queue->itemSize, queue->itemSize);
+		queue->head = (queue->head + 1) % queue->capacity;
+		queue->count--;
+		WakeConditionVariable(&queue->notFull);
+	}
+	LeaveCriticalSection(&queue->lock);
+	return result;
+}
+
+void queueClose(boundedQueue_s* queue) {
+
+	EnterCriticalSection(&queue->lock);
+	queue->bClosed = true;
+	WakeAllConditionVariable(&queue->notEmpty);
+	LeaveCriticalSection(&queue->lock);
+}
+
+bool isUniqueWin(const searchEngine_s* engine, int margin) { /* From The Last MultiPV 2 Search, A Single Legal Move Is Not A Puzzle */
+
+	if (engine->lineCount < 2) { return false; }
+	return engine->lines[0].score >= PUZZLE_WIN_SCORE && engine->lines[1].score < PUZZLE_WIN_SCORE && engine->lines[0].score - engine->lines[1].score >= margin;
+}
+
+void addPuzzleGame(puzzleState_s* state, const position_s* start, const move_t* moves, int moveCount, unsigned int game) { /* Runs On The Reader Thread */
+
+	puzzleCandidate_s candidate;
+	position_s next;
+
+
+	candidate.pos = *start;
+	candidate.game = game;
+	state->games++;
+
+	for (int i = 0; i < moveCount; i++) {
+		if (!makeMove(&candidate.pos, &next, moves[i])) { break; }
+		candidate.pos = next;
+		candidate.ply = (unsigned short)(i + 1);
+		if (i + 1 < state->config.minPly) { continue; }
+
+		unsigned long long* slot = &state->seen[candidate.pos.key & (PUZZLE_SEEN_MACRO - 1)];
+		if (*slot == candidate.pos.key || !hasLegalMove(&candidate.pos)) { continue; }
+		*slot = candidate.pos.key;
+		state->positions++;
+		queuePush(&state->candidates, &candidate);
+	}
+}
+
+void addPuzzlePGNGame(const pgnGame_s* game, int worker, void* user) { /* pgnGameCallback_t, Read With One Thread So Games Keep Their File Order */
+
+	puzzleState_s* state = (puzzleState_s*)user;
+
+
+	addPuzzleGame(state, &game->start, game->moves, game->moveCount, (unsigned int)state->games + 1);
+}
+
+DWORD WINAPI puzzleReaderThread(LPVOID param) {
+
+	puzzleState_s* state = (puzzleState_s*)param;
+	pgnStats_s stats;
+
+
+	if (state->bDB) {
+		move_t* moves = (move_t*)malloc(MAX_GAME_PLY_MACRO * sizeof(move_t));
+		position_s start;
+		if (moves == NULL) { fputs("Memory error", stderr); exit(2); }
+
+		for (unsigned int game = 0; game < state->db.count; game++) {
+			int n = readGameDB(&state->db, game, &start, moves);
+			if (n >= 0) { addPuzzleGame(state, &start, moves, n, game + 1); }
+		}
+		free(moves);
+	}
+	else { pgnReadFile(state->config.source, 1, addPuzzlePGNGame, state, &stats); } /* Opened Once Already By puzzleMain() */
+
+	queueClose(&state->candidates);
+	return 0;
+}
+
+DWORD WINAPI puzzleShallowThread(LPVOID param) { /* Cheap Filter, Most Positions Have Several Good Moves Or None */
+
+	puzzleState_s* state = (puzzleState_s*)param;
+	searchEngine_s* engine = &state->engines[InterlockedIncrement(&state->nextSlot) - 1];
+	puzzleCandidate_s candidate;
+	searchLimits_s limits;
+
+
+	searchInit(engine, NULL, state->config.hashMB, 1);
+	engine->multiPV = 2;
+	limits.nodes = state->config.shallowNodes;
+
+	while (queuePop(&state->candidates, &candidate, INFINITE) == 1) {
+		searchRun(engine, &candidate.pos, NULL, 0, &limits);
+		InterlockedIncrement(&state->shallowDone);
+		if (!isUniqueWin(engine, state->config.margin)) { continue; }
+
+		InterlockedIncrement(&state->shallowPassed);
+		queuePush(&state->verified, &candidate);
+	}
+
+	searchFree(engine);
+	if (InterlockedDecrement(&state->shallowLive) == 0) { queueClose(&state->verified); }
+	return 0;
+}
+
+bool solvePuzzle(puzzleState_s* state, searchEngine_s* engine, const puzzleCandidate_s* candidate, puzzleText_s* out) { /* Deep Search At Every Solver Move, false Unless The First Move Holds Up */
+
+	searchLimits_s limits;
+	position_s pos = candidate->pos;
+	position_s next;
+	move_t line[PUZZLE_MAX_MOVES_MACRO * 2];
+	int lineLength = 0;
+	int score = 0;
+	char fen[MAX_FEN_MACRO];
+	char san[8];
+
+
+	limits.nodes = state->config.deepNodes;
+
+	/* Solver Move, Then The Defence The Search Expects, Until The Best Move Stops Being The Only One */
+	for (int step = 0; step < state->config.maxMoves; step++) {
+		searchRun(engine, &pos, NULL, 0, &limits);
+		const searchLine_s* best = &engine->lines[0];
+		bool bForced = step > 0 && engine->lineCount == 1 && best->score >= PUZZLE_WIN_SCORE; /* An Only Move Mid Line Still Belongs To It */
+		if (!isUniqueWin(engine, state->config.margin) && !bForced) {
+			if (step == 0) { return false; }
+			lineLength--; /* Lines End On A Solver Move */
+			break;
+		}
+		if (step == 0) { score = best->score; }
+
+		line[lineLength++] = best->pv[0];
+		makeMove(&pos, &next, best->pv[0]);
+		pos = next;
+		if (step + 1 == state->config.maxMoves || best->pvLength < 2 || !hasLegalMove(&pos)) { break; } /* Mate, Or Out Of Moves To Show */
+
+		line[lineLength++] = best->pv[1];
+		makeMove(&pos, &next, best->pv[1]);
+		pos = next;
+	}
+
+	/* EPD Wants Only The First Four FEN Fields */
+	positionToFEN(&candidate->pos, fen);
+	char* field = fen;
+	for (int spaces = 0; *field && spaces < 4; field++) { if (*field == ' ') { spaces++; } }
+	if (field > fen && field[-1] == ' ') { field[-1] = '\0'; }
+
+	pos = candidate->pos;
+	moveToSAN(&pos, line[0], san);
+	int len = sprintf(out->text, "%s bm %s; pv \"", fen, san);
+	for (int i = 0; i < lineLength; i++) {
+		moveToSAN(&pos, line[i], san);
+		len += sprintf(out->text + len, "%s%s", i ? " " : "", san);
+		makeMove(&pos, &next, line[i]);
+		pos = next;
+	}
+	if (score >= MATE_BOUND_SCORE) { len += sprintf(out->text + len, "\"; dm %d;", (MATE_SCORE - score + 1) / 2); }
+	else { len += sprintf(out->text + len, "\"; ce %d;", score); }
+	sprintf(out->text + len, " id \"game %u ply %u\";\n", candidate->game, candidate->ply);
+	return true;
+}
+
+DWORD WINAPI puzzleDeepThread(LPVOID param) {
+
+	puzzleState_s* state = (puzzleState_s*)param;
+	searchEngine_s* engine = &state->engines[InterlockedIncrement(&state->nextSlot) - 1];
+	puzzleCandidate_s candidate;
+	puzzleText_s puzzle;
+
+
+	searchInit(engine, NULL, state->config.hashMB, 1);
+	engine->multiPV = 2;
+
+	while (queuePop(&state->verified, &candidate, INFINITE) == 1) {
+		if (solvePuzzle(state, engine, &candidate, &puzzle)) { queuePush(&state->puzzles, &puzzle); }
+		InterlockedIncrement(&state->deepDone);
+	}
+
+	searchFree(engine);
+	if (InterlockedDecrement(&state->deepLive) == 0) { queueClose(&state->puzzles); }
+	return 0;
+}
+
+int puzzleMain(int argc, char** argv) { /* jonochess --puzzles <games.pgn|games.jcdb> <out.epd> [options] */
+
+	static puzzleState_s puzzleState; /* Too Big For The Stack */
+	puzzleState_s* state = &puzzleState;
+	puzzleConfig_s* config = &state->config;
+	HANDLE threads[PUZZLE_MAX_THREADS_MACRO + 1];
+	puzzleText_s puzzle;
+	SYSTEM_INFO sysInfo;
+	FILE* file;
+	unsigned long long written = 0;
+	int result;
+
+
+	for (int i = 2; i < argc; i++) {
+		bool bValue = i + 1 < argc;
+		if (argv[i][0] != '-')                            { if (config->source == NULL) { config->source = argv[i]; } else { config->output = argv[i]; } }
+		else if (bValue && !strcmp(argv[i], "--threads")) { config->threads = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--hash"))    { config->hashMB = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--minply"))  { config->minPly = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--margin"))  { config->margin = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--moves"))   { config->maxMoves = atoi(argv[++i]); }
+		else if (bValue && !strcmp(argv[i], "--shallow")) { config->shallowNodes = strtoull(argv[++i], NULL, 10); }
+		else if (bValue && !strcmp(argv[i], "--deep"))    { config->deepNodes = strtoull(argv[++i], NULL, 10); }
+		else { fprintf(stderr, "Unknown puzzles argument %s\n", argv[i]); return 1; }
+	}
+
+	if (config->source == NULL || config->output == NULL) {
+		fputs("usage: jonochess --puzzles <games.pgn|games.jcdb> <out.epd> [--threads N] [--hash MB] [--minply N] [--margin cp] [--moves N] [--shallow nodes] [--deep nodes]\n", stderr);
+		return 1;
+	}
+	GetSystemInfo(&sysInfo);
+	if (config->threads < 1) { config->threads = (int)sysInfo.dwNumberOfProcessors; }
+	if (config->threads > PUZZLE_MAX_THREADS_MACRO) { config->threads = PUZZLE_MAX_THREADS_MACRO; }
+	if (config->hashMB < 1) { config->hashMB = 16; }
+	if (config->margin < 1) { config->margin = 300; }
+	if (config->maxMoves < 1) { config->maxMoves = 1; }
+	if (config->maxMoves > PUZZLE_MAX_MOVES_MACRO) { config->maxMoves = PUZZLE_MAX_MOVES_MACRO; }
+
+	/* Every Candidate Goes Through The Shallow Stage, A Quarter Of The Threads Keep Up With The Few That Reach The Deep One */
+	state->shallowThreads = config->threads / 4 > 0 ? config->threads / 4 : 1;
+	state->deepThreads = config->threads - state->shallowThreads > 0 ? config->threads - state->shallowThreads : 1;
+
+	initEngine();
+	state->bDB = openGameDB(config->source, &state->db) == 0;
+	if (!state->bDB) { /* Not A Database, Make Sure It Opens As PGN Before Starting Anything */
+		mappedFile_s mf;
+		if (mapFile(config->source, &mf)) { fputs("File error", stderr); return 1; }
+		unmapFile(&mf);
+	}
+	if (fopen_s(&file, config->output, "wb") != 0) { fputs("File error", stderr); if (state->bDB) { closeGameDB(&state->db); } return 1; }
+
+	state->seen = (unsigned long long*)calloc(PUZZLE_SEEN_MACRO, sizeof(unsigned long long));
+	if (state->seen == NULL) { fputs("Memory error", stderr); exit(2); }
+	queueInit(&state->candidates, sizeof(puzzleCandidate_s), PUZZLE_QUEUE_MACRO);
+	queueInit(&state->verified, sizeof(puzzleCandidate_s), PUZZLE_QUEUE_MACRO);
+	queueInit(&state->puzzles, sizeof(puzzleText_s), PUZZLE_QUEUE_MACRO);
+	state->shallowLive = state->shallowThreads;
+	state->deepLive = state->deepThreads;
+
+	fprintf(stdout, "Puzzles: %s, %d shallow and %d deep threads\n", state->bDB ? "game database" : "PGN", state->shallowThreads, state->deepThreads);
+	fflush(stdout);
+
+	DWORD start = timeGetTime();
+	int count = 0;
+	threads[count++] = CreateThread(NULL, 0, puzzleReaderThread, state, 0, NULL);
+	for (int i = 0; i < state->shallowThreads; i++) { threads[count++] = CreateThread(NULL, 0, puzzleShallowThread, state, 0, NULL); }
+	for (int i = 0; i < state->deepThreads; i++) { threads[count++] = CreateThread(NULL, 0, puzzleDeepThread, state, 0, NULL); }
+
+	/* This Thread Is The Writer, Progress Every Two Seconds While Nothing Comes Out */
+	bool bOk = true;
+	DWORD lastReport = start;
+	while ((result = queuePop(&state->puzzles, &puzzle, 2000)) != -1) {
+		if (result == 1) {
+			size_t length = strlen(puzzle.text);
+			if (fwrite(puzzle.text, 1, length, file) != length || fflush(file)) { bOk = false; }
+			written++;
+		}
+		if (timeGetTime() - lastReport >= 2000) {
+			lastReport = timeGetTime();
+			fprintf(stdout, "Games: %llu, positions: %llu, shallow: %ld (%ld passed), deep: %ld, puzzles: %llu, %.0f positions/s\n",
+				state->games, state->positions, state->shallowDone, state->shallowPassed, state->deepDone, written, state->shallowDone * 1000.0 / (lastReport - start + 1));
+			fflush(stdout);
+		}
+	}
+	WaitForMultipleObjects(count, threads, TRUE, INFINITE);
+	for (int i = 0; i < count; i++) { CloseHandle(threads[i]); }
+	DWORD elapsed = timeGetTime() - start;
+
+	if (fclose(file) != 0) { bOk = false; }
+	fprintf(stdout, "\nGames: %llu\nPositions: %llu\nPassed shallow: %ld\nPuzzles: %llu\nTime (ms): %u\n", state->games, state->positions, state->shallowPassed, written, elapsed);
+
+	queueFree(&state->candidates);
+	queueFree(&state->verified);
+	queueFree(&state->puzzles);
+	free(state->seen);
+	if (state->bDB) { closeGameDB(&state->db); }
+	if (!bOk) { fputs("File error", stderr); return 1; }
+	return 0;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Bench                                                                                                           *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define BENCH_DEPTH_MACRO 11
+
+const char* benchPositions[] = { /* Openings, Middlegames, Endgames, Mates And A Stalemate, Never Reorder Or The Signature Changes */
+
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+	"4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+	"rq3rk1/ppp2ppp/1bnpb3/3N2B1/3NP3/7P/PPPQ1PP1/2KR3R w - - 7 14",
+	"r1bq1r1k/1pp1n1pp/1p1p4/4p2Q/4Pp2/1BNP4/PPP2PPP/3R1RK1 w - - 2 14",
+	"r3r1k1/2p2ppp/p1p1bn2/8/1q2P3/2NPQN2/PPP3PP/R4RK1 b - - 2 15",
+	"r1bbk1nr/pp3p1p/2n5/1N4p1/2Np1B2/8/PPP2PPP/2KR1B1R w kq - 0 13",
+	"r1bq1rk1/ppp1nppp/4n3/3p3Q/3P4/1BP1B3/PP1N2PP/R4RK1 w - - 1 16",
+	"4r1k1/r1q2ppp/ppp2n2/4P3/5Rb1/1N1BQ3/PPP3PP/R5K1 w - - 1 17",
+	"2rqkb1r/ppp2p2/2npb1p1/1N1Nn2p/2P1PP2/8/PP2B1PP/R1BQK2R b KQ - 0 11",
+	"r1bq1r1k/b1p1npp1/p2p3p/1p6/3PP3/1B2NN2/PP3PPP/R2Q1RK1 w - - 1 16",
+	"3r1rk1/p5pp/bpp1pp2/8/q1PP1P2/b3P3/P2NQRPP/1R2B1K1 b - - 6 22",
+	"r1q2rk1/2p1bppp/2Pp4/p6b/Q1PNp3/4B3/PP1R1PPP/2K4R w - - 2 18",
+	"4k2r/1pb2ppp/1p2p3/1R1p4/3P4/2r1PN2/P4PPP/1R4K1 b - - 3 22",
+	"3q2k1/pb3p1p/4pbp1/2r5/PpN2N2/1P2P2P/5PP1/Q2R2K1 b - - 4 26",
+	"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+	"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+	"r3k2r/3nnpbp/q2pp1p1/p7/Pp1PPPP1/4BNN1/1P5P/R2Q1RK1 w kq - 0 16",
+	"3Qb1k1/1r2ppb1/pN1n2q1/Pp1Pp1Pr/4P2p/4BP2/4B1R1/1R5K b - - 11 40",
+	"4rrk1/1p1nq3/p7/2p1P1pp/3P2bp/3Q1Bn1/PPPB4/1K2R1NR w - - 40 21",
+	"5rk1/q6p/2p3bR/1pPp1rP1/1P1Pp3/P3B1Q1/1K3P2/R7 w - - 93 90",
+	"6k1/3b3r/1p1p4/p1n2p2/1PPNpP1q/P3Q1p1/1R1RB1P1/5K2 b - - 0 1",
+	"r2r1n2/pp2bk2/2p1p2p/3q4/3PN1QP/2P3R1/P4PP1/5RK1 w - - 0 1",
+	"1r3k2/4q3/2Pp3b/3Bp3/2Q2p2/1p1P2P1/1P2KP2/3N4 w - - 0 1",
+	"6k1/4pp1p/3p2p1/P1pPb3/R7/1r2P1PP/3B1P2/6K1 w - - 0 1",
+	"6k1/6p1/P6p/r1N5/5p2/7P/1b3PP1/4R1K1 w - - 0 1",
+	"6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/3N4 b - - 0 1",
+	"3b4/5kp1/1p1p1p1p/pP1PpP1P/P1P1P3/3KN3/8/8 w - - 0 1",
+	"2K5/p7/7P/5pR1/8/5k2/r7/8 w - - 0 1",
+	"8/6pk/1p6/8/PP3p1p/5P2/4KP1q/3Q4 w - - 0 1",
+	"7k/3p2pp/4q3/8/4Q3/5Kp1/P6b/8 w - - 0 1",
+	"8/2p5/8/2kPKp1p/2p4P/2P5/3P4/8 w - - 0 1",
+	"8/1p3pp1/7p/5P1P/2k3P1/8/2K2P2/8 w - - 0 1",
+	"8/pp2r1k1/2p1p3/3pP2p/1P1P1P1P/P5KR/8/8 w - - 0 1",
+	"8/3p4/p1bk3p/Pp6/1Kp1PpPp/2P2P1P/2P5/5B2 b - - 0 1",
+	"5k2/7R/4P2p/5K2/p1r2P1p/8/8/8 b - - 0 1",
+	"8/3p3B/5p2/5P2/p7/PP5b/k7/6K1 w - - 0 1",
+	"8/8/8/8/5kp1/P7/8/1K1N4 w - - 0 1",
+	"8/8/8/5N2/8/p7/8/2NK3k w - - 0 1",
+	"8/3k4/8/8/8/4B3/4KB2/2B5 w - - 0 1",
+	"8/8/1P6/5pr1/8/4R3/7k/2K5 w - - 0 1",
+	"8/2p4P/8/kr6/6R1/8/8/1K6 w - - 0 1",
+	"8/8/3P3k/8/1p6/8/1P6/1K3n2 b - - 0 1",
+	"8/R7/2q5/8/6k1/8/1P5p/K6R w - - 0 124",
+	"8/8/8/8/8/6k1/6p1/6K1 w - - 0 1",
+	"7k/7P/6K1/8/3B4/8/8/8 b - - 0 1",
+	"r1bqkbnr/pppp1ppp/2n5/4p3/2B1P3/5Q2/PPPP1PPP/RNB1K1NR w KQkq - 2 3",
+	"7k/5Q2/6K1/8/8/8/8/8 b - - 0 1"
+};
+
+
+int benchMain(int argc, char** argv) { /* jonochess bench [depth] [threads] [hash], Node Total Is The Build's Signature With One Thread */
+
+	static searchEngine_s engine; /* Too Big For The Stack */
+	searchLimits_s limits;
+	position_s pos;
+	const int count = sizeof(benchPositions) / sizeof(benchPositions[0]);
+	int threads = argc > 3 ? atoi(argv[3]) : 1;
+	int hashMB = argc > 4 ? atoi(argv[4]) : 16;
+	unsigned long long totalNodes = 0;
+
+
+	limits.depth = argc > 2 ? atoi(argv[2]) : BENCH_DEPTH_MACRO;
+	if (limits.depth < 1) { limits.depth = BENCH_DEPTH_MACRO; }
+	if (hashMB < 1) { hashMB = 16; }
+
+	initEngine();
+	searchInit(&engine, NULL, hashMB, threads);
+
+	DWORD start = timeGetTime();
+	for (int i = 0; i < count; i++) {
+		if (parseFEN(&pos, benchPositions[i]) == 1) { fprintf(stderr, "Bad bench position %d\n", i + 1); exit(1); }
+
+		searchClearHistory(&engine); /* Every Position Starts Cold So The Count Does Not Depend On The Ones Before */
+		searchRun(&engine, &pos, NULL, 0, &limits);
+
+		unsigned long long nodes = searchTotalNodes(&engine);
+		totalNodes += nodes;
+		fprintf(stdout, "Position %2d/%d: %llu nodes\n", i + 1, count, nodes);
+	}
+	DWORD elapsed = timeGetTime() - start;
+
+	fprintf(stdout, "\nDepth:           %d\nThreads:         %d\nHash:            %d MB\nTotal time (ms): %u\nNodes searched:  %llu\nNodes/second:    %llu\n",
+		limits.depth, engine.numThreads, hashMB, elapsed, totalNodes, totalNodes * 1000 / (elapsed ? elapsed : 1));
+	fflush(stdout);
+
+	searchFree(&engine);
+	return 0;
+}
+
+int sanBenchMain(void) { /* jonochess sanbench, Round Trips Every Legal Move Of The Bench Positions Through moveToSAN() And parseSAN() */
+
+	static position_s positions[sizeof(benchPositions) / sizeof(benchPositions[0])];
+	static move_t moves[sizeof(benchPositions) / sizeof(benchPositions[0])][MAX_MOVES_MACRO];
+	static char sans[sizeof(benchPositions) / sizeof(benchPositions[0])][MAX_MOVES_MACRO][8];
+	static int counts[sizeof(benchPositions) / sizeof(benchPositions[0])];
+	const int count = sizeof(benchPositions) / sizeof(benchPositions[0]);
+	char san[8];
+	int total = 0;
+	int mismatches = 0;
+	unsigned long long encoded = 0;
+	unsigned long long decoded = 0;
+	DWORD encodeTime;
+	DWORD decodeTime;
+	DWORD start;
+
+
+	initEngine();
+
+	for (int i = 0; i < count; i++) {
+		if (parseFEN(&positions[i], benchPositions[i]) == 1) { fprintf(stderr, "Bad bench position %d\n", i + 1); exit(1); }
+		counts[i] = generateLegalMoves(&positions[i], moves[i]);
+		total += counts[i];
+
+		for (int j = 0; j < counts[i]; j++) {
+			moveToSAN(&positions[i], moves[i][j], sans[i][j]);
+			if (parseSAN(&positions[i], sans[i][j], strlen(sans[i][j])) != moves[i][j]) {
+				moveToUCI(moves[i][j], san);
+				fprintf(stdout, "Mismatch in position %d: %s written as %s\n", i + 1, san, sans[i][j]);
+				mismatches++;
+			}
+		}
+	}
+
+	/* About A Second Each, Whole Passes Only So Every Move Is Weighted The Same */
+	start = timeGetTime();
+	do {
+		for (int i = 0; i < count; i++) {
+			for (int j = 0; j < counts[i]; j++) { moveToSAN(&positions[i], moves[i][j], san); }
+		}
+		encoded += total;
+	} while ((encodeTime = timeGetTime() - start) < 1000);
+
+	start = timeGetTime();
+	do {
+		for (int i = 0; i < count; i++) {
+			for (int j = 0; j < counts[i]; j++) { mismatches += parseSAN(&positions[i], sans[i][j], strlen(sans[i][j])) != moves[i][j]; }
+		}
+		decoded += total;
+	} while ((decodeTime = timeGetTime() - start) < 1000);
+
+	fprintf(stdout, "Positions:           %d\nMoves:               %d\nMismatches:          %d\nEncode moves/second: %llu\nDecode moves/second: %llu\n",
+		count, total, mismatches, encoded * 1000 / encodeTime, decoded * 1000 / decodeTime);
+	fflush(stdout);
+	return mismatches ? 1 : 0;
+}
+
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            GUI Analysis                                                                                                    *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define ANALYSIS_LINES_MACRO 3
+#define ANALYSIS_TEXT_MACRO 256
+
+struct guiAnalysis_s { /* Global For The Same Reason As movingPiece, key_callback Toggles It */
+
+	searchEngine_s engine;
+	position_s pos;
+	HANDLE thread = NULL;
+	bool bEnabled = false;
+	bool bUpdated = false;
+	CRITICAL_SECTION lock;
+	char lineText[ANALYSIS_LINES_MACRO][ANALYSIS_TEXT_MACRO];
+	char bookText[ANALYSIS_TEXT_MACRO];  /* Opening Statistics For The Board, Empty Out Of Book */
+	unsigned long long bookKey = 0;
+}analysis;
+
+openingBook_s guiBook; /* --usebook, Stays Mapped While The Window Is Open */
+
+
+void positionFromGUI(position_s* pos) { /* Snapshot Of currentState And Friends, Only Valid While No Piece Is Being Dragged */
+
+	memset(pos, 0, sizeof(position_s));
+	pos->epSquare = -1;
+	pos->fullmoveNumber = 1;
+
+	for (int v = 0; v < 8; v++) {
+		for (int u = 0; u < 8; u++) {
+			if (currentState[v][u].piece != NONE) { putPiece(pos, currentState[v][u].piece, v * 8 + u); }
+		}
+	}
+
+	pos->sideToMove = bCurrentTurn ? 1 : 0;
+	if (bCurrentTurn) { pos->key ^= zobristSide; }
+
+	/* The GUI Only Clears Rights When King Or Rook Moves, So Also Check The Pieces Are Still At Home */
+	if (whiteKing.canCastle && pos->board[60] == WHITE_KING) {
+		if (whiteKing.canCastleShort && pos->board[63] == WHITE_ROOK) { pos->castling |= CASTLE_WHITE_SHORT; }
+		if (whiteKing.canCastleLong && pos->board[56] == WHITE_ROOK)  { pos->castling |= CASTLE_WHITE_LONG; }
+	}
+	if (blackKing.canCastle && pos->board[4] == BLACK_KING) {
+		if (blackKing.canCastleShort && pos->board[7] == BLACK_ROOK) { pos->castling |= CASTLE_BLACK_SHORT; }
+		if (blackKing.canCastleLong && pos->board[0] == BLACK_ROOK)  { pos->castling |= CASTLE_BLACK_LONG; }
+	}
+	pos->key ^= zobristCastle[pos->castling];
+
+	if (iCanEnPassant > 0) { setEnPassantSquare(pos, (bCurrentTurn ? 5 : 2) * 8 + iEnPassantLetter - 1); }
+
+	pos->halfmoveClock = (unsigned char)(iHalfmoveClock < 255 ? iHalfmoveClock : 255);
+	pos->fullmoveNumber = (unsigned short)iFullmoveNumber;
+}
+
+void positionToGUI(const position_s* pos) { /* The Other Way Round, For --fen */
+
+	int white = kingSquare(pos, 0);
+	int black = kingSquare(pos, 1);
+
+
+	for (int v = 0; v < 8; v++) {
+		for (int u = 0; u < 8; u++) { currentState[v][u].piece = pos->board[v * 8 + u]; }
+	}
+	bCurrentTurn = pos->sideToMove != 0;
+
+	/* King Index Is 0xVU Counting From 1, Like currentCoord */
+	whiteKing = {};
+	blackKing = {};
+	whiteKing.currentIndex = (char)((((white >> 3) + 1) << 4) | ((white & 7) + 1));
+	blackKing.currentIndex = (char)((((black >> 3) + 1) << 4) | ((black & 7) + 1));
+	whiteKing.canCastleShort = (pos->castling & CASTLE_WHITE_SHORT) != 0;
+	whiteKing.canCastleLong = (pos->castling & CASTLE_WHITE_LONG) != 0;
+	whiteKing.canCastle = whiteKing.canCastleShort || whiteKing.canCastleLong;
+	blackKing.canCastleShort = (pos->castling & CASTLE_BLACK_SHORT) != 0;
+	blackKing.canCastleLong = (pos->castling & CASTLE_BLACK_LONG) != 0;
+	blackKing.canCastle = blackKing.canCastleShort || blackKing.canCastleLong;
+
+	/* 1 Means The Double Push Was The Last Move, See endPlayerMove() */
+	iCanEnPassant = pos->epSquare >= 0 ? 1 : 0;
+	iEnPassantLetter = pos->epSquare >= 0 ? (pos->epSquare & 7) + 1 : 0;
+
+	iHalfmoveClock = pos->halfmoveClock;
+	iFullmoveNumber = pos->fullmoveNumber;
+}
+
+void printGUIFEN(void) {
+
+	position_s pos;
+	char fen[MAX_FEN_MACRO];
+
+
+	if (movingPiece.exists || bValidPromotion) { return; }
+	positionFromGUI(&pos);
+	positionToFEN(&pos, fen);
+	fprintf(stdout, "FEN: %s\n", fen);
+}
+
+void analysisInfoCallback(const searchInfo_s* info, void* user) { /* Runs On The Analysis Thread */
+
+	char score[32];
+	char move[6];
+	char text[ANALYSIS_TEXT_MACRO];
+	int len;
+
+
+	if (info->multipv > ANALYSIS_LINES_MACRO) { return; }
+
+	/* Scores In Pawns From White's Side, Like Every Other Chess GUI */
+	int white = analysis.pos.sideToMove ? -info->score : info->score;
+	if (info->score >= MATE_BOUND_SCORE || info->score <= -MATE_BOUND_SCORE) { uciFormatScore(white, score); }
+	else { sprintf(score, "%+.2f", white / 100.0); }
+
+	len = sprintf(text, "%s", score);
+	for (int i = 0; i < info->pvLength && i < 8; i++) {
+		moveToUCI(info->pv[i], move);
+		len += sprintf(text + len, " %s", move);
+	}
+
+	fprintf(stdout, "Analysis: depth %d multipv %d %s (%llu nodes, %llu nps)\n", info->depth, info->multipv, text, info->nodes, info->nps);
+
+	EnterCriticalSection(&analysis.lock);
+	sprintf(analysis.lineText[info->multipv - 1], "d%d %s", info->depth, text);
+	analysis.bUpdated = true;
+	LeaveCriticalSection(&analysis.lock);
+
+	glfwPostEmptyEvent(); /* Wake The Main Loop Out Of glfwWaitEvents() */
+}
+
+DWORD WINAPI analysisThread(LPVOID param) {
+
+	searchLimits_s limits;
+
+
+	limits.infinite = true;
+	searchRun(&analysis.engine, &analysis.pos, NULL, 0, &limits);
+	return 0;
+}
+
+void stopAnalysis(void) {
+
+	if (analysis.thread == NULL) { return; }
+	searchStop(&analysis.engine);
+	WaitForSingleObject(analysis.thread, INFINITE);
+	CloseHandle(analysis.thread);
+	analysis.thread = NULL;
+}
+
+void startAnalysis(void) {
+
+	stopAnalysis();
+	positionFromGUI(&analysis.pos);
+
+	EnterCriticalSection(&analysis.lock);
+	memset(analysis.lineText, 0, sizeof(analysis.lineText));
+	analysis.bUpdated = true;
+	LeaveCriticalSection(&analysis.lock);
+
+	analysis.thread = CreateThread(NULL, 0, analysisThread, NULL, 0, NULL);
+}
+
+void analysisIterationCallback(const searchDepthStats_s* stats, void* user) {
+
+	char line[1024];
+
+
+	formatSearchStats(line, stats);
+	fprintf(stdout, "Stats: %s\n", line);
+}
+
+void InitAnalysis(void) {
+
+	SYSTEM_INFO sysInfo;
+
+
+	GetSystemInfo(&sysInfo);
+	InitializeCriticalSection(&analysis.lock);
+
+	/* Leave One Core For Rendering */
+	searchInit(&analysis.engine, NULL, 64, sysInfo.dwNumberOfProcessors > 1 ? sysInfo.dwNumberOfProcessors - 1 : 1);
+	analysis.engine.multiPV = ANALYSIS_LINES_MACRO;
+	analysis.engine.onInfo = analysisInfoCallback;
+	analysis.engine.onIteration = analysisIterationCallback;
+}
+
+void freeAnalysis(void) {
+
+	stopAnalysis();
+	searchFree(&analysis.engine);
+	DeleteCriticalSection(&analysis.lock);
+}
+
+void toggleAnalysis(void) {
+
+	analysis.bEnabled = !analysis.bEnabled;
+	if (!analysis.bEnabled) {
+		stopAnalysis();
+		EnterCriticalSection(&analysis.lock);
+		analysis.bUpdated = true;
+		LeaveCriticalSection(&analysis.lock);
+	}
+	/* Started From updateAnalysis(), Which Knows When The Board Is Stable */
+}
+
+void updateBookText(const position_s* pos) { /* One Binary Search In The Mapped Book, Cheap Enough For Every Board Change */
+
+	char text[ANALYSIS_TEXT_MACRO];
+
+
+	formatBookMoves(&guiBook, pos, text, 3);
+	if (text[0]) { fprintf(stdout, "Book: %s\n", text); }
+	else if (analysis.bookText[0]) { fputs("Book: out of book\n", stdout); }
+
+	EnterCriticalSection(&analysis.lock);
+	strcpy(analysis.bookText, text);
+	analysis.bookKey = pos->key;
+	analysis.bUpdated = true;
+	LeaveCriticalSection(&analysis.lock);
+}
+
+void updateAnalysis(GLFWwindow* window) { /* Main Thread, Once Per Frame */
+
+	char title[(ANALYSIS_LINES_MACRO + 1) * ANALYSIS_TEXT_MACRO + 64];
+	position_s pos;
+
+
+	if ((analysis.bEnabled || guiBook.header) && !movingPiece.exists && !bValidPromotion) {
+		positionFromGUI(&pos);
+		if (analysis.bEnabled && (analysis.thread == NULL || pos.key != analysis.pos.key)) { startAnalysis(); }
+		if (guiBook.header && pos.key != analysis.bookKey) { updateBookText(&pos); }
+	}
+
+	EnterCriticalSection(&analysis.lock);
+	if (analysis.bUpdated) {
+		int len = sprintf(title, "jonochess");
+		if (analysis.bookText[0]) { len += sprintf(title + len, " | Book: %s", analysis.bookText); }
+		for (int i = 0; analysis.bEnabled && i < ANALYSIS_LINES_MACRO; i++) {
+			if (analysis.lineText[i][0]) { len += sprintf(title + len, " | %s", analysis.lineText[i]); }
+		}
+		analysis.bUpdated = false;
+		LeaveCriticalSection(&analysis.lock);
+		glfwSetWindowTitle(window, title);
+	}
+	else {
+		LeaveCriticalSection(&analysis.lock);
+	}
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Game Record                                                                                                     *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+struct gameRecord_s { /* Engine Side Copy Of The GUI Game, Kept In Step By endPlayerMove() */
+
+	position_s start;
+	position_s pos;
+	move_t moves[MAX_GAME_PLY_MACRO];
+	unsigned long long keys[MAX_GAME_PLY_MACRO]; /* Positions Before Each Move, For gameOutcome() */
+	int moveCount = 0;
+	int round = 0;
+	char pendingFrom = 0x00;     /* Promotion Waiting For Its Piece, See key_callback() */
+	char pendingTo = 0x00;
+	const char* path = "jonochess.pgn";
+	pgnWriter_s writer;
+	bool bWriterOpen = false;
+}gameRecord;
+
+
+void startGUIGame(void) {
+
+	positionFromGUI(&gameRecord.start);
+	gameRecord.pos = gameRecord.start;
+	gameRecord.moveCount = 0;
+}
+
+void saveGUIGame(const char* result) { /* Hands The Game To The Writer Thread, The Input Callback Never Touches The Disk */
+
+	pgnRecord_s record;
+
+
+	if (gameRecord.moveCount == 0) { return; }
+
+	/* Opened On The First Finished Game So Sessions Without Moves Leave No File Behind */
+	if (!gameRecord.bWriterOpen) {
+		if (pgnWriterOpen(&gameRecord.writer, gameRecord.path) == 1) { fprintf(stderr, "File error, game not saved to %s\n", gameRecord.path); return; }
+		gameRecord.bWriterOpen = true;
+	}
+
+	record.event = "jonochess";
+	record.white = "?";
+	record.black = "?";
+	record.round = ++gameRecord.round;
+	record.result = result;
+	record.start = &gameRecord.start;
+	record.moves = gameRecord.moves;
+	record.moveCount = gameRecord.moveCount;
+	pgnWriterSubmitGame(&gameRecord.writer, &record);
+
+	fprintf(stdout, "Status: Game %d (%d plies, %s) saved to %s\n", gameRecord.round, gameRecord.moveCount, result, gameRecord.path);
+}
+
+void recordGUIMove(char indexFrom, char indexTo) { /* Called Once The Board Shows The Finished Move */
+
+	move_t list[MAX_MOVES_MACRO];
+	position_s next;
+	move_t m = 0;
+	const char* reason = "";
+
+
+	if (bValidPromotion) { gameRecord.pendingFrom = indexFrom; gameRecord.pendingTo = indexTo; return; }
+
+	int from = (((indexFrom & 0xf0) >> 4) - 1) * 8 + (indexFrom & 0x0f) - 1;
+	int to = (((indexTo & 0xf0) >> 4) - 1) * 8 + (indexTo & 0x0f) - 1;
+	int n = generateLegalMoves(&gameRecord.pos, list);
+	for (int i = 0; i < n && m == 0; i++) {
+		if (moveFrom(list[i]) != from || moveTo(list[i]) != to) { continue; }
+		if (isPromotionMove(list[i]) && promotionType(list[i]) != pieceType(currentState[to >> 3][to & 7].piece)) { continue; }
+		m = list[i];
+	}
+
+	/* The GUI Rules Allowed Something The Engine Does Not, Keep What We Have And Carry On From The Board */
+	if (m == 0) {
+		fputs("Status: Game record lost track of the board, starting a new game\n", stdout);
+		saveGUIGame("*");
+		startGUIGame();
+		return;
+	}
+
+	makeMove(&gameRecord.pos, &next, m);
+	gameRecord.keys[gameRecord.moveCount] = gameRecord.pos.key;
+	gameRecord.moves[gameRecord.moveCount++] = m;
+	gameRecord.pos = next;
+
+	int outcome = gameOutcome(&gameRecord.pos, gameRecord.keys, gameRecord.moveCount, &reason);
+	if (outcome == GAME_ONGOING && gameRecord.moveCount < MAX_GAME_PLY_MACRO - 1) { return; }
+
+	if (outcome == GAME_ONGOING) { reason = "move limit"; }
+	fprintf(stdout, "Status: Game over by %s\n", reason);
+	saveGUIGame(outcomeToResult(outcome));
+	startGUIGame(); /* Anything Played After A Draw Goes Into A New Game */
+}
+
+void freeGameRecord(void) {
+
+	saveGUIGame("*"); /* Unfinished Game */
+	if (gameRecord.bWriterOpen && pgnWriterClose(&gameRecord.writer) == 1) { fprintf(stderr, "File error, %s may be incomplete\n", gameRecord.path); }
+}
+
+
+ /* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+  *                                                                                                                            *
+  *            GLFW Callbacks                                                                                                  *
+  *	                                                                                                                          *
+  * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+
+	
+	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
+		glfwSetWindowShouldClose(window, true);
+	}
+	if (key == GLFW_KEY_F && action == GLFW_PRESS) {
+		bScreenIsFlipped = !bScreenIsFlipped;
+	}
+	if (key == GLFW_KEY_A && action == GLFW_PRESS) {
+		toggleAnalysis();
+	}
+	if (key == GLFW_KEY_E && action == GLFW_PRESS) {
+		printGUIFEN();
+	}
+
+	if (bValidPromotion) {
+		if (key == GLFW_KEY_Q && action == GLFW_PRESS)
+			promoteToQueen();
+		if (key == GLFW_KEY_R && action == GLFW_PRESS)
+			promoteToRook();
+		if (key == GLFW_KEY_N && action == GLFW_PRESS)
+			promoteToKnight();
+		if (key == GLFW_KEY_B && action == GLFW_PRESS)
+			promoteToBishop();
+		if (!bValidPromotion)
+			recordGUIMove(gameRecord.pendingFrom, gameRecord.pendingTo);
+	}
+}
+
+void mouse_button_disabled(GLFWwindow* window, int button, int action, int mods) { /* does what it says */
+	
+}
+
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+
+	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
+		startPlayerMove();
+	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
+		endPlayerMove();
+}
+
+void windowResize(GLFWwindow* window, int width, int height) {
+
+	if (width > height) {
+
+		long shift = (long)(width - height);
+
+
+		mousePosition.offsetY = 0.0f;
+		mousePosition.offsetX = (double)(shift >> 1);
+
+		glViewport((GLint)(shift >> 1), 0, height, height);
+
+		windowResolution.x = (long)height;
+		windowResolution.y = (long)height;
+	}
+	else if (width < height) {
+
+		long shift = (long)(height - width);
+
+
+		mousePosition.offsetX = 0.0f;
+		mousePosition.offsetY = (double)(shift >> 1);
+
+		glViewport(0, (GLint)(shift >> 1), width, width);
+
+		windowResolution.x = (long)width;
+		windowResolution.y = (long)width;
+	}
+	else {
+
+		mousePosition.offsetX = 0.0f;
+		mousePosition.offsetY = 0.0f;
+		
+		glViewport(0, 0, width, height);
+
+		windowResolution.x = (long)width;
+		windowResolution.y = (long)height;
+	}
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Asset Loader                                                                                                    *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+#define ASSET_MAX_JOBS_MACRO 16
+#define ASSET_MAX_THREADS_MACRO 8
+
+enum assetKind_e { ASSET_SHADER, ASSET_TEXTURE, ASSET_MESH };
+
+struct assetJob_s {
+
+	assetKind_e kind;
+	const char* path;
+	const char* fragmentPath;             /* Shaders Only */
+	void* target;                         /* The shaderBuffer_s, textureBuffer_s Or objectBuffer_s Main Draws With */
+	cookedAsset_s asset;                  /* Textures And Meshes */
+	DWORD readyMs;                        /* Since startAssetLoader() */
+};
+
+struct assetLoader_s { /* Workers Read, Parse And Decode From Process Start, The Main Thread Uploads Each Result Once It Has A Context */
+
+	assetJob_s jobs[ASSET_MAX_JOBS_MACRO];
+	int count;
+	volatile LONG next;
+	boundedQueue_s ready;                 /* Indices Into jobs In The Order They Finish, Holds All Of Them So Workers Never Wait */
+	HANDLE threads[ASSET_MAX_THREADS_MACRO];
+	int threadCount;
+	DWORD startTime;
+};
+
+
+void addAssetJob(assetLoader_s* loader, assetKind_e kind, const char* path, const char* fragmentPath, void* target) {
+
+	if (loader->count == ASSET_MAX_JOBS_MACRO) { fputs("Memory error", stderr); exit(2); }
+
+	assetJob_s* job = &loader->jobs[loader->count++];
+	job->kind = kind;
+	job->path = path;
+	job->fragmentPath = fragmentPath;
+	job->target = target;
+}
+
+DWORD WINAPI assetThread(LPVOID param) { /* No GL Calls In Here, The Context Belongs To The Main Thread */
+
+	assetLoader_s* loader = (assetLoader_s*)param;
+
+
+	while (true) {
+		int index = InterlockedIncrement(&loader->next) - 1;
+		if (index >= loader->count) { break; }
+
+		assetJob_s* job = &loader->jobs[index];
+		switch (job->kind) {
+		case ASSET_SHADER:  readShaderFile(job->path, job->fragmentPath, (shaderBuffer_s*)job->target); break;
+		case ASSET_TEXTURE: readTexture(job->path, &job->asset); break;
+		case ASSET_MESH:    readMesh(job->path, &job->asset); break;
+		}
+		job->readyMs = timeGetTime() - loader->startTime;
+		queuePush(&loader->ready, &index);
+	}
+	return 0;
+}
+
+void startAssetLoader(assetLoader_s* loader) { /* Once Every Job Is Added, Before The Window Exists */
+
+	SYSTEM_INFO sysInfo;
+
+
+	GetSystemInfo(&sysInfo);
+	loader->threadCount = (int)sysInfo.dwNumberOfProcessors;
+	if (loader->threadCount > ASSET_MAX_THREADS_MACRO) { loader->threadCount = ASSET_MAX_THREADS_MACRO; }
+	if (loader->threadCount > loader->count) { loader->threadCount = loader->count; }
+	if (loader->threadCount < 1) { loader->threadCount = 1; }
+
+	queueInit(&loader->ready, sizeof(int), ASSET_MAX_JOBS_MACRO);
+	loader->next = 0;
+	loader->startTime = timeGetTime();
+	for (int i = 0; i < loader->threadCount; i++) { loader->threads[i] = CreateThread(NULL, 0, assetThread, loader, 0, NULL); }
+}
+
+void finishAssetLoader(assetLoader_s* loader) { /* Needs The Context Current, Uploads In Arrival Order And Returns Once Everything Is On The GPU */
+
+	DWORD slowest = 0;
+	int index;
+
+
+	for (int i = 0; i < loader->count; i++) {
+		queuePop(&loader->ready, &index, INFINITE);
+
+		assetJob_s* job = &loader->jobs[index];
+		switch (job->kind) {
+		case ASSET_SHADER:  buildShader(job->path, (shaderBuffer_s*)job->target); break;
+		case ASSET_TEXTURE: createTexture((textureBuffer_s*)job->target, &job->asset); break;
+		case ASSET_MESH:    uploadMesh((objectBuffer_s*)job->target, (const meshHeader_s*)job->asset.header, job->asset.payload); break;
+		}
+		releaseCookedAsset(&job->asset);
+		if (job->readyMs > slowest) { slowest = job->readyMs; }
+	}
+
+	WaitForMultipleObjects(loader->threadCount, loader->threads, TRUE, INFINITE);
+	for (int i = 0; i < loader->threadCount; i++) { CloseHandle(loader->threads[i]); }
+	queueFree(&loader->ready);
+
+	fprintf(stdout, "Status: %d assets read on %d threads, the slowest ready after %u ms\n", loader->count, loader->threadCount, slowest);
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Timing                                                                                                          *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+int Sys_Milliseconds(windowsTimer_s* t) {
+
+	int sys_curtime;
+	static bool initialized = false;
+
+
+	if (!initialized) {
+
+		t->time = timeGetTime(); // winmm.lib
+		initialized = true;
+	}
+	sys_curtime = timeGetTime() - t->time;
+
+
+	return sys_curtime;
+}
+
+void timerStart(windowsTimer_s* t) {
+
+	t->start = Sys_Milliseconds(t);
+}
+
+void timerEnd(windowsTimer_s* t) {
+
+	t->end = Sys_Milliseconds(t);
+	t->ms += t->end - t->start;
+}
+
+
+/* @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ *
+ *                                                                                                                            *
+ *            Main                                                                                                            *
+ *	                                                                                                                          *
+ * @@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@ */
+
+int main(int argc, char* argv[]) {
+
+	windowsTimer_s winTimer = {};
+
+
+	/* oooooooooooooooooooooooooooooooooooooooooooooooooooo Headless -- Modes ooooooooooooooooooooooooooooooooooooooooooooooooooo */
+
+	if (argc > 1 && !strcmp(argv[1], "--uci")) { return uciMain(argc > 3 && !strcmp(argv[2], "--stats-json") ? argv[3] : NULL); }
+	if (argc > 1 && !strcmp(argv[1], "--match")) { return matchMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "bench")) { return benchMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "sanbench")) { return sanBenchMain(); }
+	if (argc > 1 && !strcmp(argv[1], "--pgn")) { return pgnMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--pgn2db")) { return pgnToGameDBMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--db")) { return gameDBMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--index")) { return positionIndexMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--find")) { return findPositionMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--book")) { return bookMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--annotate")) { return annotateMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--gendata")) { return trainingMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--tune")) { return tuneMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--epd")) { return epdMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--mate")) { return mateMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--puzzles")) { return puzzleMain(argc, argv); }
+	if (argc > 1 && !strcmp(argv[1], "--cook")) { return cookMain(argc, argv); }
+
+
+	timerStart(&winTimer);
+
+
+	/* ooooooooooooooooooooooooooooooooooooooooooooooooooo Assets -- Read ooooooooooooooooooooooooooooooooooooooooooooooooooo */
+
+	shaderBuffer_s chessBoardShader = {};
+	shaderBuffer_s chessPieceDynamicShader = {};
+	shaderBuffer_s chessPieceStaticShader = {};
+
+	textureBuffer_s texture0 = {}; texture0.name = "texture0";
+	textureBuffer_s texture1 = {}; texture1.name = "texture0";
+
+	objectBuffer_s chessBoardObject = {};
+	objectBuffer_s chessPieceDynamicObject = {};
+	objectBuffer_s chessPieceStaticObject = {};
+
+	assetLoader_s assetLoader = {};
+
+
+	/* Files Are Read And Decoded While The Window And Context Are Created Below */
+	addAssetJob(&assetLoader, ASSET_SHADER, "res/shader/board.vs", "res/shader/board.fs", &chessBoardShader);
+	addAssetJob(&assetLoader, ASSET_SHADER, "res/shader/piece.vs", "res/shader/piece.fs", &chessPieceDynamicShader);
+	addAssetJob(&assetLoader, ASSET_SHADER, "res/shader/grid.vs", "res/shader/grid.fs", &chessPieceStaticShader);
+	addAssetJob(&assetLoader, ASSET_TEXTURE, "res/texture/chesspiece.png", NULL, &texture0);
+	addAssetJob(&assetLoader, ASSET_TEXTURE, "res/texture/chesspieceflip.png", NULL, &texture1);
+	addAssetJob(&assetLoader, ASSET_MESH, "res/obj/chessboard.obj", NULL, &chessBoardObject);
+	addAssetJob(&assetLoader, ASSET_MESH, "res/obj/chesspiece.obj", NULL, &chessPieceDynamicObject);
+	addAssetJob(&assetLoader, ASSET_MESH, "res/obj/chessgrid.obj", NULL, &chessPieceStaticObject);
+	startAssetLoader(&assetLoader);
+
+
+    /* oooooooooooooooooooooooooooooooooooooooooooooooooooo GLFW -- Init oooooooooooooooooooooooooooooooooooooooooooooooooooo */
+
+	GLFWwindow* window;
+
+
+    if (!glfwInit()) return 1;
+        
+	window = glfwCreateWindow(windowResolution.x, windowResolution.y, "jonochess", NULL, NULL);
+    if (!window) {glfwTerminate();return 1;}
+
+    glfwMakeContextCurrent(window);
+
+	/* Callbacks */
+	GLFWcursor* cursor = glfwCreateStandardCursor(GLFW_CROSSHAIR_CURSOR);
+	
+
+    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+	glfwSetCursor(window, cursor);
+	
+	glfwSetFramebufferSizeCallback(window, windowResize);
+	glfwSetMouseButtonCallback(window, mouse_button_callback);
+
+	glfwSetKeyCallback(window, key_callback);
+
+
+    /* oooooooooooooooooooooooooooooooooooooooooooooooooooo GLEW -- Init oooooooooooooooooooooooooooooooooooooooooooooooooooo */
+    
+	GLenum err = glewInit();
+
+
+    if (GLEW_OK != err) { fprintf(stderr, "Error: %s\n", glewGetErrorString(err)); glfwTerminate(); return 1;}
+
+    fprintf(stdout, "Status: Using GLEW %s\n", glewGetString(GLEW_VERSION));    
+    
+
+	/* oooooooooooooooooooooooooooooooooooooooooooooooooo Assets -- Upload oooooooooooooooooooooooooooooooooooooooooooooooooo */
+
+	/* Shaders, Textures And Meshes Go Up As Each One Is Ready, Whatever Order That Is */
+	finishAssetLoader(&assetLoader);
+
+
+	/* ooooooooooooooooooooooooooooooooooooooooooooooooooo Shader -- Init ooooooooooooooooooooooooooooooooooooooooooooooooooo */
+
+	/* Used To Bind A Chess Piece To Mouse Cursor */
+	uniformMat4_s transform = {}; transform.name = "transform";
+	transform.location = glGetUniformLocation(chessPieceDynamicShader.program, transform.name);
+
+	GLint TexCoordShiftLoc1 = glGetUniformLocation(chessPieceDynamicShader.program, "TexCoordShift1");
+
+	/* Used To Index The Board Coordinates And Draw Static Pieces To Correct Squares */
+	uniformMat4_s transform1 = {}; transform1.name = "transform1";
+	transform1.location = glGetUniformLocation(chessPieceStaticShader.program, transform1.name);
+
+	GLint TexCoordShiftLoc = glGetUniformLocation(chessPieceStaticShader.program, "TexCoordShift");
+
+	
+	/* oooooooooooooooooooooooooooooooooooooooooooooooooo Texture -- Init ooooooooooooooooooooooooooooooooooooooooooooooooooo */
+
+	/* Set Texture Uniforms */
+	shaderUse(chessPieceStaticShader.program); /* don't forget to activate/use the shader before setting uniforms! */
+	setTextureUniform(&chessPieceStaticShader, &texture0);
+
+	shaderUse(chessPieceDynamicShader.program);
+	setTextureUniform(&chessPieceDynamicShader, &texture0);
+
+
+	/* oooooooooooooooooooooooooooooooooooooooooooooooooo Game Logic -- Init oooooooooooooooooooooooooooooooooooooooooooooooo */
+	
+	blackKing.currentIndex = 0x15; whiteKing.currentIndex = 0x85;
+
+	initEngine();
+	InitAnalysis();
+
+	for (int i = 1; i + 1 < argc; i++) { /* --fen "<fen>" Starts From Any Position Instead */
+		position_s pos;
+		if (strcmp(argv[i], "--fen")) { continue; }
+		if (parseFEN(&pos, argv[i + 1]) == 1) { fputs("Invalid FEN, using the starting position\n", stderr); }
+		else { positionToGUI(&pos); }
+	}
+	for (int i = 1; i + 1 < argc; i++) { /* --pgnout <file> Picks Where Played Games Are Appended, --usebook <file.jcbook> Shows Opening Statistics */
+		if (!strcmp(argv[i], "--pgnout")) { gameRecord.path = argv[i + 1]; }
+		if (!strcmp(argv[i], "--usebook") && openOpeningBook(argv[i + 1], &guiBook) == 1) { fputs("File error, no opening book loaded\n", stderr); }
+	}
+	startGUIGame();
+	
+	/* TODO: Make A Board From Black Or White Perspective */
+
+
+	/* oooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooooo */
+
+	/* Timing */
+	timerEnd(&winTimer);
+    fprintf(stdout, "Status: Init complete in %u ms\n", winTimer.ms);
+
+
+	/* oooooooooooooooooooooooooooooooooooooooooooooooooooooo Main Loop ooooooooooooooooooooooooooooooooooooooooooooooooooooo */
+    while (!glfwWindowShouldClose(window)) {
+		
+		/* Promoting */
+		while (bValidPromotion) {
+			glfwSetMouseButtonCallback(window, mouse_button_disabled);
 			glfwWaitEvents();
 			glfwSetMouseButtonCallback(window, mouse_button_callback);
 		}
@@ -2103,6 +10022,9 @@ int main(int argc, char* argv[]) {
         /* Timing */
 		timerStart(&winTimer);
 
+		/* Engine Analysis, Restarts Itself When The Board Changes */
+		updateAnalysis(window);
+
 		/* Mouse */
 		glfwGetCursorPos(window, &mousePosition.x, &mousePosition.y);
 		mousePosition.x -= mousePosition.offsetX; // TLDR; glfw gives us screen coords but we need viewport coords, see callbacks for more info
@@ -2153,6 +10075,9 @@ int main(int argc, char* argv[]) {
     }
 
 	/* Cleanup */
+	freeAnalysis();
+	freeGameRecord();
+	closeOpeningBook(&guiBook);
 	freeBufferObject(&chessBoardObject);
 	freeBufferObject(&chessPieceStaticObject);
 	freeBufferObject(&chessPieceDynamicObject);